@@ -0,0 +1,43 @@
+#include "pch.h"
+#include "common.h"
+#include "action_table.h"
+
+namespace ALXR {
+
+// Vector2f records write both trackpad axes through valueOffset.
+static_assert(offsetof(ActionTable::ControllerInfo, trackpadPosition.y) == offsetof(ActionTable::ControllerInfo, trackpadPosition.x) + sizeof(float));
+
+void ActionTable::Compile(const InteractionProfile& profile, const SubactionPathList& subactionPaths, const LookupActionFn& lookupAction)
+{
+    Clear();
+    for (std::size_t hand = 0; hand < HandSize; ++hand) {
+        for (const auto kind : ActionKinds) {
+            for (const auto& buttonMap : GetInputMap(profile, kind)[hand]) {
+                if (buttonMap == MapEnd)
+                    break;
+                const XrAction action = lookupAction(kind, buttonMap.button);
+                if (action == XR_NULL_HANDLE)
+                    continue;
+                m_records.push_back(ActionRecord{
+                    .action        = action,
+                    .subactionPath = subactionPaths[hand],
+                    .buttonFlag    = ALVR_BUTTON_FLAG(buttonMap.button),
+                    .valueOffset   = GetValueOffset(kind, buttonMap.button),
+                    .hand          = static_cast<std::uint8_t>(hand),
+                    .kind          = kind
+                });
+            }
+        }
+    }
+    m_records.shrink_to_fit();
+    m_inactivePolls.assign(m_records.size(), 0);
+}
+
+void ActionTable::Clear()
+{
+    m_records.clear();
+    m_inactivePolls.clear();
+    m_pollCount = 0;
+}
+
+}
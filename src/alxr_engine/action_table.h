@@ -0,0 +1,198 @@
+#pragma once
+#ifndef ALXR_ACTION_TABLE_H
+#define ALXR_ACTION_TABLE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <functional>
+
+#include "pch.h"
+#include "interaction_profiles.h"
+#include "ALVR-common/packet_types.h"
+
+namespace ALXR {;
+
+// Which InteractionProfile input map an action comes from, i.e. the state queried & what it is written to.
+enum class ActionKind : std::uint8_t {
+    Bool,         // boolean state, sets a button flag.
+    Scalar,       // float state, written to a float field.
+    Vector2f,     // vector2f state, written to two consecutive float fields.
+    BoolToScalar, // boolean state, sets a float field to 1.
+    ScalarToBool  // boolean state (the runtime thresholds the value), sets a button flag.
+};
+
+constexpr inline const std::array<ActionKind, 5> ActionKinds{
+    ActionKind::Bool, ActionKind::Scalar, ActionKind::Vector2f, ActionKind::BoolToScalar, ActionKind::ScalarToBool
+};
+
+constexpr inline const HandInputMap& GetInputMap(const InteractionProfile& profile, const ActionKind kind) {
+    switch (kind) {
+    case ActionKind::Scalar:       return profile.scalarMap;
+    case ActionKind::Vector2f:     return profile.vector2fMap;
+    case ActionKind::BoolToScalar: return profile.boolToScalarMap;
+    case ActionKind::ScalarToBool: return profile.scalarToBoolMap;
+    case ActionKind::Bool:
+    default: return profile.boolMap;
+    }
+}
+
+// The float field(s) an input is written to, vector2f inputs are the whole trackpad position.
+inline std::uint16_t GetValueOffset(const ActionKind kind, const ALVR_INPUT input) {
+    using ControllerInfo = ::TrackingInfo::Controller;
+    if (kind == ActionKind::Vector2f)
+        return offsetof(ControllerInfo, trackpadPosition.x);
+    switch (input) {
+    case ALVR_INPUT_JOYSTICK_X:
+    case ALVR_INPUT_TRACKPAD_X:
+        return offsetof(ControllerInfo, trackpadPosition.x);
+    case ALVR_INPUT_JOYSTICK_Y:
+    case ALVR_INPUT_TRACKPAD_Y:
+        return offsetof(ControllerInfo, trackpadPosition.y);
+    case ALVR_INPUT_TRIGGER_VALUE:
+        return offsetof(ControllerInfo, triggerValue);
+    case ALVR_INPUT_GRIP_VALUE:
+    default:
+        return offsetof(ControllerInfo, gripValue);
+    }
+}
+
+struct ActionRecord {
+    XrAction      action;
+    XrPath        subactionPath;
+    ButtonFlags   buttonFlag;  // Bool & ScalarToBool.
+    std::uint16_t valueOffset; // byte offset of the float field(s) in ControllerInfo, the other kinds.
+    std::uint8_t  hand;
+    ActionKind    kind;
+};
+
+// The runtime's action state queries, ActionTable::Poll is templated on it so they can be mocked.
+struct XrActionStateDispatch {
+    static inline XrResult GetBoolean(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateBoolean* state) {
+        return xrGetActionStateBoolean(session, getInfo, state);
+    }
+    static inline XrResult GetFloat(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateFloat* state) {
+        return xrGetActionStateFloat(session, getInfo, state);
+    }
+    static inline XrResult GetVector2f(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateVector2f* state) {
+        return xrGetActionStateVector2f(session, getInfo, state);
+    }
+};
+
+// The input actions of one InteractionProfile flattened into records, built once the actions exist so
+// polling is a single pass with no map lookups.
+//
+// An action that stays inactive for DormantAfterPolls polls (no binding for it on the current device, or
+// the controller is off) goes dormant & is only queried once every DormantProbeInterval polls from then.
+// Bindings only change with the interaction profile, ResetDormancy is called on a profile change and when
+// a hand becomes active again.
+class ActionTable {
+public:
+    using ControllerInfo     = ::TrackingInfo::Controller;
+    using ControllerInfoList = std::array<ControllerInfo, HandSize>;
+    using SubactionPathList  = std::array<XrPath, HandSize>;
+    using LookupActionFn     = std::function<XrAction(const ActionKind, const ALVR_INPUT)>;
+
+    void Compile(const InteractionProfile& profile, const SubactionPathList& subactionPaths, const LookupActionFn& lookupAction);
+    void Clear();
+
+    inline std::size_t Size() const { return m_records.size(); }
+
+    inline void ResetDormancy() {
+        std::fill(m_inactivePolls.begin(), m_inactivePolls.end(), 0);
+    }
+    inline void ResetDormancy(const std::size_t hand) {
+        for (std::size_t i = 0; i < m_records.size(); ++i) {
+            if (m_records[i].hand == hand)
+                m_inactivePolls[i] = 0;
+        }
+    }
+
+    // Call after xrSyncActions, returns the number of state queries made.
+    template < typename Dispatch = XrActionStateDispatch >
+    std::size_t Poll(XrSession session, ControllerInfoList& controllerInfoList);
+
+    constexpr static const std::uint32_t DormantAfterPolls    = 512;
+    constexpr static const std::uint32_t DormantProbeInterval = 64;
+
+private:
+    static inline float* GetValuePtr(ControllerInfo& controllerInfo, const std::uint16_t valueOffset) {
+        return reinterpret_cast<float*>(reinterpret_cast<std::uint8_t*>(&controllerInfo) + valueOffset);
+    }
+
+    std::vector<ActionRecord>  m_records;
+    std::vector<std::uint32_t> m_inactivePolls; // by record, polling thread only.
+    std::uint32_t              m_pollCount = 0;
+};
+
+template < typename Dispatch >
+inline std::size_t ActionTable::Poll(XrSession session, ControllerInfoList& controllerInfoList)
+{
+    ++m_pollCount;
+    std::size_t queryCount = 0;
+    XrActionStateGetInfo getInfo{
+        .type = XR_TYPE_ACTION_STATE_GET_INFO,
+        .next = nullptr,
+        .action = XR_NULL_HANDLE,
+        .subactionPath = XR_NULL_PATH
+    };
+    for (std::size_t i = 0; i < m_records.size(); ++i) {
+        const auto& record = m_records[i];
+        auto& inactivePolls = m_inactivePolls[i];
+        // dormant records are probed on different polls, staggered by index.
+        if (inactivePolls >= DormantAfterPolls && (m_pollCount + i) % DormantProbeInterval != 0)
+            continue;
+
+        getInfo.action = record.action;
+        getInfo.subactionPath = record.subactionPath;
+        ++queryCount;
+        auto& controllerInfo = controllerInfoList[record.hand];
+        bool isActive = false;
+        switch (record.kind) {
+        case ActionKind::Bool:
+        case ActionKind::ScalarToBool:
+        case ActionKind::BoolToScalar: {
+            XrActionStateBoolean boolValue{ .type = XR_TYPE_ACTION_STATE_BOOLEAN, .next = nullptr, .isActive = XR_FALSE };
+            if (XR_FAILED(Dispatch::GetBoolean(session, &getInfo, &boolValue)))
+                continue;
+            isActive = boolValue.isActive == XR_TRUE || boolValue.changedSinceLastSync == XR_TRUE;
+            if (boolValue.isActive == XR_FALSE || boolValue.currentState == XR_FALSE)
+                break;
+            if (record.kind == ActionKind::BoolToScalar) {
+                *GetValuePtr(controllerInfo, record.valueOffset) = 1.0f;
+                controllerInfo.enabled = true;
+            } else
+                controllerInfo.buttons |= record.buttonFlag;
+        } break;
+        case ActionKind::Scalar: {
+            XrActionStateFloat floatValue{ .type = XR_TYPE_ACTION_STATE_FLOAT, .next = nullptr, .isActive = XR_FALSE };
+            if (XR_FAILED(Dispatch::GetFloat(session, &getInfo, &floatValue)))
+                continue;
+            isActive = floatValue.isActive == XR_TRUE;
+            if (!isActive)
+                break;
+            *GetValuePtr(controllerInfo, record.valueOffset) = floatValue.currentState;
+            controllerInfo.enabled = true;
+        } break;
+        case ActionKind::Vector2f: {
+            XrActionStateVector2f vec2Value{ .type = XR_TYPE_ACTION_STATE_VECTOR2F, .next = nullptr, .isActive = XR_FALSE };
+            if (XR_FAILED(Dispatch::GetVector2f(session, &getInfo, &vec2Value)))
+                continue;
+            isActive = vec2Value.isActive == XR_TRUE;
+            if (!isActive)
+                break;
+            float* const value = GetValuePtr(controllerInfo, record.valueOffset);
+            value[0] = vec2Value.currentState.x;
+            value[1] = vec2Value.currentState.y;
+            controllerInfo.enabled = true;
+        } break;
+        }
+        inactivePolls = isActive ? 0 : std::min(inactivePolls + 1, DormantAfterPolls);
+    }
+    return queryCount;
+}
+
+}
+#endif
@@ -58,6 +58,16 @@ enum ALXRColorSpace {
     MaxEnum = 0x7fffffff
 };
 
+// Client side extrapolation of tracked poses to the target display time.
+enum ALXRPosePredictionModel
+{
+    // poses are located at the target time, extrapolated by the runtime (the default & prior behaviour).
+    RuntimePosePrediction = 0,
+    // poses are located at the runtime's latest display time & extrapolated by the client.
+    ConstantVelocityPosePrediction,
+    ConstantAccelerationPosePrediction
+};
+
 struct ALXRSystemProperties
 {
     char         systemName[256];
@@ -99,6 +109,8 @@ struct ALXRRustCtx
     void* applicationVM;
     void* applicationActivity;
 #endif
+    // appended to keep the layout of the preceding fields, zero-initialized is RuntimePosePrediction.
+    ALXRPosePredictionModel posePredictionModel;
 };
 
 struct ALXRGuardianData {
@@ -121,12 +133,39 @@ struct ALXRRenderConfig
     bool enableFoveation;
 };
 
+// libavcodec threading for software decoding, frame threading adds (thread count - 1) frames of latency.
+enum ALXRDecoderThreadingPolicy
+{
+    SliceThreading,
+    FrameThreading,
+    // frame threading while the added latency fits in latencyBudgetMs, slice threading otherwise.
+    AutoThreading
+};
+
+// Embedded in ALXRStreamConfig, the Rust binding must declare the same fields in the same order.
 struct ALXRDecoderConfig
 {
     ALXRCodecType codecType;
     bool          enableFEC;
     bool          realtimePriority;
     unsigned int  cpuThreadCount; // only used for software decoding.
+    ALXRDecoderThreadingPolicy threadingPolicy; // only used for software decoding.
+    float         latencyBudgetMs;  // only used by AutoThreading.
+    unsigned long long cpuAffinityMask; // bit N = core N, 0 to not pin the decoder threads.
+    // Decoder backlog (queued packets / wait of the oldest) after which queued frames are dropped until
+    // the next IDR, 0 for the defaults.
+    unsigned int  maxQueuedPackets;
+    float         maxQueueLatencyMs;
+    // Stream bitrate the encoder targets, sizes the decoder's encoded frame buffers. 0 if unknown, the
+    // buffers are then sized by resolution only.
+    unsigned int  bitrateMbps;
+};
+
+// A received packet, as handed to alxr_on_receive_batch.
+struct ALXRPacketView
+{
+    const unsigned char* data;
+    unsigned int         size;
 };
 
 struct ALXRStreamConfig {
@@ -16,6 +16,12 @@
 #include <cstdint>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <atomic>
+#include <chrono>
+#include <array>
+#include <span>
+#include <vector>
 
 #include "alxr_engine.h"
 
@@ -23,7 +29,11 @@
 #include "interaction_manager.h"
 #include "latency_manager.h"
 #include "decoder_thread.h"
+#include "tracking_thread.h"
 #include "foveation.h"
+#include "frame_trace.h"
+#include "packet_capture.h"
+#include "pose_prediction.h"
 
 #if defined(XR_USE_PLATFORM_WIN32) && defined(XR_EXPORT_HIGH_PERF_GPU_SELECTION_SYMBOLS)
 #pragma message("Enabling Symbols to select high-perf GPUs first")
@@ -48,9 +58,16 @@ using RustCtxPtr = std::shared_ptr<const ALXRRustCtx>;
 RustCtxPtr        gRustCtx{ nullptr };
 IOpenXrProgramPtr gProgram{ nullptr };
 XrDecoderThread   gDecoderThread{};
+XrTrackingThread  gTrackingThread{};
 std::mutex        gRenderMutex{};
+std::mutex        gTrackingMutex{}; // one tracking producer at a time, guards gLastEyeInfo.
 ALXREyeInfo       gLastEyeInfo = EyeInfoZero;
 
+ALXR::PacketCaptureWriter gPacketCapture{};
+std::mutex                gStreamConfigMutex{};
+std::optional<ALXRStreamConfig> gStreamConfig{};
+std::atomic<bool>         gIsReplaying{ false };
+
 namespace ALXRStrings {
     constexpr inline const char* const HeadPath         = "/user/head";
     constexpr inline const char* const LeftHandPath     = "/user/hand/left";
@@ -116,6 +133,15 @@ bool alxr_init(const ALXRRustCtx* rCtx, /*[out]*/ ALXRSystemProperties* systemPr
         options->NoFrameSkip = ctx.noFrameSkip;
         options->DisableLocalDimming = ctx.disableLocalDimming;
         options->DisplayColorSpace = static_cast<XrColorSpaceFB>(ctx.displayColorSpace);
+        switch (ctx.posePredictionModel) {
+        case ALXRPosePredictionModel::ConstantVelocityPosePrediction:
+            options->ClientPosePrediction = ALXR::PosePredictionModel::ConstantVelocity;
+            break;
+        case ALXRPosePredictionModel::ConstantAccelerationPosePrediction:
+            options->ClientPosePrediction = ALXR::PosePredictionModel::ConstantAcceleration;
+            break;
+        default: break;
+        }
         if (options->GraphicsPlugin.empty())
             options->GraphicsPlugin = graphics_api_str(ctx.graphicsApi);
 
@@ -182,6 +208,10 @@ void alxr_stop_decoder_thread()
 
 void alxr_destroy() {
     Log::Write(Log::Level::Info, "openxrShutdown: Shuttingdown");
+    gIsReplaying.store(false);
+    gTrackingThread.Stop();
+    gPacketCapture.Close();
+    ALXR::PoseTraceWriter::Instance().Close();
     if (const auto programPtr = gProgram) {
         if (const auto graphicsPtr = programPtr->GetGraphicsPlugin()) {
             std::scoped_lock lk(gRenderMutex);
@@ -199,12 +229,34 @@ void alxr_request_exit_session() {
     }
 }
 
+// Called from the render loop, the decoder thread only flags the request. Serialized against
+// alxr_set_stream_config & alxr_stop_decoder_thread by XrDecoderThread, the restarted decoder
+// waits on a new IDR.
+inline void RestartDecoderThreadIfRequested()
+{
+#ifndef XR_DISABLE_DECODER_THREAD
+    if (!gDecoderThread.IsRestartRequested())
+        return;
+    const auto programPtr = gProgram;
+    if (programPtr == nullptr)
+        return;
+    gDecoderThread.RestartIfRequested([&programPtr]() {
+        if (const auto graphicsPtr = programPtr->GetGraphicsPlugin()) {
+            std::scoped_lock lk(gRenderMutex);
+            programPtr->SetRenderMode(IOpenXrProgram::RenderMode::Lobby);
+            graphicsPtr->ClearVideoTextures();
+        }
+    });
+#endif
+}
+
 void alxr_process_frame(bool* exitRenderLoop /*= non-null */, bool* requestRestart /*= non-null */) {
     assert(exitRenderLoop != nullptr && requestRestart != nullptr);
 
     gProgram->PollEvents(exitRenderLoop, requestRestart);
     if (*exitRenderLoop || !gProgram->IsSessionRunning())
         return;
+    RestartDecoderThreadIfRequested();
     
     //gProgram->PollActions();
     {
@@ -245,6 +297,7 @@ void alxr_set_stream_config(const ALXRStreamConfig config)
 #ifndef XR_DISABLE_DECODER_THREAD
     const XrDecoderThread::StartCtx startCtx {
         .decoderConfig = config.decoderConfig,
+        .renderConfig = config.renderConfig,
         .programPtr = programPtr,
         .rustCtx = gRustCtx
     };
@@ -267,6 +320,12 @@ void alxr_set_stream_config(const ALXRStreamConfig config)
     };
     SendDummyBatteryLevels();
     programPtr->SetStreamConfig(config);
+    {
+        // a capture is only valid for the config it was started with.
+        std::scoped_lock lk(gStreamConfigMutex);
+        gPacketCapture.Close();
+        gStreamConfig = config;
+    }
 }
 
 void alxr_on_server_disconnect()
@@ -321,8 +380,11 @@ inline void LogViewConfig(const ALXREyeInfo& newEyeInfo)
         newEyeInfo.ipd * 1000.0f, lEyeFovStr.c_str(), rEyeFovStr.c_str()));
 }
 
-void alxr_on_tracking_update(const bool clientsidePrediction)
+// Called from alxr_on_tracking_update or the tracking thread, a Rust call already in flight when
+// the tracking thread starts is serialized with its samples.
+inline void UpdateTracking(const bool clientsidePrediction)
 {
+    std::scoped_lock lk(gTrackingMutex);
     const auto rustCtx = gRustCtx;
     if (rustCtx == nullptr)
         return;
@@ -350,6 +412,32 @@ void alxr_on_tracking_update(const bool clientsidePrediction)
     rustCtx->inputSend(&newInfo);
 }
 
+void alxr_on_tracking_update(const bool clientsidePrediction)
+{
+    // sampled by the engine's own thread instead.
+    if (gTrackingThread.IsRunning())
+        return;
+    UpdateTracking(clientsidePrediction);
+}
+
+bool alxr_start_tracking_thread(unsigned int samplesPerFrame, bool clientsidePrediction, bool realtimePriority)
+{
+    const auto programPtr = gProgram;
+    if (programPtr == nullptr || gRustCtx == nullptr)
+        return false;
+    return gTrackingThread.Start({
+        .programPtr       = programPtr,
+        .sampleFn         = [clientsidePrediction]() { UpdateTracking(clientsidePrediction); },
+        .samplesPerFrame  = samplesPerFrame,
+        .realtimePriority = realtimePriority
+    });
+}
+
+void alxr_stop_tracking_thread()
+{
+    gTrackingThread.Stop();
+}
+
 void alxr_on_receive(const unsigned char* packet, unsigned int packetSize)
 {
     const auto programPtr = gProgram;
@@ -361,6 +449,7 @@ void alxr_on_receive(const unsigned char* packet, unsigned int packetSize)
 #ifndef XR_DISABLE_DECODER_THREAD
             assert(packetSize >= sizeof(VideoFrame));
             const auto& header = *reinterpret_cast<const VideoFrame*>(packet);
+            gPacketCapture.Write(packet, packetSize);
             gDecoderThread.QueuePacket(header, packetSize);
 #endif
         } break;        
@@ -371,6 +460,45 @@ void alxr_on_receive(const unsigned char* packet, unsigned int packetSize)
     }
 }
 
+void alxr_on_receive_batch(const ALXRPacketView* packets, unsigned int packetCount)
+{
+    if (packets == nullptr || packetCount == 0)
+        return;
+    const auto programPtr = gProgram;
+    if (programPtr == nullptr)
+        return;
+    // runs of consecutive video packets are queued together, other packets are handled in between.
+    std::array<XrDecoderThread::VideoPacket, 64> videoRun;
+    std::size_t videoRunSize = 0;
+    const auto QueueVideoRun = [&]() {
+#ifndef XR_DISABLE_DECODER_THREAD
+        if (videoRunSize > 0)
+            gDecoderThread.QueuePackets({ videoRun.data(), videoRunSize });
+#endif
+        videoRunSize = 0;
+    };
+    for (const auto& [packet, packetSize] : std::span{ packets, packetCount }) {
+        if (packet == nullptr || packetSize < sizeof(std::uint32_t))
+            continue;
+        const std::uint32_t type = *reinterpret_cast<const uint32_t*>(packet);
+        switch (type) {
+            case ALVR_PACKET_TYPE_VIDEO_FRAME: {
+                assert(packetSize >= sizeof(VideoFrame));
+                gPacketCapture.Write(packet, packetSize);
+                videoRun[videoRunSize++] = { reinterpret_cast<const VideoFrame*>(packet), packetSize };
+                if (videoRunSize == videoRun.size())
+                    QueueVideoRun();
+            } break;
+            case ALVR_PACKET_TYPE_TIME_SYNC: {
+                assert(packetSize >= sizeof(TimeSync));
+                QueueVideoRun();
+                LatencyManager::Instance().OnTimeSyncRecieved(*(const TimeSync*)packet);
+            } break;
+        }
+    }
+    QueueVideoRun();
+}
+
 void alxr_on_haptics_feedback(unsigned long long path, float duration_s, float frequency, float amplitude)
 {
     if (const auto programPtr = gProgram) {
@@ -382,3 +510,202 @@ void alxr_on_haptics_feedback(unsigned long long path, float duration_s, float f
         });
     }
 }
+
+void alxr_set_frame_trace_enabled(bool enable)
+{
+    ALXR::FrameTracer::Instance().SetEnabled(enable);
+}
+
+bool alxr_write_frame_trace(const char* filePath, bool chromeTraceFormat)
+{
+    if (filePath == nullptr)
+        return false;
+    const auto& frameTracer = ALXR::FrameTracer::Instance();
+    return chromeTraceFormat ?
+        frameTracer.WriteChromeTrace(filePath) :
+        frameTracer.WriteBinary(filePath);
+}
+
+bool alxr_start_packet_capture(const char* filePath)
+{
+    if (filePath == nullptr)
+        return false;
+    std::scoped_lock lk(gStreamConfigMutex);
+    if (!gStreamConfig.has_value()) {
+        Log::Write(Log::Level::Warning, "Packet capture requires a stream config, call alxr_set_stream_config first.");
+        return false;
+    }
+    return gPacketCapture.Open(filePath, *gStreamConfig);
+}
+
+void alxr_stop_packet_capture()
+{
+    gPacketCapture.Close();
+}
+
+bool alxr_replay_packet_capture(const char* filePath, bool realtime)
+{
+    if (filePath == nullptr || gProgram == nullptr)
+        return false;
+    if (gIsReplaying.exchange(true)) {
+        Log::Write(Log::Level::Warning, "A packet capture replay is already running.");
+        return false;
+    }
+    Log::Write(Log::Level::Info, Fmt("Replaying packet capture \"%s\"", filePath));
+    ALXR::PacketReplayStats stats{};
+    const bool result = ALXR::ReplayPacketCapture(filePath, realtime, gIsReplaying,
+        [](const ALXRStreamConfig& config) { alxr_set_stream_config(config); },
+        [realtime](const std::uint8_t* packet, const std::size_t packetSize) {
+            // as fast as the decoder takes packets, rather than as fast as the queue budget drops them.
+            if (!realtime)
+                gDecoderThread.WaitForQueueDrained(std::chrono::seconds(1));
+            alxr_on_receive(packet, static_cast<unsigned int>(packetSize));
+        },
+        stats);
+    gIsReplaying.store(false);
+
+    const double seconds = stats.durationUs * 1e-6;
+    Log::Write(Log::Level::Info, Fmt("Replay finished: %zu packets, %.2f MB in %.2fs (%.2f Mbps)",
+        stats.packetCount, stats.byteCount / (1024.0 * 1024.0), seconds,
+        seconds > 0 ? stats.byteCount * 8e-6 / seconds : 0.0));
+    ALXR::FrameTracer::Instance().LogStageStatistics();
+    return result;
+}
+
+#ifdef ALXR_ENABLE_BENCHMARK_EXPORTS
+bool alxr_benchmark_decoder_threading(const char* filePath, unsigned int maxThreadCount)
+{
+    if (filePath == nullptr || gProgram == nullptr || maxThreadCount == 0)
+        return false;
+    if (gIsReplaying.exchange(true)) {
+        Log::Write(Log::Level::Warning, "A packet capture replay is already running.");
+        return false;
+    }
+    auto& frameTracer = ALXR::FrameTracer::Instance();
+    const bool wasTracing = frameTracer.IsEnabled();
+    if (!wasTracing)
+        frameTracer.SetEnabled(true);
+
+    struct BenchmarkRun {
+        ALXRDecoderThreadingPolicy policy;
+        unsigned int               threadCount;
+        ALXR::FrameStageStatistics decodeStats;
+        bool                       hasStats;
+    };
+    std::vector<BenchmarkRun> runs;
+    bool result = true;
+    for (const auto policy : { ALXRDecoderThreadingPolicy::SliceThreading, ALXRDecoderThreadingPolicy::FrameThreading }) {
+        for (unsigned int threadCount = 1; result && gIsReplaying.load(); threadCount = std::min(threadCount * 2, maxThreadCount)) {
+            // frame threading with a single thread is the same decoder as slice threading.
+            if (policy != ALXRDecoderThreadingPolicy::FrameThreading || threadCount > 1) {
+                Log::Write(Log::Level::Info, Fmt("Decoder benchmark: %s threading, %u threads",
+                    policy == ALXRDecoderThreadingPolicy::FrameThreading ? "frame" : "slice", threadCount));
+                const std::uint64_t runStartUs = GetSteadyTimestampUs();
+                ALXR::PacketReplayStats stats{};
+                result = ALXR::ReplayPacketCapture(filePath, true, gIsReplaying,
+                    [&](ALXRStreamConfig config) {
+                        config.decoderConfig.threadingPolicy = policy;
+                        config.decoderConfig.cpuThreadCount = threadCount;
+                        alxr_set_stream_config(config);
+                    },
+                    [](const std::uint8_t* packet, const std::size_t packetSize) {
+                        alxr_on_receive(packet, static_cast<unsigned int>(packetSize));
+                    },
+                    stats);
+                BenchmarkRun run{ .policy = policy, .threadCount = threadCount, .decodeStats{}, .hasStats = false };
+                run.hasStats = frameTracer.GetStageStatistics(ALXR::FrameTraceEvent::DecoderInput, runStartUs, run.decodeStats);
+                runs.push_back(run);
+            }
+            if (threadCount == maxThreadCount)
+                break;
+        }
+    }
+    gIsReplaying.store(false);
+    if (!wasTracing)
+        frameTracer.SetEnabled(false);
+
+    for (const auto& run : runs) {
+        const char* const policyName = run.policy == ALXRDecoderThreadingPolicy::FrameThreading ? "frame" : "slice";
+        if (!run.hasStats) {
+            Log::Write(Log::Level::Info, Fmt("Decoder benchmark %s x%2u: no frames decoded", policyName, run.threadCount));
+            continue;
+        }
+        const auto& ds = run.decodeStats;
+        Log::Write(Log::Level::Info, Fmt("Decoder benchmark %s x%2u: %6zu frames, p50 %6.2fms, p90 %6.2fms, p99 %6.2fms, max %6.2fms",
+            policyName, run.threadCount, ds.frameCount, ds.p50Ms, ds.p90Ms, ds.p99Ms, ds.maxMs));
+    }
+    return result;
+}
+
+bool alxr_benchmark_packet_ingest(const char* filePath, unsigned int batchSize)
+{
+    if (filePath == nullptr || gProgram == nullptr || batchSize == 0)
+        return false;
+    if (gIsReplaying.exchange(true)) {
+        Log::Write(Log::Level::Warning, "A packet capture replay is already running.");
+        return false;
+    }
+    using namespace std::chrono;
+    bool result = true;
+    for (const unsigned int runBatchSize : { 1u, batchSize }) {
+        // packets are copied out of the replay & the decoder drained before each batch, untimed, only
+        // the receive calls themselves are measured.
+        std::vector<std::vector<std::uint8_t>> batch(runBatchSize);
+        std::vector<ALXRPacketView> batchViews(runBatchSize);
+        std::size_t batchCount = 0;
+        std::uint64_t ingestNs = 0;
+        const auto IngestBatch = [&]() {
+            if (batchCount == 0)
+                return;
+            gDecoderThread.WaitForQueueDrained(seconds(1));
+            for (std::size_t i = 0; i < batchCount; ++i)
+                batchViews[i] = { batch[i].data(), static_cast<unsigned int>(batch[i].size()) };
+            const auto ingestStart = steady_clock::now();
+            if (runBatchSize == 1)
+                alxr_on_receive(batchViews[0].data, batchViews[0].size);
+            else
+                alxr_on_receive_batch(batchViews.data(), static_cast<unsigned int>(batchCount));
+            ingestNs += duration_cast<nanoseconds>(steady_clock::now() - ingestStart).count();
+            batchCount = 0;
+        };
+        ALXR::PacketReplayStats stats{};
+        result = ALXR::ReplayPacketCapture(filePath, false, gIsReplaying,
+            [](const ALXRStreamConfig& config) { alxr_set_stream_config(config); },
+            [&](const std::uint8_t* packet, const std::size_t packetSize) {
+                batch[batchCount++].assign(packet, packet + packetSize);
+                if (batchCount == runBatchSize)
+                    IngestBatch();
+            },
+            stats) && result;
+        IngestBatch();
+        if (stats.packetCount > 0) {
+            Log::Write(Log::Level::Info, Fmt("Packet ingest, batches of %3u: %zu packets, %.1f ns/packet (%.2f Mbps max)",
+                runBatchSize, stats.packetCount, double(ingestNs) / stats.packetCount,
+                ingestNs > 0 ? stats.byteCount * 8e3 / ingestNs : 0.0));
+        }
+        if (!gIsReplaying.load())
+            break;
+    }
+    gIsReplaying.store(false);
+    return result;
+}
+#endif
+
+bool alxr_start_pose_trace(const char* filePath)
+{
+    if (filePath == nullptr)
+        return false;
+    return ALXR::PoseTraceWriter::Instance().Open(filePath);
+}
+
+void alxr_stop_pose_trace()
+{
+    ALXR::PoseTraceWriter::Instance().Close();
+}
+
+bool alxr_evaluate_pose_trace(const char* filePath, unsigned int maxHorizonMs)
+{
+    if (filePath == nullptr || maxHorizonMs == 0)
+        return false;
+    return ALXR::EvaluatePoseTrace(filePath, maxHorizonMs);
+}
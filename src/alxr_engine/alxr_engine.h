@@ -27,12 +27,42 @@ DLLEXPORT void alxr_set_stream_config(const ALXRStreamConfig config);
 DLLEXPORT ALXRGuardianData alxr_get_guardian_data();
 
 DLLEXPORT void alxr_on_receive(const unsigned char* packet, unsigned int packetSize);
+// alxr_on_receive over the packets of one socket read (e.g. recvmmsg), processed in order.
+DLLEXPORT void alxr_on_receive_batch(const ALXRPacketView* packets, unsigned int packetCount);
 DLLEXPORT void alxr_on_tracking_update(const bool clientsidePrediction);
+// Samples tracking on an engine thread, samplesPerFrame times per display frame at deadlines aligned to the
+// predicted display times. alxr_on_tracking_update calls are ignored while it runs.
+DLLEXPORT bool alxr_start_tracking_thread(unsigned int samplesPerFrame, bool clientsidePrediction, bool realtimePriority);
+DLLEXPORT void alxr_stop_tracking_thread();
 DLLEXPORT void alxr_on_haptics_feedback(unsigned long long path, float duration_s, float frequency, float amplitude);
 DLLEXPORT void alxr_on_server_disconnect();
 DLLEXPORT void alxr_on_pause();
 DLLEXPORT void alxr_on_resume();
 
+// Per-frame pipeline stage timestamps, written as Chrome trace JSON (chromeTraceFormat) or compact binary.
+DLLEXPORT void alxr_set_frame_trace_enabled(bool enable);
+DLLEXPORT bool alxr_write_frame_trace(const char* filePath, bool chromeTraceFormat);
+
+// Records received video packets & the current stream config, requires alxr_set_stream_config first.
+DLLEXPORT bool alxr_start_packet_capture(const char* filePath);
+DLLEXPORT void alxr_stop_packet_capture();
+// Blocks while feeding a capture through the decoder in place of the server, realtime keeps the recorded pacing.
+DLLEXPORT bool alxr_replay_packet_capture(const char* filePath, bool realtime);
+#ifdef ALXR_ENABLE_BENCHMARK_EXPORTS
+// Replays a capture (realtime) once per software decoder threading policy & thread count (1, 2, 4.. up to
+// maxThreadCount) and logs the decode latency of each, e.g. to pick cpuThreadCount for a stream resolution.
+DLLEXPORT bool alxr_benchmark_decoder_threading(const char* filePath, unsigned int maxThreadCount);
+// Replays a capture (as fast as the decoder drains it) through alxr_on_receive then alxr_on_receive_batch in
+// batches of batchSize packets, logs the time spent per packet in each.
+DLLEXPORT bool alxr_benchmark_packet_ingest(const char* filePath, unsigned int batchSize);
+#endif
+
+// Records the located (unpredicted) head & controller poses of every tracking update.
+DLLEXPORT bool alxr_start_pose_trace(const char* filePath);
+DLLEXPORT void alxr_stop_pose_trace();
+// Logs the error of each client pose prediction model over a pose trace, for horizons up to maxHorizonMs.
+DLLEXPORT bool alxr_evaluate_pose_trace(const char* filePath, unsigned int maxHorizonMs);
+
 #ifdef __cplusplus
 }
 #endif
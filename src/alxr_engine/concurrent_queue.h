@@ -1,56 +1,208 @@
 #pragma once
-#if defined(_MSC_VER)
+#include <cstdint>
+#include <cstddef>
 #include <memory>
-#include <concurrent_queue.h>
+#include <new>
+#include <atomic>
+#include <type_traits>
+#include <utility>
 namespace xrconcurrency
 {
-    template < typename Tp, typename Alloc = std::allocator<Tp> >
-    using concurrent_queue = concurrency::concurrent_queue<Tp, Alloc>;
-}
-#else
-#include <memory>
-#include <queue>
-#include <mutex>
-#include <shared_mutex>
-namespace xrconcurrency
+namespace detail
 {
-	template < typename Tp, typename Alloc = std::allocator<Tp> >
-	class concurrent_queue
-	{
-		using QueueT = std::queue<Tp, std::deque<Tp,Alloc> >;
-		mutable std::shared_mutex m_mutex;
-		QueueT m_queue;
-	public:
-        concurrent_queue() = default;
+    // Fixed rather than std::hardware_destructive_interference_size, which varies with -mtune.
+    constexpr inline const std::size_t CacheLineSize = 64;
+
+    template < typename Tp >
+    struct RingStorage
+    {
+        alignas(Tp) std::byte data[sizeof(Tp)];
+
+        inline Tp* ptr() noexcept { return std::launder(reinterpret_cast<Tp*>(data)); }
+
+        template < typename... Args >
+        inline void construct(Args&&... args) {
+            ::new (static_cast<void*>(data)) Tp(std::forward<Args>(args)...);
+        }
+
+        inline void pop_into(Tp& x) {
+            Tp* const p = ptr();
+            x = std::move(*p);
+            p->~Tp();
+        }
+
+        inline void destroy() noexcept { ptr()->~Tp(); }
+    };
+}
+
+    // Bounded, lock-free single producer / single consumer ring.
+    // Both try_push & try_pop are wait-free, Capacity must be a power of two.
+    template < typename Tp, const std::size_t Capacity = 64 >
+    class spsc_queue
+    {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two.");
+        constexpr static const std::size_t Mask = Capacity - 1;
+
+        alignas(detail::CacheLineSize) std::atomic<std::size_t> m_head{ 0 }; // consumer index
+        alignas(detail::CacheLineSize) std::atomic<std::size_t> m_tail{ 0 }; // producer index
+        alignas(detail::CacheLineSize) detail::RingStorage<Tp> m_slots[Capacity];
+
+        template < typename Up >
+        inline bool try_emplace(Up&& x)
+        {
+            const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_head.load(std::memory_order_acquire) == Capacity)
+                return false;
+            m_slots[tail & Mask].construct(std::forward<Up>(x));
+            m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+    public:
+        spsc_queue() = default;
+        ~spsc_queue() { clear(); }
+
+        // Queues are pinned in memory, elements themselves only need to be movable.
+        spsc_queue(const spsc_queue&) = delete;
+        spsc_queue(spsc_queue&&) = delete;
+        spsc_queue& operator=(const spsc_queue&) = delete;
+        spsc_queue& operator=(spsc_queue&&) = delete;
+
+        [[nodiscard]] inline bool push(const Tp& x) { return try_emplace(x); }
+        [[nodiscard]] inline bool push(Tp&& x) { return try_emplace(std::move(x)); }
+
+        bool try_pop(Tp& x)
+        {
+            const std::size_t head = m_head.load(std::memory_order_relaxed);
+            if (head == m_tail.load(std::memory_order_acquire))
+                return false;
+            m_slots[head & Mask].pop_into(x);
+            m_head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        inline bool empty() const {
+            return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+        }
+
+        // Not thread-safe, only call once producers & consumers have stopped.
+        void clear() noexcept
+        {
+            const std::size_t tail = m_tail.load(std::memory_order_acquire);
+            std::size_t head = m_head.load(std::memory_order_relaxed);
+            for (; head != tail; ++head)
+                m_slots[head & Mask].destroy();
+            m_head.store(head, std::memory_order_release);
+        }
+    };
+
+    // Bounded, lock-free multiple producer / single consumer ring (per-slot sequence numbers).
+    // try_pop is wait-free and only reports empty when the next element in FIFO order has not
+    // been published yet, try_push is lock-free and fails only when the ring is full.
+    template < typename Tp, const std::size_t Capacity = 64 >
+    class mpsc_queue
+    {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two.");
+        constexpr static const std::size_t Mask = Capacity - 1;
+
+        struct alignas(detail::CacheLineSize) Cell
+        {
+            std::atomic<std::size_t> sequence;
+            detail::RingStorage<Tp>  storage;
+        };
 
-        // TODO: Implement these deleted functions.
-        concurrent_queue(const concurrent_queue&) = delete;
-        concurrent_queue(concurrent_queue&&) = delete;
-        concurrent_queue& operator=(const concurrent_queue&) = delete;
-        concurrent_queue& operator=(concurrent_queue&&) = delete;
+        alignas(detail::CacheLineSize) std::atomic<std::size_t> m_tail{ 0 }; // producers index
+        alignas(detail::CacheLineSize) std::size_t m_head{ 0 };              // consumer index
+        Cell m_cells[Capacity];
 
-        void push(const Tp& x)
+        template < typename Up >
+        inline bool try_emplace(Up&& x)
         {
-            std::unique_lock l(m_mutex);
-            m_queue.push(std::move(x));
+            std::size_t pos = m_tail.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Cell& cell = m_cells[pos & Mask];
+                const std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+                if (diff == 0) {
+                    if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        cell.storage.construct(std::forward<Up>(x));
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                    return false; // full
+                else
+                    pos = m_tail.load(std::memory_order_relaxed);
+            }
         }
 
-        void push(Tp&& x)
+    public:
+        mpsc_queue()
         {
-            std::unique_lock l(m_mutex);
-            m_queue.push(std::move(x));
+            for (std::size_t i = 0; i < Capacity; ++i)
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
         }
+        ~mpsc_queue() { clear(); }
 
+        // Queues are pinned in memory, elements themselves only need to be movable.
+        mpsc_queue(const mpsc_queue&) = delete;
+        mpsc_queue(mpsc_queue&&) = delete;
+        mpsc_queue& operator=(const mpsc_queue&) = delete;
+        mpsc_queue& operator=(mpsc_queue&&) = delete;
+
+        [[nodiscard]] inline bool push(const Tp& x) { return try_emplace(x); }
+        [[nodiscard]] inline bool push(Tp&& x) { return try_emplace(std::move(x)); }
+
+        // Must only be called from a single consumer thread.
         bool try_pop(Tp& x)
         {
-            std::unique_lock l(m_mutex, std::try_to_lock_t{});
-            if (!l.owns_lock())
+            Cell& cell = m_cells[m_head & Mask];
+            if (cell.sequence.load(std::memory_order_acquire) != m_head + 1)
                 return false;
-            if (m_queue.empty()) return false;
-            x = std::move(m_queue.front());
-            m_queue.pop();
+            cell.storage.pop_into(x);
+            cell.sequence.store(m_head + Capacity, std::memory_order_release);
+            ++m_head;
             return true;
         }
-	};
+
+        // Not thread-safe, only call once producers & consumers have stopped.
+        void clear() noexcept
+        {
+            for (;;) {
+                Cell& cell = m_cells[m_head & Mask];
+                if (cell.sequence.load(std::memory_order_acquire) != m_head + 1)
+                    return;
+                cell.storage.destroy();
+                cell.sequence.store(m_head + Capacity, std::memory_order_release);
+                ++m_head;
+            }
+        }
+    };
+}
+
+#if defined(_MSC_VER)
+#include <concurrent_queue.h>
+namespace xrconcurrency
+{
+    // push never fails, concurrency::concurrent_queue grows instead. It reports success so callers
+    // handle a full queue the same way on every platform.
+    template < typename Tp, typename Alloc = std::allocator<Tp> >
+    class concurrent_queue : public concurrency::concurrent_queue<Tp, Alloc>
+    {
+        using BaseT = concurrency::concurrent_queue<Tp, Alloc>;
+    public:
+        [[nodiscard]] inline bool push(const Tp& x) { BaseT::push(x); return true; }
+        [[nodiscard]] inline bool push(Tp&& x) { BaseT::push(std::move(x)); return true; }
+    };
+}
+#else
+namespace xrconcurrency
+{
+    // Stands in for concurrency::concurrent_queue on non-msvc platforms, but is bounded: push fails
+    // (returns false) instead of growing when the queue is full, callers must handle it.
+    template < typename Tp, typename Alloc = std::allocator<Tp> >
+    using concurrent_queue = mpsc_queue<Tp>;
 }
 #endif
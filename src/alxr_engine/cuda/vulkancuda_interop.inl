@@ -18,7 +18,7 @@ struct CudaSharedTexture
     std::array<cudaArray_t, 2> planeArrays{};
 };
 
-std::array<CudaSharedTexture, 2> m_videoTexturesCuda{};
+std::array<CudaSharedTexture, VideoTexCount> m_videoTexturesCuda{};
 
 cudaStream_t videoBufferStream = nullptr;//{};
 cudaExternalSemaphore_t m_texCopyExtSemaphore{};
@@ -298,7 +298,7 @@ virtual void CreateVideoTexturesCUDA(const std::size_t width, const std::size_t
         const VkSamplerYcbcrConversionInfo ycbcrConverInfo {
             .sType = VK_STRUCTURE_TYPE_SAMPLER_YCBCR_CONVERSION_INFO,
             .pNext = nullptr,
-            .conversion = m_videoStreamLayout.ycbcrSamplerConversion
+            .conversion = m_videoStream->layout.ycbcrSamplerConversion
         };
         const VkImageViewCreateInfo viewInfo{
             .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
@@ -403,7 +403,6 @@ virtual void UpdateVideoTextureCUDA(const YUVBuffer& yuvBuffer) override
     newSharedTex.frameIndex = yuvBuffer.frameIndex;
 
     //CudaVkSemaphoreSignal(m_texCopy, m_texCopyExtSemaphore, videoBufferStream);
-    m_currentVideoTex.store((freeIndex + 1) % m_videoTextures.size());
-    m_renderTex.store(freeIndex);
+    PublishVideoTexture();
 }
 #endif
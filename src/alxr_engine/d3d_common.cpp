@@ -115,7 +115,7 @@ ComPtr<IDXGIAdapter1> GetAdapter(LUID adapterId) {
     
     DXGI_ADAPTER_DESC1 adapterDesc;
     CHECK_HRCMD(dxgiAdapter->GetDesc1(&adapterDesc));
-    Log::Write(Log::Level::Verbose, Fmt("Using graphics adapter %ws", adapterDesc.Description));
+    ALXR_LOG_VERBOSE(Fmt("Using graphics adapter %ws", adapterDesc.Description));
     
     return dxgiAdapter;
 }
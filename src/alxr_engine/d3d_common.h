@@ -185,7 +185,7 @@ inline CoreShaders<T>::CoreShaders(const typename CoreShaders<T>::Path& shaderSu
         const auto csoPath = GetCSOPath(csoFile);
         CHECK_MSG(!csoPath.empty(), "CSO path/file does not exist.");
         const auto csoPathStr = csoPath.string();
-        Log::Write(Log::Level::Verbose, Fmt("Loading D3D compiled shader object: %s", csoPathStr.c_str()));
+        ALXR_LOG_VERBOSE(Fmt("Loading D3D compiled shader object: %s", csoPathStr.c_str()));
         auto cso = LoadCompiledShaderObject(csoPath);
         CHECK_MSG(cso.size() > 0, "Failed to load CSO file!");
         return cso;
@@ -1,35 +1,152 @@
+#include "pch.h"
+#include "common.h"
 #include "decoder_thread.h"
 #include "logger.h"
 #include "decoderplugin.h"
 #include "latency_manager.h"
+#include "frame_trace.h"
+#include "timing.h"
+#include <cassert>
 
 bool XrDecoderThread::QueuePacket(const VideoFrame& header, const std::size_t packetSize)
+{
+	const VideoPacket packet{ &header, packetSize };
+	return QueuePackets({ &packet, 1 }) == 1;
+}
+
+std::size_t XrDecoderThread::QueuePackets(const std::span<const VideoPacket> packets)
 {
 	const auto decoderPlugin = m_decoderPlugin;
-	if (decoderPlugin == nullptr)
-		return false;
-	LatencyManager::Instance().OnPreVideoPacketRecieved(header);
-
-	bool fecFailure = false, isComplete = true;
-	if (const auto fecQueue = m_fecQueue) {
-		fecQueue->addVideoPacket(&header, static_cast<int>(packetSize), fecFailure);
-		if (isComplete = fecQueue->reconstruct()) {
-			const size_t frameBufferSize = fecQueue->getFrameByteSize();
-			const auto frameBufferPtr = reinterpret_cast<const std::uint8_t*>(fecQueue->getFrameBuffer());
-			decoderPlugin->QueuePacket({ frameBufferPtr, frameBufferSize }, header.trackingFrameIndex);
-			fecQueue->clearFecFailure();
+	const auto nalBufferPool = m_nalBufferPool;
+	if (decoderPlugin == nullptr || nalBufferPool == nullptr)
+		return 0;
+	const auto fecQueue = m_fecQueue;
+	auto& latencyManager = LatencyManager::Instance();
+	for (const auto& [headerPtr, packetSize] : packets) {
+		assert(headerPtr != nullptr && packetSize >= sizeof(VideoFrame));
+		const VideoFrame& header = *headerPtr;
+		const std::int64_t lostPacketCount = latencyManager.OnPreVideoPacketRecieved(header);
+
+		bool fecFailure = false, isComplete = true;
+		if (fecQueue != nullptr) {
+			fecQueue->addVideoPacket(&header, static_cast<int>(packetSize), fecFailure);
+			if (fecFailure) { // the previous frame was abandoned incomplete.
+				latencyManager.OnVideoFrameCorrupted();
+				m_referenceChain.OnFrameLost();
+			}
+			if (isComplete = fecQueue->reconstruct()) {
+				ALXR::FrameTracer::Instance().Record(ALXR::FrameTraceEvent::FecReconstructed, header.trackingFrameIndex);
+				const size_t frameBufferSize = fecQueue->getFrameByteSize();
+				const auto frameBufferPtr = reinterpret_cast<const std::uint8_t*>(fecQueue->getFrameBuffer());
+				QueueFrame(*decoderPlugin, *nalBufferPool, header.trackingFrameIndex, { frameBufferPtr, frameBufferSize });
+				fecQueue->clearFecFailure();
+			}
+		} else { // then FEC is disabled, every packet is a whole frame.
+			if (lostPacketCount > 0) {
+				latencyManager.OnVideoFrameCorrupted();
+				m_referenceChain.OnFrameLost();
+			}
+			const size_t frameBufferSize = packetSize - sizeof(VideoFrame);
+			const auto frameBufferPtr = reinterpret_cast<const std::uint8_t*>(&header) + sizeof(VideoFrame);
+			QueueFrame(*decoderPlugin, *nalBufferPool, header.trackingFrameIndex, { frameBufferPtr, frameBufferSize });
 		}
-	} else { // then FEC is disabled
-		const size_t frameBufferSize = packetSize - sizeof(VideoFrame);
-		const auto frameBufferPtr = reinterpret_cast<const std::uint8_t*>(&header) + sizeof(VideoFrame);
-		decoderPlugin->QueuePacket({ frameBufferPtr, frameBufferSize }, header.trackingFrameIndex);
+		latencyManager.OnPostVideoPacketRecieved(header, { isComplete, fecFailure });
 	}
 
-	LatencyManager::Instance().OnPostVideoPacketRecieved(header, { isComplete, fecFailure });
+	// once per batch, a burst of losses within it is folded into a single request anyway.
+	if (m_referenceChain.ShouldRequestIDR(GetSteadyTimestampUs())) {
+		ALXR_LOG_VERBOSE("Reference frame lost, sending IDR request");
+		latencyManager.OnIDRRequested();
+		latencyManager.SendVideoErrorReport();
+		if (const auto rustCtx = m_rustCtx)
+			rustCtx->requestIDR();
+	}
+	return packets.size();
+}
+
+bool XrDecoderThread::WaitForQueueDrained(const std::chrono::microseconds timeout) const
+{
+	using namespace std::chrono;
+	const auto decoderPlugin = m_decoderPlugin;
+	if (decoderPlugin == nullptr)
+		return false;
+	const auto deadline = steady_clock::now() + timeout;
+	while (decoderPlugin->GetQueueState().depth > 0) {
+		if (!m_isRuningToken.load() || steady_clock::now() >= deadline)
+			return false;
+		std::this_thread::sleep_for(250us);
+	}
 	return true;
 }
 
+void XrDecoderThread::QueueFrame
+(
+	IDecoderPlugin& decoderPlugin,
+	ALXR::NALBufferPool& nalBufferPool,
+	const std::uint64_t trackingFrameIndex,
+	const ALXR::NALSpan& frame
+)
+{
+	auto& latencyManager = LatencyManager::Instance();
+	const auto queueState = decoderPlugin.GetQueueState();
+	// a packet the decoder failed to decode is as lost as one that never arrived.
+	if (queueState.lostCount != m_decoderLostCount) {
+		m_decoderLostCount = queueState.lostCount;
+		m_referenceChain.OnFrameLost();
+	}
+	const auto frameInfo = ALXR::ParseNALFrame(frame, m_codec, &m_paramSets);
+	if (m_referenceChain.OnFrame(trackingFrameIndex, frameInfo) != ALXR::ReferenceChainTracker::Verdict::Decode) {
+		latencyManager.OnVideoFrameSkipped();
+		return;
+	}
+
+	// The decoder has fallen behind, everything queued would be displayed late against the head pose.
+	// It is dropped in favour of a new IDR (requested by QueuePacket once the chain is broken), the
+	// network thread never waits on the decoder.
+	if (m_queueBudget.IsExceeded(queueState)) {
+		ALXR_LOG_VERBOSE(Fmt("Decoder queue over budget (%zu packets, oldest %.2fms), dropping queued frames",
+			queueState.depth, queueState.oldestAgeUs * 1e-3));
+		decoderPlugin.FlushQueue();
+		latencyManager.OnVideoQueueFlushed();
+		if (!frameInfo.isKeyFrame) {
+			m_referenceChain.OnFrameLost();
+			latencyManager.OnVideoFrameSkipped();
+			return;
+		}
+	}
+	if (!decoderPlugin.QueuePacket(nalBufferPool.Acquire(frame), trackingFrameIndex)) {
+		m_referenceChain.OnFrameLost();
+		latencyManager.OnVideoFrameSkipped();
+	}
+}
+
 void XrDecoderThread::Stop()
+{
+	std::scoped_lock lk(m_controlMutex);
+	StopLocked();
+}
+
+void XrDecoderThread::Start(const XrDecoderThread::StartCtx& ctx)
+{
+	std::scoped_lock lk(m_controlMutex);
+	StartLocked(ctx);
+}
+
+void XrDecoderThread::RestartIfRequested(const std::function<void()>& onStopped)
+{
+	std::scoped_lock lk(m_controlMutex);
+	// a Stop or Start since the request already replaced the decoder that made it.
+	if (!m_isRestartRequested.load())
+		return;
+	Log::Write(Log::Level::Info, "Restarting decoder thread.");
+	const StartCtx ctx = m_startCtx;
+	StopLocked();
+	if (onStopped)
+		onStopped();
+	StartLocked(ctx);
+}
+
+void XrDecoderThread::StopLocked()
 {
 	Log::Write(Log::Level::Info, "shutting down decoder thread");
 	m_isRuningToken = false;
@@ -38,24 +155,58 @@ void XrDecoderThread::Stop()
 		m_decoderThread.join();
 	}
 	m_fecQueue.reset();
+	m_rustCtx.reset();
 
 	Log::Write(Log::Level::Info, "m_decoderPlugin destroying");
 	m_decoderPlugin.reset();
 	Log::Write(Log::Level::Info, "m_decoderPlugin destroyed");
+	LatencyManager::Instance().LogVideoFrameCounters();
+
+	if (const auto nalBufferPool = std::move(m_nalBufferPool)) {
+		const auto& stats = nalBufferPool->GetStats();
+		Log::Write(Log::Level::Info, Fmt("NAL buffer pool stats: acquired=%llu, exhausted=%llu, oversized=%llu, high-watermark=%zu/%zu",
+			stats.acquired.load(), stats.exhausted.load(), stats.oversized.load(),
+			stats.highWatermark.load(), nalBufferPool->SlotCount()));
+	}
 	
+	m_startCtx = {}; // don't keep the program alive.
+	m_isRestartRequested = false;
 	Log::Write(Log::Level::Info, "Decoder thread finished shutdown");
 }
 
-void XrDecoderThread::Start(const XrDecoderThread::StartCtx& ctx)
+void XrDecoderThread::StartLocked(const XrDecoderThread::StartCtx& ctx)
 {
 	if (m_isRuningToken)
 		return;
+	m_startCtx = ctx;
+	m_isRestartRequested = false;
 
 	Log::Write(Log::Level::Info, "Starting decoder thread.");
 	m_fecQueue = ctx.decoderConfig.enableFEC ?
 		std::make_shared<FECQueue>() : nullptr;
+	{
+		const auto& rc = ctx.renderConfig;
+		const std::size_t slotCapacity = ALXR::NALBufferPool::EstimateFrameCapacity
+		(
+			rc.eyeWidth, rc.eyeHeight,
+			std::uint64_t(ctx.decoderConfig.bitrateMbps) * 1000000, rc.refreshRate
+		);
+		m_nalBufferPool = ALXR::NALBufferPool::Create(NALBufferPoolSize, slotCapacity);
+		Log::Write(Log::Level::Info, Fmt("NAL buffer pool created, slots: %zu, slot capacity: %zu bytes", NALBufferPoolSize, slotCapacity));
+	}
 	m_decoderPlugin = CreateDecoderPlugin();
 	LatencyManager::Instance().ResetAll();
+	m_rustCtx = ctx.rustCtx;
+	m_codec = static_cast<ALVR_CODEC>(ctx.decoderConfig.codecType);
+	m_paramSets.Reset(m_codec);
+	m_referenceChain.Reset(GetSteadyTimestampUs());
+	m_decoderLostCount = 0;
+	m_queueBudget = {
+		.maxDepth	  = ctx.decoderConfig.maxQueuedPackets > 0 ? ctx.decoderConfig.maxQueuedPackets : DefaultMaxQueuedPackets,
+		.maxLatencyUs = ctx.decoderConfig.maxQueueLatencyMs > 0 ?
+			static_cast<std::uint64_t>(ctx.decoderConfig.maxQueueLatencyMs * 1000.0f) : DefaultMaxQueueLatencyUs
+	};
+	Log::Write(Log::Level::Info, Fmt("Decoder queue budget: %zu packets, %.2fms", m_queueBudget.maxDepth, m_queueBudget.maxLatencyUs * 1e-3));
 #ifdef XR_USE_PLATFORM_WIN32
 	auto decoderType = ALXRDecoderType::D311VA;
 #else
@@ -63,7 +214,7 @@ void XrDecoderThread::Start(const XrDecoderThread::StartCtx& ctx)
 #endif
 	if (const auto rustCtx = ctx.rustCtx) {
 		decoderType = rustCtx->decoderType;
-		Log::Write(Log::Level::Verbose, "Sending IDR request");
+		ALXR_LOG_VERBOSE("Sending IDR request");
 		rustCtx->setWaitingNextIDR(true);
 		rustCtx->requestIDR();
 	}
@@ -86,9 +237,13 @@ void XrDecoderThread::Start(const XrDecoderThread::StartCtx& ctx)
 				.config		 = startCtx.decoderConfig,
 				.rustCtx	 = startCtx.rustCtx,
 				.programPtr	 = startCtx.programPtr,
-				.decoderType = decoderType
+				.decoderType = decoderType,
+				.refreshRate = startCtx.renderConfig.refreshRate
 			};
 			m_decoderPlugin->Run(runCtx, m_isRuningToken);
+			// the plugin stays alive until Stop has joined this thread.
+			if (m_decoderPlugin->IsRestartRequested())
+				m_isRestartRequested = true;
 
 			Log::Write(Log::Level::Info, "Decoder thread exiting.");
 		}
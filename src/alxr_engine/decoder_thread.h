@@ -5,10 +5,18 @@
 #include <memory>
 #include <atomic>
 #include <thread>
+#include <mutex>
+#include <chrono>
+#include <span>
+#include <functional>
 
 #include "alxr_ctypes.h"
 #include "ALVR-common/packet_types.h"
 #include "fec.h"
+#include "nal_buffer_pool.h"
+#include "nal_parser.h"
+#include "reference_chain.h"
+#include "packet_queue.h"
 
 struct IDecoderPlugin;
 struct IOpenXrProgram;
@@ -16,13 +24,38 @@ struct IOpenXrProgram;
 class XrDecoderThread {
 	using DecoderPluginPtr = std::shared_ptr<IDecoderPlugin>;
 	using FECQueuePtr = std::shared_ptr<FECQueue>;
+	using NALBufferPoolPtr = std::shared_ptr<ALXR::NALBufferPool>;
 	using CodecType = std::atomic<ALVR_CODEC>;
+	using ALXRRustCtxPtr = std::shared_ptr<const ALXRRustCtx>;
 
 	DecoderPluginPtr  m_decoderPlugin{ nullptr };
 	FECQueuePtr		  m_fecQueue{ nullptr };
+	NALBufferPoolPtr  m_nalBufferPool{ nullptr };
+	ALXRRustCtxPtr	  m_rustCtx{ nullptr };
 	std::atomic<bool> m_isRuningToken{ false };
 	std::thread		  m_decoderThread;
 
+	// network thread state, frames that can not be decoded are dropped before reaching the decoder.
+	ALVR_CODEC					m_codec{ ALVR_CODEC_H265 };
+	ALXR::ParameterSetCache		m_paramSets{};
+	ALXR::ReferenceChainTracker	m_referenceChain{};
+	ALXR::PacketQueueBudget		m_queueBudget{ DefaultMaxQueuedPackets, DefaultMaxQueueLatencyUs };
+	std::uint64_t				m_decoderLostCount{ 0 }; // PacketQueueState::lostCount last seen.
+
+	// Encoded frames in-flight between the network & decoder threads, exhaustion falls back to the heap.
+	constexpr static const std::size_t NALBufferPoolSize = 16;
+	// A decoder keeping up holds at most a frame or two (MediaCodec queues parameter sets separately).
+	constexpr static const std::size_t   DefaultMaxQueuedPackets = 8;
+	constexpr static const std::uint64_t DefaultMaxQueueLatencyUs = 50000;
+
+	void QueueFrame
+	(
+		IDecoderPlugin& decoderPlugin,
+		ALXR::NALBufferPool& nalBufferPool,
+		const std::uint64_t trackingFrameIndex,
+		const ALXR::NALSpan& frame
+	);
+
 public:
 
 	inline XrDecoderThread() = default;
@@ -42,11 +75,40 @@ public:
 		using ALXRRustCtxPtr	= std::shared_ptr<const ALXRRustCtx>;
 
 		ALXRDecoderConfig decoderConfig;
+		ALXRRenderConfig  renderConfig;
 		IOpenXrProgramPtr programPtr;
 		ALXRRustCtxPtr	  rustCtx;
 	};
+	// Start, Stop & RestartIfRequested are serialized, they may be called from different threads.
 	void Start(const StartCtx& ctx);
 	void Stop();
 	bool QueuePacket(const VideoFrame& header, const std::size_t packetSize);
+
+	// The decoder stopped on a stream change it can not follow, see IDecoderPlugin::IsRestartRequested.
+	inline bool IsRestartRequested() const { return m_isRestartRequested.load(); }
+	// Stops the decoder, calls onStopped (e.g. to clear the video textures) & starts it again with the
+	// last StartCtx, if a restart is still requested once no other Start/Stop is in progress.
+	void RestartIfRequested(const std::function<void()>& onStopped);
+
+	struct VideoPacket {
+		const VideoFrame* header;
+		std::size_t		  size; // including the header.
+	};
+	// QueuePacket over a batch of received packets, the decoder state is looked up & the IDR request
+	// check done once per batch. Returns the number of packets queued, 0 while stopped.
+	std::size_t QueuePackets(const std::span<const VideoPacket> packets);
+
+	// For producers which are not real-time (e.g. a capture replayed as fast as possible) to be paced
+	// by the decoder rather than exceed the queue budget: waits until every queued packet was taken,
+	// false on timeout. Must be called from the thread calling QueuePacket.
+	bool WaitForQueueDrained(const std::chrono::microseconds timeout) const;
+
+private:
+	void StartLocked(const StartCtx& ctx);
+	void StopLocked();
+
+	std::mutex		  m_controlMutex;
+	StartCtx		  m_startCtx{};				// of the last Start, guarded by m_controlMutex.
+	std::atomic<bool> m_isRestartRequested{ false }; // set by the decoder thread as it exits.
 };
 #endif
@@ -10,6 +10,8 @@
 #include <unordered_map>
 
 #include "alxr_ctypes.h"
+#include "nal_buffer_pool.h"
+#include "packet_queue.h"
 
 struct OptionMap {
     template < typename Tp >
@@ -67,14 +69,21 @@ struct ALXRRustCtx;
 struct IOpenXrProgram;
 
 struct IDecoderPlugin {
-    using PacketType = std::span<const std::uint8_t>;
+    // Reference counted (pooled) encoded frame, plugins should hold onto it rather than copy it.
+    using PacketType = ALXR::NALBuffer;
 
+	// Called from the network thread, never blocks: false when the packet queue is full & the packet was dropped.
 	virtual bool QueuePacket
 	(
         const PacketType& /*newPacketData*/,
 		const std::uint64_t /*trackingFrameIndex*/
 	) = 0;
 
+    // Network thread side of the packet queue, see ALXR::PacketQueue.
+    virtual ALXR::PacketQueueState GetQueueState() const = 0;
+    // Drops every packet queued so far, the decoder skips them.
+    virtual void FlushQueue() = 0;
+
     using shared_bool = std::atomic<bool>;
     struct RunCtx {
         using IOpenXrProgramPtr = std::shared_ptr<IOpenXrProgram>;
@@ -85,9 +94,14 @@ struct IDecoderPlugin {
         RustCtxPtr        rustCtx;
         IOpenXrProgramPtr programPtr;
         ALXRDecoderType   decoderType;
+        float             refreshRate;
     };
     virtual bool Run(const RunCtx& /*ctx*/, shared_bool& /*isRunningToken*/) = 0;
 
+    // Run stopped on a stream change it can not follow in place (e.g. interop textures of a new size),
+    // the decoder thread must be restarted with cleared video textures.
+    virtual bool IsRestartRequested() const = 0;
+
     constexpr inline IDecoderPlugin() noexcept = default;
     inline virtual ~IDecoderPlugin() = default;
 	IDecoderPlugin(const IDecoderPlugin&) noexcept = delete;
@@ -10,9 +10,19 @@ namespace {
             return true;
         }
 
+        virtual ALXR::PacketQueueState GetQueueState() const override {
+            return { 0, 0, false, 0 };
+        }
+
+        virtual void FlushQueue() override {}
+
         virtual bool Run(const RunCtx& /*ctx*/, shared_bool& /*isRunningToken*/) override {
             return true;
         }
+
+        virtual bool IsRestartRequested() const override {
+            return false;
+        }
     };
 }
 
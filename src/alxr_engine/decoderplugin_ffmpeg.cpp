@@ -10,6 +10,7 @@
 #include <atomic>
 #include <chrono>
 #include <mutex>
+#include <utility>
 
 #include <readerwritercircularbuffer.h>
 
@@ -40,6 +41,9 @@ extern "C" {
 #include "openxr_program.h"
 #include "latency_manager.h"
 #include "timing.h"
+#include "frame_trace.h"
+#include "thread_policy.h"
+#include "packet_queue.h"
 
 namespace {;
 template < typename AVType, void(&avdeleter)(AVType*) >
@@ -80,13 +84,84 @@ struct AVPacketDeleter{
     }
 };
 using AVPacketPtr = std::unique_ptr<AVPacket, AVPacketDeleter>;
+using AVFramePtr = make_av_ptr_type2<AVFrame, av_frame_free>;
+
+// Fixed set of AVFrames allocated once per decoder run. Frames received from libavcodec are refcounted
+// views of the decoder's internal buffer pools, so receiving into a pooled frame never allocates; a
+// FrameRef keeps its frame's buffers alive until released, independent of the next receive.
+// Decoder thread only.
+class AVFramePool {
+public:
+    constexpr static const std::size_t Capacity = 4;
+
+    class FrameRef {
+    public:
+        constexpr inline FrameRef() noexcept = default;
+        inline FrameRef(FrameRef&& other) noexcept
+            : m_pool(std::exchange(other.m_pool, nullptr)), m_index(other.m_index) {}
+        inline FrameRef& operator=(FrameRef&& other) noexcept {
+            if (this != &other) {
+                Release();
+                m_pool = std::exchange(other.m_pool, nullptr);
+                m_index = other.m_index;
+            }
+            return *this;
+        }
+        FrameRef(const FrameRef&) = delete;
+        FrameRef& operator=(const FrameRef&) = delete;
+        inline ~FrameRef() { Release(); }
+
+        inline AVFrame* get() const { return m_pool ? m_pool->m_frames[m_index].get() : nullptr; }
+        inline AVFrame* operator->() const { return get(); }
+        inline explicit operator bool() const { return m_pool != nullptr; }
+
+        inline void Release() {
+            if (m_pool == nullptr)
+                return;
+            av_frame_unref(m_pool->m_frames[m_index].get());
+            m_pool->m_inUse[m_index] = false;
+            m_pool = nullptr;
+        }
+
+    private:
+        friend class AVFramePool;
+        inline FrameRef(AVFramePool* pool, const std::size_t index) noexcept : m_pool(pool), m_index(index) {}
+
+        AVFramePool* m_pool = nullptr;
+        std::size_t  m_index = 0;
+    };
+
+    inline AVFramePool() {
+        for (auto& frame : m_frames)
+            frame.reset(av_frame_alloc());
+    }
+
+    inline bool IsValid() const {
+        return std::all_of(m_frames.begin(), m_frames.end(), [](const AVFramePtr& frame) { return frame != nullptr; });
+    }
+
+    // Empty FrameRef if every frame is held.
+    inline FrameRef Acquire() {
+        for (std::size_t index = 0; index < Capacity; ++index) {
+            if (!m_inUse[index]) {
+                m_inUse[index] = true;
+                return { this, index };
+            }
+        }
+        return {};
+    }
+
+private:
+    std::array<AVFramePtr, Capacity> m_frames{};
+    std::array<bool, Capacity>       m_inUse{};
+};
 struct NALPacket
 {
-    AVPacketPtr data;
+    ALXR::NALBuffer data;
     std::uint64_t frameIndex;
 
-    /*constexpr*/ inline NALPacket(AVPacket* p = nullptr, const std::uint64_t fi = std::uint64_t(-1)) noexcept
-        : data(p), frameIndex(fi) {}
+    /*constexpr*/ inline NALPacket(ALXR::NALBuffer&& p = {}, const std::uint64_t fi = std::uint64_t(-1)) noexcept
+        : data(std::move(p)), frameIndex(fi) {}
     /*constexpr*/ inline NALPacket(NALPacket&&) noexcept = default;
     /*constexpr*/ inline NALPacket& operator=(NALPacket&&) noexcept = default;
 
@@ -94,6 +169,27 @@ struct NALPacket
     constexpr inline NALPacket& operator=(const NALPacket&) noexcept = delete;
 };
 
+// Wraps a pooled NAL buffer as an AVBufferRef without copying, the buffer's reference
+// is handed to libav and returned to the pool once libav has finished with it.
+inline void NALBufferFree(void* /*opaque*/, std::uint8_t* data);
+inline AVBufferRef* MakeAVBufferRef(ALXR::NALBuffer&& nalBuffer)
+{
+    const auto size = static_cast<int>(nalBuffer.size());
+    const auto data = nalBuffer.data();
+    const auto slot = nalBuffer.detach();
+    if (slot == nullptr)
+        return nullptr;
+    if (const auto bufRef = av_buffer_create(data, size, &NALBufferFree, slot, AV_BUFFER_FLAG_READONLY))
+        return bufRef;
+    ALXR::NALBuffer::Adopt(slot).reset();
+    return nullptr;
+}
+
+inline void NALBufferFree(void* opaque, std::uint8_t* /*data*/)
+{
+    ALXR::NALBuffer::Adopt(reinterpret_cast<ALXR::NALBufferSlot*>(opaque)).reset();
+}
+
 inline auto AverrorToCodeStr(const int errnum)
 {
     thread_local char buf[AV_ERROR_MAX_STRING_SIZE];
@@ -140,6 +236,46 @@ constexpr inline const char* ToString(const ALXRDecoderType dtype)
     }
 }
 
+constexpr inline const char* ToString(const ALXRDecoderThreadingPolicy policy)
+{
+    switch (policy)
+    {
+    case ALXRDecoderThreadingPolicy::SliceThreading: return "slice";
+    case ALXRDecoderThreadingPolicy::FrameThreading: return "frame";
+    case ALXRDecoderThreadingPolicy::AutoThreading:  return "auto";
+    default: return "Unknown";
+    }
+}
+
+struct CPUThreadingParams
+{
+    int threadCount;
+    int threadType; // FF_THREAD_SLICE or FF_THREAD_FRAME
+};
+
+// Frame threading holds (thread_count - 1) frames inside libavcodec, AutoThreading only uses it
+// for as many threads as that delay fits in the latency budget at the stream's frame rate.
+inline CPUThreadingParams SelectCPUThreading(const ALXRDecoderConfig& config, const float refreshRate)
+{
+    const int threadCount = static_cast<int>(std::max(1u, config.cpuThreadCount));
+    switch (config.threadingPolicy)
+    {
+    case ALXRDecoderThreadingPolicy::FrameThreading:
+        return { threadCount, FF_THREAD_FRAME };
+    case ALXRDecoderThreadingPolicy::AutoThreading: {
+        if (refreshRate <= 0.0f || config.latencyBudgetMs <= 0.0f)
+            break;
+        const float frameIntervalMs = 1000.0f / refreshRate;
+        const int maxFrameThreads = 1 + static_cast<int>(config.latencyBudgetMs / frameIntervalMs);
+        const int frameThreads = std::min(threadCount, maxFrameThreads);
+        if (frameThreads > 1)
+            return { frameThreads, FF_THREAD_FRAME };
+    } break;
+    default: break;
+    }
+    return { threadCount, FF_THREAD_SLICE };
+}
+
 constexpr inline AVHWDeviceType ToAVHWDeviceType(const ALXRDecoderType dtype)
 {
     switch (dtype)
@@ -231,15 +367,26 @@ constexpr inline auto GetVideoTextureMemFuns(const ALXRDecoderType decoderType)
     }
 }
 
+// Geometry & format of decoded frames, a change mid-stream re-creates the video textures.
+struct VideoFrameDesc
+{
+    int           width = 0;
+    int           height = 0;
+    XrPixelFormat pixFmt = XrPixelFormat::Uknown;
+
+    constexpr inline bool operator==(const VideoFrameDesc&) const noexcept = default;
+};
+
 struct FFMPEGDecoderPlugin final : public IDecoderPlugin {
     
-    using AVPacketQueue = moodycamel::BlockingReaderWriterCircularBuffer<NALPacket>;
+    using AVPacketQueue = ALXR::PacketQueue<NALPacket>;
     using GraphicsPluginPtr = std::shared_ptr<IGraphicsPlugin>;
     using IOpenXrProgramPtr = std::shared_ptr<IOpenXrProgram>;
     using RustCtxPtr = std::shared_ptr<const ALXRRustCtx>;
 
     AVPacketQueue/*Ptr*/ m_avPacketQueue;
     AVPixelFormat        m_hwPixFmt = AV_PIX_FMT_NONE;
+    std::atomic<bool>    m_isRestartRequested{ false };
     
     virtual ~FFMPEGDecoderPlugin() override {}
 
@@ -250,7 +397,7 @@ struct FFMPEGDecoderPlugin final : public IDecoderPlugin {
         std::call_once(reg_devices_once, []()
         {
 #if 0 // TODO CHECK!
-            Log::Write(Log::Level::Verbose, "Registering all libav devices.");
+            ALXR_LOG_VERBOSE("Registering all libav devices.");
             avdevice_register_all();
 #endif
 #ifndef NDEBUG
@@ -266,24 +413,29 @@ struct FFMPEGDecoderPlugin final : public IDecoderPlugin {
         const std::uint64_t trackingFrameIndex
     ) override
     {
-        if (const auto pkt = av_packet_alloc()) {
-            const std::size_t packetSize = newPacketData.size();
-            if (const auto pktBuffer = static_cast<std::uint8_t*>(av_malloc(packetSize))) {
-                std::memcpy(pktBuffer, newPacketData.data(), packetSize);
-                if (av_packet_from_data(pkt, pktBuffer, static_cast<int>(packetSize)) == 0) {
-                    using namespace std::literals::chrono_literals;
-                    constexpr static const auto QueueWaitTimeout = 500ms;
-                    m_avPacketQueue.wait_enqueue_timed({ pkt, trackingFrameIndex }, QueueWaitTimeout);
-                } else av_free(pktBuffer);
-            }
-        }
-        return true;
+        if (newPacketData.empty())
+            return false;
+        return m_avPacketQueue.TryEnqueue({ ALXR::NALBuffer{ newPacketData }, trackingFrameIndex });
+    }
+
+    virtual ALXR::PacketQueueState GetQueueState() const override
+    {
+        return m_avPacketQueue.GetState();
+    }
+
+    virtual void FlushQueue() override
+    {
+        m_avPacketQueue.Flush();
+    }
+
+    virtual bool IsRestartRequested() const override
+    {
+        return m_isRestartRequested.load();
     }
 
     virtual bool Run(const IDecoderPlugin::RunCtx& ctx, IDecoderPlugin::shared_bool& isRunningToken) override
     {
         using AVCodecContextPtr = make_av_ptr_type2<AVCodecContext, avcodec_free_context>;
-        using AVFramePtr = make_av_ptr_type2<AVFrame, av_frame_free>;
         using AVBufferRefPtr = make_av_ptr_type2<AVBufferRef, av_buffer_unref>;
 
         if (!isRunningToken) {
@@ -331,14 +483,14 @@ struct FFMPEGDecoderPlugin final : public IDecoderPlugin {
                     Log::Write(Log::Level::Error, Fmt("Decoder %s does not support device type %s.\n", codecPtr->name, av_hwdevice_get_type_name(type)));
                     return false;
                 }
-                Log::Write(Log::Level::Verbose,
+                ALXR_LOG_VERBOSE(
                     Fmt("config, type %d with methods %d (AdHOC | HW_DEV: %d), pix fmt %d (mediacodec is: %d)",
                         config->device_type, (AV_CODEC_HW_CONFIG_METHOD_AD_HOC | AV_CODEC_HW_CONFIG_METHOD_HW_DEVICE_CTX), config->methods, config->pix_fmt, AVPixelFormat::AV_PIX_FMT_MEDIACODEC));
                 if (config->methods & (AV_CODEC_HW_CONFIG_METHOD_HW_DEVICE_CTX | AV_CODEC_HW_CONFIG_METHOD_HW_FRAMES_CTX) && //config->methods & AV_CODEC_HW_CONFIG_METHOD_HW_DEVICE_CTX &&
                     config->device_type == type) {
                     //hwconfig = config;
                     m_hwPixFmt = config->pix_fmt;
-                    Log::Write(Log::Level::Verbose, Fmt("HWConfig found, type-id:%d method-id: %d, pixfmt-id: %d", type, config->methods, m_hwPixFmt));
+                    ALXR_LOG_VERBOSE(Fmt("HWConfig found, type-id:%d method-id: %d, pixfmt-id: %d", type, config->methods, m_hwPixFmt));
                     break;
                 }
             }
@@ -361,7 +513,18 @@ struct FFMPEGDecoderPlugin final : public IDecoderPlugin {
             codecCtx->thread_count = 1;
         }
         else {
-            codecCtx->thread_count = std::max(1u, ctx.config.cpuThreadCount);
+            const auto threading = SelectCPUThreading(ctx.config, ctx.refreshRate);
+            codecCtx->thread_count = threading.threadCount;
+            codecCtx->thread_type = threading.threadType;
+            // low-delay also stops libavcodec from silently falling back to frame threading.
+            if (threading.threadType == FF_THREAD_SLICE)
+                codecCtx->flags |= AV_CODEC_FLAG_LOW_DELAY;
+            Log::Write(Log::Level::Info, Fmt("Decoder threading policy: %s, thread type: %s",
+                ToString(ctx.config.threadingPolicy), threading.threadType == FF_THREAD_FRAME ? "frame" : "slice"));
+            // libavcodec's worker threads are created in avcodec_open2 & inherit the affinity/scheduling policy.
+            ALXR::SetCurrentThreadAffinity(ctx.config.cpuAffinityMask);
+            if (ctx.config.realtimePriority)
+                ALXR::SetCurrentThreadRealtimePriority();
         }
         Log::Write(Log::Level::Info, Fmt("Decoder thread count: %d", codecCtx->thread_count));
 
@@ -369,7 +532,7 @@ struct FFMPEGDecoderPlugin final : public IDecoderPlugin {
 #ifdef XR_USE_PLATFORM_WIN32
         if (AV_HWDEVICE_TYPE_D3D11VA == type)
         {
-            Log::Write(Log::Level::Verbose, "Init AV_HWDEVICE_TYPE_D3D11VA");
+            ALXR_LOG_VERBOSE("Init AV_HWDEVICE_TYPE_D3D11VA");
             hw_device_ctx.reset(av_hwdevice_ctx_alloc(type));
             if (hw_device_ctx == nullptr) {
                 Log::Write(Log::Level::Error, "Failed to create specified HW device.\n");
@@ -407,9 +570,16 @@ struct FFMPEGDecoderPlugin final : public IDecoderPlugin {
             return false;
         }
 
+        const AVPacketPtr pkt{ av_packet_alloc() };
+        if (pkt == nullptr) {
+            Log::Write(Log::Level::Error, "Failed to allocate avPacket.");
+            return false;
+        }
+
+        // hw-frames are transferred into swFrame, its buffers are reused from frame to frame.
         const AVFramePtr swFrame{ av_frame_alloc() };
-        const AVFramePtr hwFrame{ av_frame_alloc() };
-        if (swFrame == nullptr || hwFrame == nullptr) {
+        AVFramePool framePool{};
+        if (swFrame == nullptr || !framePool.IsValid()) {
             Log::Write(Log::Level::Error, "Failed to allocate avFrames.");
             return false;
         }
@@ -420,59 +590,114 @@ struct FFMPEGDecoderPlugin final : public IDecoderPlugin {
         using namespace std::literals::chrono_literals;
         static constexpr const auto QueueWaitTimeout = 500ms;
         std::size_t planeCount = 0;
-        std::once_flag once_flag{};
+        VideoFrameDesc videoDesc{};
+        const auto selectedCodec = static_cast<ALVR_CODEC>(ctx.config.codecType);
+        ALXR::ParameterSetCache paramSets{ selectedCodec };
+        bool hasDecoderConfig = false;
         while (isRunningToken)
         {
             NALPacket nalPacket{};
-            if (!m_avPacketQueue.wait_dequeue_timed(nalPacket, QueueWaitTimeout))
+            if (!m_avPacketQueue.WaitDequeue(nalPacket, QueueWaitTimeout))
                 continue;
 
-            assert(nalPacket.data != nullptr);
-            const auto& pkt = nalPacket.data;
+            assert(!nalPacket.data.empty());
+            const auto frameInfo = ALXR::ParseNALFrame(nalPacket.data.span(), selectedCodec, &paramSets);
+            if (frameInfo.hasParameterSets) {
+                hasDecoderConfig = true;
+            } else if (!hasDecoderConfig) {
+                // nothing before a key frame is decodable, one without in-band parameter sets is sent
+                // with the cached ones prepended so the decoder can start from it.
+                if (!frameInfo.isKeyFrame || !paramSets.IsComplete())
+                    continue;
+                const auto csd = paramSets.Serialize();
+                const auto frameData = nalPacket.data.span();
+                if (av_new_packet(pkt.get(), static_cast<int>(csd.size() + frameData.size())) < 0) {
+                    Log::Write(Log::Level::Warning, "Failed to allocate key frame packet, packet dropped.");
+                    m_avPacketQueue.OnPacketLost();
+                    continue;
+                }
+                std::memcpy(pkt->data, csd.data(), csd.size());
+                std::memcpy(pkt->data + csd.size(), frameData.data(), frameData.size());
+                hasDecoderConfig = true;
+                ALXR_LOG_VERBOSE(Fmt("Decoder started from cached parameter sets (%zu bytes).", csd.size()));
+            }
 
-            using namespace std::chrono;
-            using ClockType = XrSteadyClock;
-            static_assert(ClockType::is_steady);
-            using microseconds64 = duration<std::uint64_t, std::chrono::seconds::period>;
-            pkt->pts = duration_cast<microseconds64>(ClockType::now().time_since_epoch()).count();
+            if (pkt->buf == nullptr) { // unless already holding the cached parameter sets + key frame.
+                pkt->size = static_cast<int>(nalPacket.data.size());
+                pkt->data = nalPacket.data.data();
+                pkt->buf  = MakeAVBufferRef(std::move(nalPacket.data));
+                if (pkt->buf == nullptr) {
+                    Log::Write(Log::Level::Warning, "Failed to wrap NAL buffer as AVBufferRef, packet dropped.");
+                    av_packet_unref(pkt.get());
+                    m_avPacketQueue.OnPacketLost();
+                    continue;
+                }
+            }
+
+            // frame threading returns an earlier packet's frame, the pts carries its tracking frame index through.
+            pkt->pts = static_cast<std::int64_t>(nalPacket.frameIndex);
 
+            auto& frameTracer = ALXR::FrameTracer::Instance();
             LatencyCollector::Instance().decoderInput(nalPacket.frameIndex);
-            const auto result = decode_packet(pkt.get(), codecCtx.get(), hwFrame.get());
-            LatencyCollector::Instance().decoderOutput(nalPacket.frameIndex);
-            //av_packet_unref(pkt.get());
+            frameTracer.Record(ALXR::FrameTraceEvent::DecoderInput, nalPacket.frameIndex);
+            AVFramePool::FrameRef hwFrame{};
+            const auto result = decode_packet(pkt.get(), codecCtx.get(), framePool, nalPacket.frameIndex, hwFrame);
+            av_packet_unref(pkt.get());
             if (result < 0)
             {
                 LogLibAV(Log::Level::Warning, result, "Failed to decode packet");
+                m_avPacketQueue.OnPacketLost();
                 continue;
             }
+            if (!hwFrame)
+                continue; // frame threading is still filling its pipeline.
+            const std::uint64_t frameIndex = FrameIndex(*hwFrame.get(), nalPacket.frameIndex);
 
-            const auto& avFrame = [&/*, isBTS = isBufferInteropSupported*/]() -> const AVFramePtr& {
+            AVFrame* const avFrame = [&/*, isBTS = isBufferInteropSupported*/]() -> AVFrame* {
                 if (isBufferInteropSupported || type == AV_HWDEVICE_TYPE_NONE)
-                    return hwFrame;
+                    return hwFrame.get();
                 CHECK(hwFrame->format == m_hwPixFmt);
+                // the transfer reuses swFrame's buffers, which only fit frames of the same size & format.
+                const auto hwFramesCtx = reinterpret_cast<const AVHWFramesContext*>(hwFrame->hw_frames_ctx->data);
+                if (swFrame->width != hwFrame->width || swFrame->height != hwFrame->height || swFrame->format != hwFramesCtx->sw_format)
+                    av_frame_unref(swFrame.get());
                 CHECK((av_hwframe_transfer_data(swFrame.get(), hwFrame.get(), 0) == 0));
-                return swFrame;
+                return swFrame.get();
             }();
             assert(avFrame != nullptr);
 
-            std::call_once(once_flag, [&/*, cvt = CreateVideoTextures*/]()
+            const VideoFrameDesc frameDesc {
+                .width = avFrame->width,
+                .height = avFrame->height,
+                .pixFmt = GetXrPixelFormat(*avFrame, *codecCtx)
+            };
+            if (frameDesc != videoDesc)
             {
-                Log::Write(Log::Level::Verbose, Fmt("Creating video textures, width=%d, height=%d, pitch-0=%d, pitch-1=%d, type=%d sw-type=%d",
+                const bool isFirstFrame = videoDesc.pixFmt == XrPixelFormat::Uknown;
+                if (!isFirstFrame && isBufferInteropSupported) {
+                    // interop textures are shared with the graphics API & can not be re-created while it
+                    // may be rendering from them, the engine restarts the decoder thread (see IsRestartRequested).
+                    Log::Write(Log::Level::Warning, Fmt("%s video textures can not change size/format mid-stream, restarting the decoder.", ToString(ctx.decoderType)));
+                    m_isRestartRequested.store(true);
+                    break;
+                }
+                ALXR_LOG_VERBOSE(Fmt("%s video textures, width=%d, height=%d, pitch-0=%d, pitch-1=%d, type=%d sw-type=%d",
+                    isFirstFrame ? "Creating" : "Stream changed, re-creating",
                     avFrame->width, avFrame->height, avFrame->linesize[0], avFrame->linesize[1], avFrame->format, codecCtx->sw_pix_fmt));
-                const auto pixFmt = GetXrPixelFormat(*avFrame, *codecCtx);
-                CHECK(pixFmt != XrPixelFormat::Uknown);
-                planeCount = PlaneCount(pixFmt);
+                CHECK(frameDesc.pixFmt != XrPixelFormat::Uknown);
+                planeCount = PlaneCount(frameDesc.pixFmt);
                 assert(planeCount > 0);
-                Log::Write(Log::Level::Verbose, Fmt("Pixel Format: %lu", pixFmt));
-                std::invoke(CreateVideoTextures, graphicsPluginPtr, avFrame->width, avFrame->height, pixFmt);
+                ALXR_LOG_VERBOSE(Fmt("Pixel Format: %lu", frameDesc.pixFmt));
+                std::invoke(CreateVideoTextures, graphicsPluginPtr, avFrame->width, avFrame->height, frameDesc.pixFmt);
+                videoDesc = frameDesc;
 
-                if (const auto rustCtx = ctx.rustCtx) {
+                if (const auto rustCtx = ctx.rustCtx; isFirstFrame && rustCtx) {
                     rustCtx->setWaitingNextIDR(false);
                     if (const auto programPtr = ctx.programPtr) {
                         programPtr->SetRenderMode(IOpenXrProgram::RenderMode::VideoStream);
                     }
                 }
-            });
+            }
 
             const std::size_t uvHeight = static_cast<std::size_t>(avFrame->height / 2);
             IGraphicsPlugin::YUVBuffer buffer{
@@ -486,7 +711,7 @@ struct FFMPEGDecoderPlugin final : public IDecoderPlugin {
                     .pitch = static_cast<std::size_t>(avFrame->linesize[1]),
                     .height = uvHeight
                 },
-                .frameIndex = nalPacket.frameIndex
+                .frameIndex = frameIndex
             };
             if (planeCount > 2) {
                 buffer.chroma2 = {
@@ -495,125 +720,77 @@ struct FFMPEGDecoderPlugin final : public IDecoderPlugin {
                     .height = uvHeight
                 };
             }
+            frameTracer.Record(ALXR::FrameTraceEvent::UploadBegin, frameIndex);
             std::invoke(UpdateVideoTextures, graphicsPluginPtr, buffer);
+            frameTracer.Record(ALXR::FrameTraceEvent::UploadEnd, frameIndex);
         }
+        m_avPacketQueue.LogStats("FFmpeg");
         return true;
     }
 
-#if 1
-    inline int decode_packet(AVPacket* pPacket, AVCodecContext* pCodecContext, AVFrame* hwFrame)
+    constexpr static inline std::uint64_t FrameIndex(const AVFrame& frame, const std::uint64_t fallbackIndex)
+    {
+        return frame.pts == AV_NOPTS_VALUE ? fallbackIndex : static_cast<std::uint64_t>(frame.pts);
+    }
+
+    // Sends pPacket then drains every frame the decoder has ready, newestFrame is left holding the most
+    // recent one & older frames of the same burst are released (counted as dropped) right away instead
+    // of waiting a packet each. newestFrame is left empty if the decoder has no frame ready yet, a
+    // negative result means pPacket was not decoded.
+    int decode_packet
+    (
+        AVPacket* pPacket,
+        AVCodecContext* pCodecContext,
+        AVFramePool& framePool,
+        const std::uint64_t packetFrameIndex,
+        /*[out]*/ AVFramePool::FrameRef& newestFrame
+    )
     {
         int response = avcodec_send_packet(pCodecContext, pPacket);
+        if (response == AVERROR(EAGAIN)) {
+            // the decoder's output is full, it only takes the packet once its frames are received.
+            response = receive_frames(pCodecContext, framePool, packetFrameIndex, newestFrame);
+            if (response < 0)
+                return response;
+            response = avcodec_send_packet(pCodecContext, pPacket);
+        }
         if (response < 0)
             return response;
+        return receive_frames(pCodecContext, framePool, packetFrameIndex, newestFrame);
+    }
 
-        while (response >= 0)
+    // Receives every frame the decoder has ready into newestFrame, see decode_packet.
+    int receive_frames
+    (
+        AVCodecContext* pCodecContext,
+        AVFramePool& framePool,
+        const std::uint64_t packetFrameIndex,
+        /*[out]*/ AVFramePool::FrameRef& newestFrame
+    )
+    {
+        for (;;)
         {
-            response = avcodec_receive_frame(pCodecContext, hwFrame);
-            if (response == AVERROR(EAGAIN) || response == AVERROR_EOF) {
-                break;
-            }
-            else if (response < 0) {
-                return response;
-            }
-            if (response >= 0)
-            {
-#if 0
-                //pFrame = hwFrame;
-                size_t planeCount = 0;
-                for (; planeCount < AV_NUM_DATA_POINTERS; ++planeCount) {
-                    if (hwFrame->data[planeCount] == nullptr)
-                        break;
-                }
-                Log::Write(Log::Level::Info, Fmt(
-                    "Frame %d (type=%c, size=%d bytes, format=%d, planes=%zu, pitch1=%d,pitch2=%d width=%d, height=%d) pts %d key_frame %d [DTS %d]",
-                    pCodecContext->frame_number,
-                    av_get_picture_type_char(hwFrame->pict_type),
-                    hwFrame->pkt_size,
-                    pCodecContext->sw_pix_fmt, //pFrame->format,
-                    planeCount,
-                    hwFrame->linesize[0], hwFrame->linesize[1],
-                    hwFrame->width,
-                    hwFrame->height,
-                    hwFrame->pts,
-                    hwFrame->key_frame,
-                    hwFrame->coded_picture_number
-                ));
-#endif
+            // at most newestFrame & this one are held.
+            auto frame = framePool.Acquire();
+            assert(frame);
+            const int response = avcodec_receive_frame(pCodecContext, frame.get());
+            if (response == AVERROR(EAGAIN) || response == AVERROR_EOF)
                 return 0;
-            }
-        }
-        return -1;
-    }
-#else
-    int decode_packet(AVPacket* packet, AVCodecContext* avctx, AVFrame* sw_frame, AVFrame* frame)
-    {
-        int ret = avcodec_send_packet(avctx, packet);
-        if (ret < 0) {
-            //fprintf(stderr, "Error during decoding\n");
-            return ret;
-        }
-
-        while (true) {
-            //if (!(frame = av_frame_alloc()) || !(sw_frame = av_frame_alloc())) {
-            //    fprintf(stderr, "Can not alloc frame\n");
-            //    ret = AVERROR(ENOMEM);
-            //    goto fail;
-            //}
-
-            ret = avcodec_receive_frame(avctx, frame);
-            if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
-                //av_frame_free(&frame);
-                //av_frame_free(&sw_frame);
-                return ret;
-            }
-            else if (ret < 0) {
-                //fprintf(stderr, "Error while decoding\n");
-                goto fail;
-            }
+            if (response < 0)
+                return response;
 
-            if (frame->format == m_hwPixFmt) {
-                /* retrieve data from GPU to CPU */
-                if ((ret = av_hwframe_transfer_data(sw_frame, frame, 0)) < 0) {
-                    //fprintf(stderr, "Error transferring the data to system memory\n");
-                    goto fail;
-                }
-                //tmp_frame = sw_frame;
+            const std::uint64_t frameIndex = FrameIndex(*frame.get(), packetFrameIndex);
+            m_avPacketQueue.OnFrameDecoded();
+            LatencyCollector::Instance().decoderOutput(frameIndex);
+            ALXR::FrameTracer::Instance().Record(ALXR::FrameTraceEvent::DecoderOutput, frameIndex);
+            if (newestFrame) {
+                auto& latencyManager = LatencyManager::Instance();
+                latencyManager.OnVideoFrameDecoded();
+                latencyManager.OnVideoFrameDropped();
             }
-            else
-                //tmp_frame = frame;
-
-            //size = av_image_get_buffer_size(tmp_frame->format, tmp_frame->width,
-            //    tmp_frame->height, 1);
-            //buffer = av_malloc(size);
-            //if (!buffer) {
-            //    fprintf(stderr, "Can not alloc buffer\n");
-            //    ret = AVERROR(ENOMEM);
-            //    goto fail;
-            //}
-            //ret = av_image_copy_to_buffer(buffer, size,
-            //    (const uint8_t* const*)tmp_frame->data,
-            //    (const int*)tmp_frame->linesize, tmp_frame->format,
-            //    tmp_frame->width, tmp_frame->height, 1);
-            //if (ret < 0) {
-            //    fprintf(stderr, "Can not copy image to buffer\n");
-            //    goto fail;
-            //}
-
-            //if ((ret = fwrite(buffer, 1, size, output_file)) < 0) {
-            //    fprintf(stderr, "Failed to dump raw data.\n");
-            //    goto fail;
-            //}
-
-            fail:
-            //av_frame_free(&frame);
-            //av_frame_free(&sw_frame);
-            //av_freep(&buffer);
-            if (ret < 0)
-                return ret;
+            newestFrame = std::move(frame);
         }
     }
-#endif
 
     static AVPixelFormat get_hw_format(AVCodecContext* avctx, const AVPixelFormat* pix_fmts)
     {
@@ -29,6 +29,7 @@
 #include "openxr_program.h"
 #include "latency_manager.h"
 #include "timing.h"
+#include "frame_trace.h"
 
 namespace
 {;
@@ -71,20 +72,23 @@ public:
     }
 };
 
-using EncodedFrame = std::vector<std::uint8_t>;
 struct NALPacket
 {
-    EncodedFrame data;
+    // data is a view into buffer, config & frame packets split from the same
+    // encoded frame share one (pooled) buffer.
+    ALXR::NALBuffer buffer;
+    ConstPacketType data;
     std::uint64_t frameIndex;
 
-    /*constexpr*/ inline NALPacket(const ConstPacketType& p, const std::uint64_t newFrameIdx) noexcept //, const ALVR_CODEC codec)
-        : data{ p.begin(), p.end() },
+    /*constexpr*/ inline NALPacket(const ALXR::NALBuffer& b, const ConstPacketType& p, const std::uint64_t newFrameIdx) noexcept //, const ALVR_CODEC codec)
+        : buffer{ b },
+        data{ p },
         frameIndex(newFrameIdx)
     {}
 
     constexpr inline NalType nal_type(const ALXRCodecType codec) const
     {
-        return get_nal_type({ data.data(), data.size() }, static_cast<ALVR_CODEC>(codec));
+        return get_nal_type(data, static_cast<ALVR_CODEC>(codec));
     }
 
     constexpr inline bool is_config(const ALXRCodecType codec) const
@@ -240,15 +244,18 @@ struct AMediaCodecDeleter {
     }
 };
 using AMediaCodecPtr = std::shared_ptr<AMediaCodec>;
+using NALPacketQueue = ALXR::PacketQueue<NALPacket>;
 
 class DecoderOutputThread
 {
     std::thread m_thread;
     FrameIndexMap& m_frameIndexMap;
+    NALPacketQueue& m_packetQueue;
     std::atomic<bool> m_isRunning{ false };
 public:
-    inline DecoderOutputThread(FrameIndexMap& frameMapRef)
-    : m_frameIndexMap(frameMapRef)
+    inline DecoderOutputThread(FrameIndexMap& frameMapRef, NALPacketQueue& packetQueueRef)
+    : m_frameIndexMap(frameMapRef),
+      m_packetQueue(packetQueueRef)
     {}
 
     inline DecoderOutputThread(const DecoderOutputThread&) noexcept = delete;
@@ -316,8 +323,10 @@ public:
             {
                 const auto ptsUs = static_cast<std::uint64_t>(buffInfo.presentationTimeUs);
                 const auto frameIndex = m_frameIndexMap.get(ptsUs);
+                m_packetQueue.OnFrameDecoded();
                 if (frameIndex != FrameIndexMap::NullIndex) {
                     LatencyCollector::Instance().decoderOutput(frameIndex);
+                    ALXR::FrameTracer::Instance().Record(ALXR::FrameTraceEvent::DecoderOutput, frameIndex);
                 }
                 AMediaCodec_releaseOutputBuffer(codec.get(), outputBufferId, true);
             }
@@ -336,7 +345,7 @@ public:
 
 struct MediaCodecDecoderPlugin final : IDecoderPlugin
 {
-    using AVPacketQueue = moodycamel::BlockingReaderWriterCircularBuffer<NALPacket>;
+    using AVPacketQueue = NALPacketQueue;
     using GraphicsPluginPtr = std::shared_ptr<IGraphicsPlugin>;
 
     AVPacketQueue           m_packetQueue { 360 };
@@ -352,24 +361,35 @@ struct MediaCodecDecoderPlugin final : IDecoderPlugin
 		const std::uint64_t trackingFrameIndex
 	) override
     {
-        using namespace std::literals::chrono_literals;
-        constexpr static const auto QueueWaitTimeout = 500ms;
-        
         const auto selectedCodec = m_selectedCodecType.load();
-        const auto vpssps = find_vpssps(newPacketData, selectedCodec);
+        const auto packetData = newPacketData.span();
+        const auto vpssps = find_vpssps(packetData, selectedCodec);
         if (is_config(vpssps, selectedCodec))
         {
-            NALPacket configPacket{ vpssps, trackingFrameIndex };
-            const auto frameData = newPacketData.subspan(vpssps.size(), newPacketData.size() - vpssps.size());
-            NALPacket framePacket{ frameData, trackingFrameIndex };
-            m_packetQueue.wait_enqueue_timed(std::move(configPacket), QueueWaitTimeout);
-            m_packetQueue.wait_enqueue_timed(std::move(framePacket), QueueWaitTimeout);
+            NALPacket configPacket{ newPacketData, vpssps, trackingFrameIndex };
+            const auto frameData = packetData.subspan(vpssps.size(), packetData.size() - vpssps.size());
+            NALPacket framePacket{ newPacketData, frameData, trackingFrameIndex };
+            // a frame queued without its parameter sets, or the reverse, can not be decoded.
+            return m_packetQueue.TryEnqueue(std::move(configPacket), std::move(framePacket));
         }
-        else
-            m_packetQueue.wait_enqueue_timed({ newPacketData, trackingFrameIndex }, QueueWaitTimeout);
-		return true;
+        return m_packetQueue.TryEnqueue({ newPacketData, packetData, trackingFrameIndex });
 	}
 
+    virtual ALXR::PacketQueueState GetQueueState() const override
+    {
+        return m_packetQueue.GetState();
+    }
+
+    virtual void FlushQueue() override
+    {
+        m_packetQueue.Flush();
+    }
+
+    virtual bool IsRestartRequested() const override
+    {
+        return false;
+    }
+
     struct AMediaFormatDeleter {
         void operator()(AMediaFormat* fmt) const {
             if (fmt == nullptr)
@@ -382,7 +402,7 @@ struct MediaCodecDecoderPlugin final : IDecoderPlugin
     (
         const char* const mimeType,
         const OptionMap& optionMap,
-        const EncodedFrame& csd0,
+        const ConstPacketType& csd0,
         const bool realtimePriority = true
     )
     {
@@ -432,15 +452,23 @@ struct MediaCodecDecoderPlugin final : IDecoderPlugin
 
         AMediaCodecPtr codec{ nullptr };
         AMediaFormatPtr format{ nullptr };        
-        DecoderOutputThread outputThread{ imgListener.frameIndexMap };
+        const auto selectedCodec = static_cast<ALVR_CODEC>(ctx.config.codecType);
+        ALXR::ParameterSetCache paramSets{ selectedCodec };
+        DecoderOutputThread outputThread{ imgListener.frameIndexMap, m_packetQueue };
         static constexpr const std::int64_t QueueWaitTimeout = 5e+5;
         while (isRunningToken)
         {
             NALPacket packet{};
-            if (!m_packetQueue.wait_dequeue_timed(packet, QueueWaitTimeout))
+            if (!m_packetQueue.WaitDequeue(packet, std::chrono::microseconds{ QueueWaitTimeout }))
                 continue;
 
-            if (codec == nullptr && packet.is_config(ctx.config.codecType))
+            const bool isConfigPacket = packet.is_config(ctx.config.codecType);
+            if (isConfigPacket)
+                ALXR::ParseNALFrame(packet.data, selectedCodec, &paramSets);
+
+            // Spawned from the cached parameter sets when complete, a key frame whose in-band
+            // parameter sets were lost can then still start the decoder.
+            if (codec == nullptr && (isConfigPacket || (paramSets.IsComplete() && packet.is_idr(ctx.config.codecType))))
             {
                 Log::Write(Log::Level::Info, "Spawning decoder...");
                 const char* const mimeType = ctx.config.codecType == ALXRCodecType::HEVC_CODEC ? "video/hevc" : "video/avc";
@@ -458,7 +486,9 @@ struct MediaCodecDecoderPlugin final : IDecoderPlugin
                     AMediaCodec_releaseName(codec.get(), codecName);
                 }
 
-                format = MakeMediaFormat(mimeType, ctx.optionMap, packet.data, ctx.config.realtimePriority);
+                const auto cachedCsd = paramSets.IsComplete() ? paramSets.Serialize() : std::vector<std::uint8_t>{};
+                const ConstPacketType csd0 = cachedCsd.empty() ? packet.data : ConstPacketType{ cachedCsd };
+                format = MakeMediaFormat(mimeType, ctx.optionMap, csd0, ctx.config.realtimePriority);
                 assert(format != nullptr);
 
                 ANativeWindow* const surface_handle = imgListener.GetWindow();
@@ -488,7 +518,8 @@ struct MediaCodecDecoderPlugin final : IDecoderPlugin
                     break;
                 }
                 Log::Write(Log::Level::Info, "Finished constructing and starting decoder...");
-                continue;
+                if (isConfigPacket)
+                    continue;
             }
 
             if (codec == nullptr)
@@ -497,7 +528,8 @@ struct MediaCodecDecoderPlugin final : IDecoderPlugin
 
             while (isRunningToken)
             {
-                if (const auto inputBufferId = AMediaCodec_dequeueInputBuffer(codec.get(), QueueWaitTimeout))
+                const auto inputBufferId = AMediaCodec_dequeueInputBuffer(codec.get(), QueueWaitTimeout);
+                if (inputBufferId >= 0)
                 {
                     const auto& packet_data = packet.data;
                     if (packet.is_idr(ctx.config.codecType)) {
@@ -506,9 +538,9 @@ struct MediaCodecDecoderPlugin final : IDecoderPlugin
                             //Log::Write(Log::Level::Verbose, "Finished waiting for next IDR.");
                         }
                     }
-                    const bool is_config_packet = packet.is_config(ctx.config.codecType);
-                    if (!is_config_packet) {
+                    if (!isConfigPacket) {
                         LatencyCollector::Instance().decoderInput(packet.frameIndex);
+                        ALXR::FrameTracer::Instance().Record(ALXR::FrameTraceEvent::DecoderInput, packet.frameIndex);
                     }
                     
                     std::size_t inBuffSize = 0;
@@ -522,23 +554,31 @@ struct MediaCodecDecoderPlugin final : IDecoderPlugin
                     static_assert(ClockType::is_steady);
                     using microseconds64 = duration<std::uint64_t, microseconds::period>;
 
-                    const auto pts = is_config_packet ? 0 : duration_cast<microseconds64>(ClockType::now().time_since_epoch()).count();
-                    const std::uint32_t flags = is_config_packet ? AMEDIACODEC_BUFFER_FLAG_CODEC_CONFIG : 0;
-                    if (!is_config_packet) {
+                    const auto pts = isConfigPacket ? 0 : duration_cast<microseconds64>(ClockType::now().time_since_epoch()).count();
+                    const std::uint32_t flags = isConfigPacket ? AMEDIACODEC_BUFFER_FLAG_CODEC_CONFIG : 0;
+                    if (!isConfigPacket) {
                         imgListener.frameIndexMap.set(pts, packet.frameIndex);
                     }
 
                     const auto result = AMediaCodec_queueInputBuffer(codec.get(), inputBufferId, 0, size, pts, flags);
                     if (result != AMEDIA_OK) {
                         Log::Write(Log::Level::Warning, Fmt("AMediaCodec_queueInputBuffer, error-code %d: ", (int)result));
+                        m_packetQueue.OnPacketLost();
                     }
                     break;
                 }
-                else Log::Write(Log::Level::Warning, Fmt("Waiting for decoder input buffer timed out after %f seconds, retrying...", QueueWaitTimeout * 1e-6f));
+                else if (inputBufferId == AMEDIACODEC_INFO_TRY_AGAIN_LATER)
+                    Log::Write(Log::Level::Warning, Fmt("Waiting for decoder input buffer timed out after %f seconds, retrying...", QueueWaitTimeout * 1e-6f));
+                else {
+                    Log::Write(Log::Level::Warning, Fmt("AMediaCodec_dequeueInputBuffer, error-code %d", (int)inputBufferId));
+                    m_packetQueue.OnPacketLost();
+                    break;
+                }
             }
         }
 
         outputThread.Stop();
+        m_packetQueue.LogStats("MediaCodec");
         Log::Write(Log::Level::Info, "Decoder thread exiting...");
         if (codec != nullptr) {
             CHECK(AMediaCodec_stop(codec.get()) == AMEDIA_OK);
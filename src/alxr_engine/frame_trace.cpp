@@ -0,0 +1,295 @@
+#include "pch.h"
+#include "common.h"
+#include "frame_trace.h"
+
+#include <fstream>
+#include <unordered_map>
+
+namespace ALXR {
+namespace {
+
+struct TraceRecord {
+    std::uint64_t frameIndex;
+    std::uint64_t timestampUs;
+    std::uint16_t event;
+    std::uint16_t reserved0;
+    std::uint32_t reserved1;
+};
+static_assert(sizeof(TraceRecord) == 24);
+
+struct BinaryTraceHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t recordCount;
+};
+constexpr const std::uint32_t BinaryTraceMagic = 0x54465841; // "AXFT"
+constexpr const std::uint32_t BinaryTraceVersion = 1;
+
+// Chrome trace lanes, the begin/end event pair rendered as a span on each lane.
+struct TraceStage {
+    const char*     name;
+    FrameTraceEvent begin;
+    FrameTraceEvent end;
+};
+constexpr const std::array<TraceStage, 4> TraceStages {
+    TraceStage { "network", FrameTraceEvent::FirstPacket, FrameTraceEvent::LastPacket },
+    TraceStage { "decode",  FrameTraceEvent::DecoderInput, FrameTraceEvent::DecoderOutput },
+    TraceStage { "upload",  FrameTraceEvent::UploadBegin, FrameTraceEvent::UploadEnd },
+    TraceStage { "render",  FrameTraceEvent::BeginFrame, FrameTraceEvent::EndFrame },
+};
+
+constexpr inline std::size_t StageLane(const FrameTraceEvent event) {
+    switch (event) {
+    case FrameTraceEvent::FirstPacket:
+    case FrameTraceEvent::LastPacket:
+    case FrameTraceEvent::FecReconstructed: return 0;
+    case FrameTraceEvent::DecoderInput:
+    case FrameTraceEvent::DecoderOutput: return 1;
+    case FrameTraceEvent::UploadBegin:
+    case FrameTraceEvent::UploadEnd: return 2;
+    default: return 3;
+    }
+}
+
+}
+
+struct FrameTracer::Slot {
+    std::atomic<std::uint64_t> sequence{ 0 }; // odd while being written, 0 if never written.
+    std::atomic<std::uint64_t> frameIndex{ 0 };
+    std::atomic<std::uint64_t> timestampUs{ 0 };
+    std::atomic<std::uint16_t> event{ 0 };
+};
+
+const char* ToString(const FrameTraceEvent event) {
+    switch (event) {
+    case FrameTraceEvent::FirstPacket:      return "FirstPacket";
+    case FrameTraceEvent::LastPacket:       return "LastPacket";
+    case FrameTraceEvent::FecReconstructed: return "FecReconstructed";
+    case FrameTraceEvent::DecoderInput:     return "DecoderInput";
+    case FrameTraceEvent::DecoderOutput:    return "DecoderOutput";
+    case FrameTraceEvent::UploadBegin:      return "UploadBegin";
+    case FrameTraceEvent::UploadEnd:        return "UploadEnd";
+    case FrameTraceEvent::WaitFrame:        return "WaitFrame";
+    case FrameTraceEvent::BeginFrame:       return "BeginFrame";
+    case FrameTraceEvent::EndFrame:         return "EndFrame";
+    default: return "Unknown";
+    }
+}
+
+FrameTracer& FrameTracer::Instance() {
+    static FrameTracer instance{};
+    return instance;
+}
+
+void FrameTracer::SetEnabled(const bool enable) {
+    if (enable) {
+        std::call_once(m_slotsAllocated, [this]() {
+            m_slotsStorage = std::make_unique<Slot[]>(Capacity);
+            m_slots.store(m_slotsStorage.get(), std::memory_order_release);
+        });
+    }
+    m_enabled.store(enable, std::memory_order_release);
+    Log::Write(Log::Level::Info, Fmt("Frame tracing %s.", enable ? "enabled" : "disabled"));
+}
+
+void FrameTracer::Push(const FrameTraceEvent event, const std::uint64_t frameIndex, const std::uint64_t timestampUs) {
+    Slot* const slots = m_slots.load(std::memory_order_acquire);
+    if (slots == nullptr)
+        return;
+    const std::uint64_t pos = m_writePos.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots[pos & (Capacity - 1)];
+    slot.sequence.store(pos * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.frameIndex.store(frameIndex, std::memory_order_relaxed);
+    slot.timestampUs.store(timestampUs, std::memory_order_relaxed);
+    slot.event.store(static_cast<std::uint16_t>(event), std::memory_order_relaxed);
+    slot.sequence.store(pos * 2 + 2, std::memory_order_release);
+}
+
+namespace {
+// Consistent copy of the recorded events, oldest first. Slots being overwritten are skipped.
+template < typename Slot >
+std::vector<TraceRecord> Snapshot(const Slot* slots, const std::size_t capacity) {
+    std::vector<TraceRecord> records;
+    if (slots == nullptr)
+        return records;
+    records.reserve(capacity);
+    for (std::size_t index = 0; index < capacity; ++index) {
+        const Slot& slot = slots[index];
+        const std::uint64_t seq0 = slot.sequence.load(std::memory_order_acquire);
+        if (seq0 == 0 || (seq0 & 1) != 0)
+            continue;
+        const TraceRecord record {
+            .frameIndex = slot.frameIndex.load(std::memory_order_relaxed),
+            .timestampUs = slot.timestampUs.load(std::memory_order_relaxed),
+            .event = slot.event.load(std::memory_order_relaxed),
+            .reserved0 = 0,
+            .reserved1 = 0
+        };
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != seq0)
+            continue;
+        records.push_back(record);
+    }
+    std::stable_sort(records.begin(), records.end(), [](const TraceRecord& lhs, const TraceRecord& rhs) {
+        return lhs.timestampUs < rhs.timestampUs;
+    });
+    return records;
+}
+}
+
+bool FrameTracer::WriteBinary(const std::filesystem::path& filePath) const {
+    const auto records = Snapshot(m_slots.load(std::memory_order_acquire), Capacity);
+    std::ofstream outFile(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    const BinaryTraceHeader header {
+        .magic = BinaryTraceMagic,
+        .version = BinaryTraceVersion,
+        .recordCount = records.size()
+    };
+    outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    outFile.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(TraceRecord));
+    if (!outFile) {
+        Log::Write(Log::Level::Warning, Fmt("Failed to write frame trace \"%s\"", filePath.string().c_str()));
+        return false;
+    }
+    Log::Write(Log::Level::Info, Fmt("Frame trace written to \"%s\", %zu events.", filePath.string().c_str(), records.size()));
+    return true;
+}
+
+bool FrameTracer::WriteChromeTrace(const std::filesystem::path& filePath) const {
+    const auto records = Snapshot(m_slots.load(std::memory_order_acquire), Capacity);
+    std::ofstream outFile(filePath, std::ios::out | std::ios::trunc);
+    if (!outFile) {
+        Log::Write(Log::Level::Warning, Fmt("Failed to write frame trace \"%s\"", filePath.string().c_str()));
+        return false;
+    }
+
+    outFile << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    for (std::size_t lane = 0; lane < TraceStages.size(); ++lane) {
+        outFile << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << lane
+                << ",\"args\":{\"name\":\"" << TraceStages[lane].name << "\"}},\n";
+    }
+    // stage begin timestamp per frame, matched against the stage's end event.
+    std::array<std::unordered_map<std::uint64_t, std::uint64_t>, TraceStages.size()> stageBegin{};
+    bool first = true;
+    const auto writeEventPrefix = [&](const char* name, const char* phase, const std::size_t lane, const std::uint64_t ts) {
+        outFile << (first ? "" : ",\n") << "{\"name\":\"" << name << "\",\"ph\":\"" << phase
+                << "\",\"pid\":1,\"tid\":" << lane << ",\"ts\":" << ts;
+        first = false;
+    };
+    for (const auto& record : records) {
+        const auto event = static_cast<FrameTraceEvent>(record.event);
+        const std::size_t lane = StageLane(event);
+        const auto& stage = TraceStages[lane];
+        const std::int64_t frameIndex = static_cast<std::int64_t>(record.frameIndex);
+
+        writeEventPrefix(ToString(event), "i", lane, record.timestampUs);
+        outFile << ",\"s\":\"t\",\"args\":{\"frame\":" << frameIndex << "}}";
+
+        if (event == stage.begin) {
+            stageBegin[lane][record.frameIndex] = record.timestampUs;
+        } else if (event == stage.end) {
+            const auto beginItr = stageBegin[lane].find(record.frameIndex);
+            if (beginItr == stageBegin[lane].end())
+                continue;
+            writeEventPrefix(stage.name, "X", lane, beginItr->second);
+            outFile << ",\"dur\":" << (record.timestampUs - beginItr->second)
+                    << ",\"args\":{\"frame\":" << frameIndex << "}}";
+            stageBegin[lane].erase(beginItr);
+        }
+    }
+    outFile << "\n]}\n";
+    if (!outFile) {
+        Log::Write(Log::Level::Warning, Fmt("Failed to write frame trace \"%s\"", filePath.string().c_str()));
+        return false;
+    }
+    Log::Write(Log::Level::Info, Fmt("Frame trace written to \"%s\", %zu events.", filePath.string().c_str(), records.size()));
+    return true;
+}
+
+namespace {
+constexpr const std::size_t EndToEndIndex = TraceStages.size();
+using StageDurations = std::array<std::vector<std::uint64_t>, TraceStages.size() + 1>;
+
+// Sorted per-stage span durations (us), the last entry spans first packet to xrEndFrame.
+StageDurations GetStageDurations(const std::vector<TraceRecord>& records) {
+    std::array<std::unordered_map<std::uint64_t, std::uint64_t>, TraceStages.size() + 1> stageBegin{};
+    StageDurations durations{};
+    const auto endSpan = [&](const std::size_t index, const std::uint64_t frameIndex, const std::uint64_t timestampUs) {
+        const auto beginItr = stageBegin[index].find(frameIndex);
+        if (beginItr == stageBegin[index].end())
+            return;
+        durations[index].push_back(timestampUs - beginItr->second);
+        stageBegin[index].erase(beginItr);
+    };
+    for (const auto& record : records) {
+        const auto event = static_cast<FrameTraceEvent>(record.event);
+        const std::size_t lane = StageLane(event);
+        if (event == TraceStages[lane].begin)
+            stageBegin[lane][record.frameIndex] = record.timestampUs;
+        else if (event == TraceStages[lane].end)
+            endSpan(lane, record.frameIndex, record.timestampUs);
+
+        if (event == FrameTraceEvent::FirstPacket)
+            stageBegin[EndToEndIndex][record.frameIndex] = record.timestampUs;
+        else if (event == FrameTraceEvent::EndFrame)
+            endSpan(EndToEndIndex, record.frameIndex, record.timestampUs);
+    }
+    for (auto& stageDurations : durations)
+        std::sort(stageDurations.begin(), stageDurations.end());
+    return durations;
+}
+
+FrameStageStatistics MakeStageStatistics(const std::vector<std::uint64_t>& sortedDurations) {
+    const auto percentile = [&](const double p) {
+        return sortedDurations[static_cast<std::size_t>(p * (sortedDurations.size() - 1))] * 1e-3;
+    };
+    return {
+        .frameCount = sortedDurations.size(),
+        .p50Ms = percentile(0.5),
+        .p90Ms = percentile(0.9),
+        .p99Ms = percentile(0.99),
+        .maxMs = sortedDurations.back() * 1e-3
+    };
+}
+}
+
+void FrameTracer::LogStageStatistics() const {
+    const auto records = Snapshot(m_slots.load(std::memory_order_acquire), Capacity);
+    if (records.empty())
+        return;
+
+    const auto durations = GetStageDurations(records);
+    const double traceSeconds = (records.back().timestampUs - records.front().timestampUs) * 1e-6;
+    for (std::size_t index = 0; index < durations.size(); ++index) {
+        if (durations[index].empty())
+            continue;
+        const auto stats = MakeStageStatistics(durations[index]);
+        const char* const name = index == EndToEndIndex ? "end-to-end" : TraceStages[index].name;
+        Log::Write(Log::Level::Info, Fmt("Frame trace %-10s: %6zu frames, %7.2f fps, p50 %6.2fms, p90 %6.2fms, p99 %6.2fms, max %6.2fms",
+            name, stats.frameCount, traceSeconds > 0 ? stats.frameCount / traceSeconds : 0.0,
+            stats.p50Ms, stats.p90Ms, stats.p99Ms, stats.maxMs));
+    }
+}
+
+bool FrameTracer::GetStageStatistics
+(
+    const FrameTraceEvent stageBegin,
+    const std::uint64_t sinceTimestampUs,
+    FrameStageStatistics& stats
+) const {
+    const std::size_t lane = StageLane(stageBegin);
+    if (TraceStages[lane].begin != stageBegin)
+        return false;
+    auto records = Snapshot(m_slots.load(std::memory_order_acquire), Capacity);
+    records.erase(std::remove_if(records.begin(), records.end(), [sinceTimestampUs](const TraceRecord& record) {
+        return record.timestampUs < sinceTimestampUs;
+    }), records.end());
+    const auto durations = GetStageDurations(records);
+    if (durations[lane].empty())
+        return false;
+    stats = MakeStageStatistics(durations[lane]);
+    return true;
+}
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+#ifndef ALXR_FRAME_TRACE_H
+#define ALXR_FRAME_TRACE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <filesystem>
+#include "timing.h"
+
+namespace ALXR {
+
+// Pipeline stages recorded per video frame (trackingFrameIndex), the order here defines the
+// binary trace format's event ids, append only.
+enum class FrameTraceEvent : std::uint16_t {
+    FirstPacket = 0,
+    LastPacket,
+    FecReconstructed,
+    DecoderInput,
+    DecoderOutput,
+    UploadBegin,
+    UploadEnd,
+    WaitFrame,
+    BeginFrame,
+    EndFrame,
+    Count
+};
+const char* ToString(const FrameTraceEvent event);
+
+struct FrameStageStatistics {
+    std::size_t frameCount;
+    double      p50Ms;
+    double      p90Ms;
+    double      p99Ms;
+    double      maxMs;
+};
+
+// Bounded history of timestamped frame events, recorded lock-free from the receive, decoder & render
+// threads. Disabled by default, Record then costs a single atomic load. Once full the oldest events
+// are overwritten.
+class FrameTracer {
+public:
+    constexpr static const std::size_t Capacity = std::size_t(1) << 16;
+
+    static FrameTracer& Instance();
+
+    inline bool IsEnabled() const { return m_enabled.load(std::memory_order_acquire); }
+    void SetEnabled(const bool enable);
+
+    inline void Record(const FrameTraceEvent event, const std::uint64_t frameIndex) {
+        if (IsEnabled())
+            Push(event, frameIndex, GetSteadyTimestampUs());
+    }
+    inline void Record(const FrameTraceEvent event, const std::uint64_t frameIndex, const std::uint64_t timestampUs) {
+        if (IsEnabled())
+            Push(event, frameIndex, timestampUs);
+    }
+
+    // Chrome trace event format (chrome://tracing, perfetto), one lane per pipeline stage.
+    bool WriteChromeTrace(const std::filesystem::path& filePath) const;
+    // Header followed by packed TraceRecords, see frame_trace.cpp.
+    bool WriteBinary(const std::filesystem::path& filePath) const;
+    // Logs per-stage & end-to-end (first packet to xrEndFrame) duration percentiles over the recorded history.
+    void LogStageStatistics() const;
+    // Duration percentiles of the stage beginning with stageBegin (e.g. DecoderInput) over events recorded
+    // at or after sinceTimestampUs, false if no frame completed the stage.
+    bool GetStageStatistics
+    (
+        const FrameTraceEvent stageBegin,
+        const std::uint64_t sinceTimestampUs,
+        /*[out]*/ FrameStageStatistics& stats
+    ) const;
+
+private:
+    struct Slot;
+
+    FrameTracer() = default;
+    void Push(const FrameTraceEvent event, const std::uint64_t frameIndex, const std::uint64_t timestampUs);
+
+    std::atomic<bool>          m_enabled{ false };
+    std::atomic<std::uint64_t> m_writePos{ 0 };
+    // allocated on first enable & never freed or replaced, readers only see it through m_slots.
+    std::once_flag             m_slotsAllocated{};
+    std::unique_ptr<Slot[]>    m_slotsStorage{};
+    std::atomic<Slot*>         m_slots{ nullptr };
+};
+
+}
+#endif
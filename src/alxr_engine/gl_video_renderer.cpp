@@ -0,0 +1,607 @@
+#include "pch.h"
+#include "common.h"
+#include "geometry.h"
+#include "gl_video_renderer.h"
+#include "latency_manager.h"
+
+#if defined(XR_USE_GRAPHICS_API_OPENGL) || defined(XR_USE_GRAPHICS_API_OPENGL_ES)
+
+// GL_EXT_texture_norm16 on GLES, same enums as desktop GL.
+#if !defined(GL_R16)
+#define GL_R16 0x822A
+#endif
+#if !defined(GL_RG16)
+#define GL_RG16 0x822C
+#endif
+
+namespace ALXR {
+namespace {
+
+// Shader sources are prefixed with GLVideoRendererDesc::shaderVersion, no #version directive here.
+constexpr const char* VideoVertexShaderGlsl = R"_(
+    #ifdef ENABLE_MULTIVIEW
+        #extension GL_OVR_multiview2 : require
+        layout(num_views = 2) in;
+        #define VIEW_ID int(gl_ViewID_OVR)
+    #else
+        uniform int ViewID;
+        #define VIEW_ID ViewID
+    #endif
+
+    layout(location = 0) in vec3 VertexPos;
+    layout(location = 1) in vec2 VertexUV;
+
+    out vec2 UV;
+
+    void main() {
+       vec2 uv = VertexUV;
+       if (VIEW_ID > 0)
+           uv.x += 0.5;
+       UV = uv;
+       gl_Position = vec4(VertexPos, 1.0);
+    }
+    )_";
+
+// Same as vulkan_shaders/common/decodeFoveation.glsl with the specialization constants as uniforms,
+// GLSL 4.10 & GLSL ES only allow constant expressions as const initializers.
+constexpr const char* VideoFoveationDecodeGlsl = R"_(
+    uniform vec2 EyeSizeRatio;
+    uniform vec2 CenterSize;
+    uniform vec2 CenterShift;
+    uniform vec2 EdgeRatio;
+
+    vec2 TextureToEyeUV(const vec2 textureUV, const float isRightEye) {
+        // flip distortion horizontally for right eye
+        // left: x * 2; right: (1 - x) * 2
+        return vec2((textureUV.x + isRightEye * (1. - 2. * textureUV.x)) * 2., textureUV.y);
+    }
+
+    vec2 EyeToTextureUV(const vec2 eyeUV, const float isRightEye) {
+        // left: x / 2; right 1 - (x / 2)
+        return vec2(eyeUV.x * 0.5 + isRightEye * (1. - eyeUV.x), eyeUV.y);
+    }
+
+    vec2 ComputeRightEdge(const vec2 alignedUV, const vec2 er1, const vec2 hiBoundC, const vec2 c1, const vec2 c2) {
+        vec2 d1 = 1. - hiBoundC;
+        vec2 d2 = EdgeRatio * d1;
+        vec2 d3 = c2 * EdgeRatio - c2;
+        vec2 d4 = c2 - EdgeRatio * c1 - 2. * EdgeRatio * c2 + c2 * d2 + EdgeRatio;
+        vec2 d5 = d4 / d2;
+        vec2 d6 = d5 * d5 - 4. * (d3 * (c1 - hiBoundC + hiBoundC * c2) / (d2 * d1) - alignedUV * d3 / d2);
+        return (sqrt(abs(d6)) - d5) / (2. * c2 * er1) * d2;
+    }
+
+    vec2 ComputeLeftEdge(const vec2 alignedUV, const vec2 loBoundC, const vec2 c1, const vec2 c2) {
+        vec2 d1 = c1 + c2 * loBoundC;
+        vec2 d2 = d1 / loBoundC;
+        vec2 d3 = 1. - EdgeRatio;
+        vec2 d4 = EdgeRatio * loBoundC;
+        vec2 d5 = c2 * d3;
+        vec2 d6 = d2 * d2 + 4. * d5 / d4 * alignedUV;
+        return (sqrt(abs(d6)) - d2) / (2. * d5) * d4;
+    }
+
+    vec2 DecodeFoveationUV(const vec2 uv, const float isRightEye) {
+        vec2 alignedUV = TextureToEyeUV(uv, isRightEye);
+
+        vec2 er1 = EdgeRatio - 1.;
+
+        vec2 c0 = (1. - CenterSize) * 0.5;
+        vec2 loBound = c0 * (CenterShift + 1.);
+
+        vec2 c1 = er1 * loBound / EdgeRatio;
+        vec2 c2 = er1 * CenterSize + 1.;
+
+        vec2 hiBoundA = c0 * (CenterShift - 1.);
+        vec2 hiBound = hiBoundA + 1.;
+
+        vec2 underBound = vec2(lessThan(alignedUV, loBound));
+        vec2 overBound = vec2(greaterThan(alignedUV, hiBound));
+        vec2 inBound = vec2(loBound.x < alignedUV.x && alignedUV.x < hiBound.x,
+                                  loBound.y < alignedUV.y && alignedUV.y < hiBound.y);
+
+        vec2 c2Inv = 1.0 / c2;
+        vec2 center = (alignedUV - c1) * EdgeRatio * c2Inv;
+
+        vec2 loBoundC = loBound * c2Inv;
+        vec2 leftEdge = ComputeLeftEdge(alignedUV, loBoundC, c1, c2);
+
+        vec2 hiBoundC = hiBoundA * c2Inv + 1.;
+        vec2 rightEdge = ComputeRightEdge(alignedUV, er1, hiBoundC, c1, c2);
+
+        vec2 uncompressedUV = underBound * leftEdge + inBound * center + overBound * rightEdge;
+
+        return EyeToTextureUV(uncompressedUV * EyeSizeRatio, isRightEye);
+    }
+    )_";
+
+// Fragment shaders have no default float precision in GLSL ES, highp for 10-bit formats.
+constexpr const char* FragmentPrecisionGlsl = R"_(
+    #ifdef GL_ES
+        precision highp float;
+        precision highp sampler2D;
+    #endif
+    )_";
+
+// YUV->RGB & sRGB linearization as in d3d_shaders/common, passthrough modes as in vulkan_shaders/passthrough*_frag.glsl.
+constexpr const char* VideoFragmentShaderGlsl = R"_(
+    in vec2 UV;
+    out vec4 FragColor;
+
+    uniform sampler2D tex_y;
+    uniform sampler2D tex_uv;
+    uniform sampler2D tex_v;
+    uniform bool Is3PlaneFormat;
+    uniform bool EnableSRGBLinearize;
+
+    // Derived from https://msdn.microsoft.com/en-us/library/windows/desktop/dd206750(v=vs.85).aspx
+    // Section: Converting 8-bit YUV to RGB888
+    const mat3 YUVtoRGBCoeffMatrix = mat3
+    (
+        1.164383,  1.164383, 1.164383,
+        0.000000, -0.391762, 2.017232,
+        1.596027, -0.812968, 0.000000
+    );
+
+    vec3 ConvertYUVtoRGB(vec3 yuv) {
+        // These values are calculated from (16 / 255) and (128 / 255)
+        yuv -= vec3(0.062745, 0.501960, 0.501960);
+        return clamp(YUVtoRGBCoeffMatrix * yuv, 0.0, 1.0);
+    }
+
+    float sRGBToLinearRGBScalar(float x) {
+        return (x < 0.04045) ?
+            (x * (1.0 / 12.92)) : pow((x + 0.055) * (1.0 / 1.055), 2.4);
+    }
+
+    vec3 sRGBToLinearRGB(vec3 c) {
+        return vec3(sRGBToLinearRGBScalar(c.r), sRGBToLinearRGBScalar(c.g), sRGBToLinearRGBScalar(c.b));
+    }
+
+    vec3 SampleVideoTexture() {
+    #ifdef ENABLE_FOVEATION_DECODE
+        vec2 texUV = DecodeFoveationUV(UV, float(UV.x > 0.5));
+    #else
+        vec2 texUV = UV;
+    #endif
+        float y = texture(tex_y, texUV).r;
+        vec2 uv = Is3PlaneFormat ?
+            vec2(texture(tex_uv, texUV).r, texture(tex_v, texUV).r) :
+            texture(tex_uv, texUV).rg;
+        vec3 rgb = ConvertYUVtoRGB(vec3(y, uv));
+        return EnableSRGBLinearize ? sRGBToLinearRGB(rgb) : rgb;
+    }
+
+    void main() {
+        vec3 color = SampleVideoTexture();
+    #if PASSTHROUGH_MODE == 1
+        FragColor = vec4(color, 0.6);
+    #elif PASSTHROUGH_MODE == 2
+        FragColor = vec4(color, all(lessThan(color, vec3(0.01))) ? 0.3 : 1.0);
+    #else
+        FragColor = vec4(color, 1.0);
+    #endif
+    }
+    )_";
+
+void CheckShader(const GLuint shader) {
+    GLint r = 0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &r);
+    if (r == GL_FALSE) {
+        GLchar msg[4096] = {};
+        GLsizei length;
+        glGetShaderInfoLog(shader, sizeof(msg), &length, msg);
+        THROW(Fmt("Compile shader failed: %s", msg));
+    }
+}
+
+void CheckProgram(const GLuint prog) {
+    GLint r = 0;
+    glGetProgramiv(prog, GL_LINK_STATUS, &r);
+    if (r == GL_FALSE) {
+        GLchar msg[4096] = {};
+        GLsizei length;
+        glGetProgramInfoLog(prog, sizeof(msg), &length, msg);
+        THROW(Fmt("Link program failed: %s", msg));
+    }
+}
+
+GLuint CompileShader(const GLenum shaderType, const std::vector<const char*>& sources) {
+    const GLuint shader = glCreateShader(shaderType);
+    glShaderSource(shader, static_cast<GLsizei>(sources.size()), sources.data(), nullptr);
+    glCompileShader(shader);
+    CheckShader(shader);
+    return shader;
+}
+
+constexpr inline std::size_t AlignUp(const std::size_t size, const std::size_t alignment) {
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+}
+
+void GLVideoRenderer::Initialize(const GLVideoRendererDesc& desc) {
+    CHECK(desc.shaderVersion != nullptr);
+    m_desc = desc;
+    if (!m_desc.isPersistentMappingSupported)
+        Log::Write(Log::Level::Warning, "Persistently mapped buffers unsupported, no video stream will be displayed.");
+    if (!m_desc.isNorm16Supported)
+        Log::Write(Log::Level::Warning, "16-bit normalized textures unsupported, 10-bit video streams will not be displayed.");
+
+    using namespace Geometry;
+    glGenBuffers(1, &m_quadVertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_quadVertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(QuadVertices), QuadVertices.data(), GL_STATIC_DRAW);
+
+    glGenBuffers(1, &m_quadIndexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_quadIndexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(QuadIndices), QuadIndices.data(), GL_STATIC_DRAW);
+
+    glGenVertexArrays(1, &m_quadVAO);
+    glBindVertexArray(m_quadVAO);
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glBindBuffer(GL_ARRAY_BUFFER, m_quadVertexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_quadIndexBuffer);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(QuadVertex), reinterpret_cast<const void*>(offsetof(QuadVertex, position)));
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(QuadVertex), reinterpret_cast<const void*>(offsetof(QuadVertex, uv)));
+    glBindVertexArray(0);
+
+    InitializePrograms();
+}
+
+void GLVideoRenderer::InitializePrograms() {
+    constexpr const std::size_t ModeCount = static_cast<std::size_t>(PassthroughMode::TypeCount);
+    constexpr const std::array<const char*, ModeCount> PassthroughModeDefines {
+        "#define PASSTHROUGH_MODE 0\n",
+        "#define PASSTHROUGH_MODE 1\n",
+        "#define PASSTHROUGH_MODE 2\n"
+    };
+    const std::array<GLuint, 2> vertexShaders {
+        CompileShader(GL_VERTEX_SHADER, { m_desc.shaderVersion, VideoVertexShaderGlsl }),
+        m_desc.isMultiviewSupported ?
+            CompileShader(GL_VERTEX_SHADER, { m_desc.shaderVersion, "#define ENABLE_MULTIVIEW\n", VideoVertexShaderGlsl }) : 0
+    };
+    // programIndex = mode + ModeCount * (foveated + 2 * multiview).
+    for (std::size_t programIndex = 0; programIndex < m_programs.size(); ++programIndex) {
+        const bool enableFoveation = (programIndex / ModeCount) % 2 != 0;
+        const GLuint vertexShader = vertexShaders[programIndex / (ModeCount * 2)];
+        if (vertexShader == 0)
+            continue;
+        const GLuint fragmentShader = CompileShader(GL_FRAGMENT_SHADER, {
+            m_desc.shaderVersion,
+            FragmentPrecisionGlsl,
+            PassthroughModeDefines[programIndex % ModeCount],
+            enableFoveation ? "#define ENABLE_FOVEATION_DECODE\n" : "",
+            enableFoveation ? VideoFoveationDecodeGlsl : "",
+            VideoFragmentShaderGlsl
+        });
+
+        auto& videoProgram = m_programs[programIndex];
+        videoProgram.program = glCreateProgram();
+        glAttachShader(videoProgram.program, vertexShader);
+        glAttachShader(videoProgram.program, fragmentShader);
+        glLinkProgram(videoProgram.program);
+        CheckProgram(videoProgram.program);
+        glDeleteShader(fragmentShader);
+
+        const GLuint program = videoProgram.program;
+        videoProgram.viewID              = glGetUniformLocation(program, "ViewID");
+        videoProgram.is3PlaneFormat      = glGetUniformLocation(program, "Is3PlaneFormat");
+        videoProgram.enableSRGBLinearize = glGetUniformLocation(program, "EnableSRGBLinearize");
+        videoProgram.eyeSizeRatio        = glGetUniformLocation(program, "EyeSizeRatio");
+        videoProgram.centerSize          = glGetUniformLocation(program, "CenterSize");
+        videoProgram.centerShift         = glGetUniformLocation(program, "CenterShift");
+        videoProgram.edgeRatio           = glGetUniformLocation(program, "EdgeRatio");
+
+        glUseProgram(program);
+        glUniform1i(glGetUniformLocation(program, "tex_y"), 0);
+        glUniform1i(glGetUniformLocation(program, "tex_uv"), 1);
+        glUniform1i(glGetUniformLocation(program, "tex_v"), 2);
+    }
+    glUseProgram(0);
+    for (const GLuint vertexShader : vertexShaders) {
+        if (vertexShader != 0)
+            glDeleteShader(vertexShader);
+    }
+}
+
+void GLVideoRenderer::Destroy() {
+    RetireUploadSlots();
+    DestroyResources();
+    for (auto& videoProgram : m_programs) {
+        if (videoProgram.program != 0) {
+            glDeleteProgram(videoProgram.program);
+            videoProgram.program = 0;
+        }
+    }
+    if (m_quadVAO != 0) {
+        glDeleteVertexArrays(1, &m_quadVAO);
+        m_quadVAO = 0;
+    }
+    if (m_quadVertexBuffer != 0) {
+        glDeleteBuffers(1, &m_quadVertexBuffer);
+        m_quadVertexBuffer = 0;
+    }
+    if (m_quadIndexBuffer != 0) {
+        glDeleteBuffers(1, &m_quadIndexBuffer);
+        m_quadIndexBuffer = 0;
+    }
+}
+
+void GLVideoRenderer::DestroyResources() {
+    for (auto& slot : m_uploadSlots) {
+        if (slot.fence != nullptr) {
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+        }
+        slot.mapped = nullptr;
+    }
+    if (m_pbo != 0) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glDeleteBuffers(1, &m_pbo);
+        m_pbo = 0;
+    }
+    for (auto& texture : m_textures) {
+        if (texture != 0) {
+            glDeleteTextures(1, &texture);
+            texture = 0;
+        }
+    }
+    m_planeCount = 0;
+    m_frameIndex = std::uint64_t(-1);
+}
+
+void GLVideoRenderer::CreateResources(const TextureDesc& desc) {
+    const std::size_t planeCount = PlaneCount(desc.pixfmt);
+    if (planeCount == 0 || desc.width == 0 || desc.height == 0 || !m_desc.isPersistentMappingSupported)
+        return;
+    CHECK(desc.width % 2 == 0);
+
+    const bool is16Bit = desc.pixfmt == XrPixelFormat::P010LE ||
+                         desc.pixfmt == XrPixelFormat::G10X6_B10X6_R10X6_3PLANE_420;
+    if (is16Bit && !m_desc.isNorm16Supported) {
+        Log::Write(Log::Level::Warning, "10-bit video stream requires 16-bit normalized textures, frames will be dropped.");
+        return;
+    }
+    const Plane lumaPlane = is16Bit ?
+        Plane { GL_R16, GL_RED, GL_UNSIGNED_SHORT, 2 } :
+        Plane { GL_R8,  GL_RED, GL_UNSIGNED_BYTE,  1 };
+    const Plane chromaPlane = planeCount > 2 ? lumaPlane : is16Bit ?
+        Plane { GL_RG16, GL_RG, GL_UNSIGNED_SHORT, 4 } :
+        Plane { GL_RG8,  GL_RG, GL_UNSIGNED_BYTE,  2 };
+
+    std::size_t slotSize = 0;
+    for (std::size_t planeIndex = 0; planeIndex < planeCount; ++planeIndex) {
+        auto& plane = m_planes[planeIndex];
+        plane = planeIndex == 0 ? lumaPlane : chromaPlane;
+        plane.width  = static_cast<GLsizei>(planeIndex == 0 ? desc.width  : desc.width / 2);
+        plane.height = static_cast<GLsizei>(planeIndex == 0 ? desc.height : (desc.height + 1) / 2);
+        plane.rowBytes = plane.width * plane.texelSize;
+        plane.offset = slotSize;
+        slotSize = AlignUp(slotSize + plane.rowBytes * plane.height, UploadAlignment);
+
+        GLuint& texture = m_textures[planeIndex];
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexStorage2D(GL_TEXTURE_2D, 1, plane.internalFormat, plane.width, plane.height);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    constexpr const GLbitfield MapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const std::size_t bufferSize = slotSize * m_uploadSlots.size();
+    glGenBuffers(1, &m_pbo);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo);
+    glBufferStorage(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(bufferSize), nullptr, MapFlags);
+    auto mapped = reinterpret_cast<std::uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(bufferSize), MapFlags));
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    CHECK_MSG(mapped != nullptr, "Failed to persistently map video upload buffer");
+
+    for (std::size_t slotIndex = 0; slotIndex < m_uploadSlots.size(); ++slotIndex) {
+        auto& slot = m_uploadSlots[slotIndex];
+        slot.mapped = mapped + slotIndex * slotSize;
+        slot.offset = slotIndex * slotSize;
+        slot.frameIndex = std::uint64_t(-1);
+    }
+    m_planeCount = planeCount;
+    Log::Write(Log::Level::Info, Fmt("Created GL video textures %zux%zu, %zu planes, %zu bytes per upload slot.",
+        desc.width, desc.height, planeCount, slotSize));
+}
+
+// Takes every upload slot away from the decoder thread, true once none is left being written to.
+bool GLVideoRenderer::RetireUploadSlots() {
+    const std::size_t readySlot = m_readySlot.exchange(NoSlot, std::memory_order_acq_rel);
+    if (readySlot != NoSlot)
+        m_uploadSlots[readySlot].state.store(UploadSlotState::Retired, std::memory_order_relaxed);
+    bool allRetired = true;
+    for (auto& slot : m_uploadSlots) {
+        if (slot.fence != nullptr) {
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+            slot.state.store(UploadSlotState::Retired, std::memory_order_relaxed);
+        }
+        auto expected = UploadSlotState::Free;
+        slot.state.compare_exchange_strong(expected, UploadSlotState::Retired, std::memory_order_acq_rel);
+        allRetired &= slot.state.load(std::memory_order_acquire) == UploadSlotState::Retired;
+    }
+    return allRetired;
+}
+
+void GLVideoRenderer::UpdateResources() {
+    const std::uint64_t requestedGen = m_requestedGen.load(std::memory_order_acquire);
+    if (requestedGen == m_gen.load(std::memory_order_relaxed))
+        return;
+    if (!RetireUploadSlots())
+        return; // the decoder thread still holds a slot, retry next frame.
+
+    TextureDesc desc{};
+    {
+        std::scoped_lock lk(m_descMutex);
+        desc = m_requestedDesc;
+    }
+    DestroyResources();
+    CreateResources(desc);
+    // slots stay retired after a clear (or failed creation) so the decoder keeps dropping frames.
+    if (m_planeCount > 0) {
+        for (auto& slot : m_uploadSlots)
+            slot.state.store(UploadSlotState::Free, std::memory_order_relaxed);
+    }
+    m_gen.store(requestedGen, std::memory_order_release);
+}
+
+void GLVideoRenderer::ReleaseCompletedUploads() {
+    for (auto& slot : m_uploadSlots) {
+        if (slot.fence == nullptr)
+            continue;
+        const GLenum result = glClientWaitSync(slot.fence, 0, 0);
+        if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+            continue;
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+        slot.state.store(UploadSlotState::Free, std::memory_order_release);
+    }
+}
+
+void GLVideoRenderer::RequestTextures(const std::size_t width, const std::size_t height, const XrPixelFormat pixfmt) {
+    std::scoped_lock lk(m_descMutex);
+    m_requestedDesc = { .width = width, .height = height, .pixfmt = pixfmt };
+    m_requestedGen.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void GLVideoRenderer::Update(const IGraphicsPlugin::YUVBuffer& yuvBuffer) {
+    std::size_t slotIndex = 0;
+    for (; slotIndex < m_uploadSlots.size(); ++slotIndex) {
+        auto expected = UploadSlotState::Free;
+        if (m_uploadSlots[slotIndex].state.compare_exchange_strong(expected, UploadSlotState::Writing, std::memory_order_acq_rel))
+            break;
+    }
+    if (slotIndex == m_uploadSlots.size())
+        return; // all slots in flight, drop the frame rather than wait on the render thread.
+
+    auto& slot = m_uploadSlots[slotIndex];
+    // holding a slot keeps the render thread from recreating resources, the layout is stable until released.
+    if (m_gen.load(std::memory_order_acquire) != m_requestedGen.load(std::memory_order_acquire)) {
+        slot.state.store(UploadSlotState::Free, std::memory_order_release);
+        return;
+    }
+
+    using Buffer = IGraphicsPlugin::Buffer;
+    const std::array<const Buffer*, 3> srcBuffers { &yuvBuffer.luma, &yuvBuffer.chroma, &yuvBuffer.chroma2 };
+    std::array<Plane2D, 3> planes{};
+    std::size_t planeCount = 0;
+    for (std::size_t planeIndex = 0; planeIndex < m_planeCount; ++planeIndex) {
+        const auto& src = *srcBuffers[planeIndex];
+        const auto& dst = m_planes[planeIndex];
+        if (src.data == nullptr)
+            continue;
+        planes[planeCount++] = {
+            .dst = slot.mapped + dst.offset,
+            .dstPitch = dst.rowBytes,
+            .src = reinterpret_cast<const std::uint8_t*>(src.data),
+            .srcPitch = src.pitch,
+            .rowBytes = std::min(dst.rowBytes, src.pitch),
+            .rows = std::min<std::size_t>(dst.height, src.height)
+        };
+    }
+    m_planeCopier.Copy(planes.data(), planeCount);
+    slot.frameIndex = yuvBuffer.frameIndex;
+    slot.state.store(UploadSlotState::Ready, std::memory_order_release);
+    LatencyManager::Instance().OnVideoFrameDecoded();
+
+    // only the newest frame is uploaded, a ready slot the render thread has not taken yet is recycled.
+    const std::size_t prevSlot = m_readySlot.exchange(slotIndex, std::memory_order_acq_rel);
+    if (prevSlot != NoSlot) {
+        m_uploadSlots[prevSlot].state.store(UploadSlotState::Free, std::memory_order_release);
+        LatencyManager::Instance().OnVideoFrameDropped();
+    }
+}
+
+void GLVideoRenderer::BeginView() {
+    UpdateResources();
+    ReleaseCompletedUploads();
+
+    const std::size_t slotIndex = m_readySlot.exchange(NoSlot, std::memory_order_acq_rel);
+    if (slotIndex == NoSlot) {
+        if (HasFrame())
+            LatencyManager::Instance().OnVideoFrameReRendered();
+        return;
+    }
+    LatencyManager::Instance().OnVideoFrameDisplayed();
+    auto& slot = m_uploadSlots[slotIndex];
+    slot.state.store(UploadSlotState::Uploading, std::memory_order_relaxed);
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    for (std::size_t planeIndex = 0; planeIndex < m_planeCount; ++planeIndex) {
+        const auto& plane = m_planes[planeIndex];
+        glBindTexture(GL_TEXTURE_2D, m_textures[planeIndex]);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, plane.width, plane.height, plane.format, plane.type,
+                        reinterpret_cast<const void*>(slot.offset + plane.offset));
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    // the slot is handed back to the decoder thread once the GPU has consumed the PBO contents.
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_frameIndex = slot.frameIndex;
+}
+
+void GLVideoRenderer::RenderView(const std::uint32_t viewID, const PassthroughMode mode) {
+    if (!HasFrame())
+        return;
+    Draw(static_cast<std::size_t>(mode), viewID);
+}
+
+void GLVideoRenderer::RenderMultiView(const PassthroughMode mode) {
+    CHECK(m_desc.isMultiviewSupported);
+    if (!HasFrame())
+        return;
+    Draw(static_cast<std::size_t>(mode) + static_cast<std::size_t>(PassthroughMode::TypeCount) * 2, 0);
+}
+
+void GLVideoRenderer::Draw(const std::size_t programIndex, const std::uint32_t viewID) {
+    const auto fovDecodeParams = m_fovDecodeParams;
+    const auto& videoProgram = m_programs[programIndex +
+        (fovDecodeParams ? static_cast<std::size_t>(PassthroughMode::TypeCount) : 0)];
+
+    glUseProgram(videoProgram.program);
+    glUniform1i(videoProgram.viewID, static_cast<GLint>(viewID));
+    glUniform1i(videoProgram.is3PlaneFormat, m_planeCount > 2);
+    glUniform1i(videoProgram.enableSRGBLinearize, m_enableSRGBLinearize);
+    if (fovDecodeParams) {
+        glUniform2fv(videoProgram.eyeSizeRatio, 1, &fovDecodeParams->eyeSizeRatio.x);
+        glUniform2fv(videoProgram.centerSize, 1, &fovDecodeParams->centerSize.x);
+        glUniform2fv(videoProgram.centerShift, 1, &fovDecodeParams->centerShift.x);
+        glUniform2fv(videoProgram.edgeRatio, 1, &fovDecodeParams->edgeRatio.x);
+    }
+    for (std::size_t planeIndex = 0; planeIndex < m_textures.size(); ++planeIndex) {
+        glActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(planeIndex));
+        glBindTexture(GL_TEXTURE_2D, planeIndex < m_planeCount ? m_textures[planeIndex] : 0);
+    }
+
+    glBindVertexArray(m_quadVAO);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(Geometry::QuadIndices.size()), GL_UNSIGNED_SHORT, nullptr);
+    glBindVertexArray(0);
+
+    for (std::size_t planeIndex = m_textures.size(); planeIndex-- > 0;) {
+        glActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(planeIndex));
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    glUseProgram(0);
+}
+
+void GLVideoRenderer::SetFoveatedDecode(const FoveatedDecodeParams* fovDecParm) {
+    m_fovDecodeParams = fovDecParm ?
+        std::make_shared<FoveatedDecodeParams>(*fovDecParm) : nullptr;
+}
+
+}
+#endif
@@ -0,0 +1,151 @@
+#pragma once
+#ifndef ALXR_GL_VIDEO_RENDERER_H
+#define ALXR_GL_VIDEO_RENDERER_H
+
+#if defined(XR_USE_GRAPHICS_API_OPENGL) || defined(XR_USE_GRAPHICS_API_OPENGL_ES)
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include <common/gfxwrapper_opengl.h>
+#include "graphicsplugin.h"
+#include "foveation.h"
+#include "plane_copy.h"
+
+namespace ALXR {
+
+struct GLVideoRendererDesc {
+    // #version directive prepended to every video shader.
+    const char* shaderVersion = nullptr;
+    // glBufferStorage + GL_MAP_PERSISTENT_BIT, core since GL 4.4, GL_EXT_buffer_storage on GLES.
+    bool isPersistentMappingSupported = false;
+    // R16/RG16 textures for 10-bit formats, core on GL, GL_EXT_texture_norm16 on GLES.
+    bool isNorm16Supported = false;
+    // GL_OVR_multiview2, both views drawn into a 2-layer texture array in one draw.
+    bool isMultiviewSupported = false;
+};
+
+// Video stream path shared by the OpenGL & OpenGLES graphics plugins.
+//
+// RequestTextures/Update are called from the decoder thread which has no GL context, GL objects
+// are only (re)created on the render thread in BeginView. Decoded planes are copied into a
+// triple-buffered, persistently mapped PBO, the render thread uploads the newest ready slot to the
+// video textures & fences it. The decoder never waits on the GL thread, frames arriving with no
+// free slot are dropped.
+class GLVideoRenderer {
+public:
+    // Opaque, additive, alpha-blend & XR_FB_passthrough modes, matches ALXR::VideoClearColors.
+    constexpr static const std::array<float, 4> ClearAlpha { 1.0f, 0.0f, 0.5f, 0.2f };
+
+    GLVideoRenderer() = default;
+    GLVideoRenderer(const GLVideoRenderer&) = delete;
+    GLVideoRenderer& operator=(const GLVideoRenderer&) = delete;
+
+    // Render thread, with the plugin's context current.
+    void Initialize(const GLVideoRendererDesc& desc);
+    void Destroy();
+
+    // Decoder thread.
+    void RequestTextures(const std::size_t width, const std::size_t height, const XrPixelFormat pixfmt);
+    void Update(const IGraphicsPlugin::YUVBuffer& yuvBuffer);
+
+    // Render thread, once per frame before any RenderView.
+    void BeginView();
+    inline std::uint64_t GetFrameIndex() const { return m_frameIndex; }
+    inline bool HasFrame() const { return m_planeCount > 0 && m_frameIndex != std::uint64_t(-1); }
+    // Draws the video quad for viewID into the bound framebuffer & viewport.
+    void RenderView(const std::uint32_t viewID, const PassthroughMode mode);
+    // Draws both views into a framebuffer bound with glFramebufferTextureMultiviewOVR, requires isMultiviewSupported.
+    void RenderMultiView(const PassthroughMode mode);
+
+    inline void SetEnableLinearizeRGB(const bool enable) { m_enableSRGBLinearize = enable; }
+    void SetFoveatedDecode(const FoveatedDecodeParams* fovDecParm);
+
+private:
+    constexpr static const std::size_t UploadAlignment = 256;
+    constexpr static const std::size_t NoSlot = std::size_t(-1);
+
+    struct TextureDesc {
+        std::size_t   width = 0;
+        std::size_t   height = 0;
+        XrPixelFormat pixfmt = XrPixelFormat::Uknown;
+    };
+    struct Plane {
+        GLenum      internalFormat;
+        GLenum      format;
+        GLenum      type;
+        std::size_t texelSize;
+        GLsizei     width = 0;
+        GLsizei     height = 0;
+        std::size_t rowBytes = 0;
+        std::size_t offset = 0; // within an upload slot.
+    };
+    enum class UploadSlotState : std::uint32_t {
+        Free,      // owned by nobody, the decoder thread may take it.
+        Writing,   // decoder thread is copying a frame into it.
+        Ready,     // holds the newest decoded frame, published in m_readySlot.
+        Uploading, // render thread issued the texture upload, freed once its fence signals.
+        Retired    // held by the render thread while resources are (re)created.
+    };
+    struct UploadSlot {
+        std::uint8_t*                mapped = nullptr;
+        std::size_t                  offset = 0;
+        std::uint64_t                frameIndex = std::uint64_t(-1);
+        GLsync                       fence = nullptr;
+        std::atomic<UploadSlotState> state{ UploadSlotState::Retired };
+    };
+    struct Program {
+        GLuint program = 0;
+        GLint  viewID = -1;
+        GLint  is3PlaneFormat = -1;
+        GLint  enableSRGBLinearize = -1;
+        GLint  eyeSizeRatio = -1;
+        GLint  centerSize = -1;
+        GLint  centerShift = -1;
+        GLint  edgeRatio = -1;
+    };
+
+    void InitializePrograms();
+    void Draw(const std::size_t programIndex, const std::uint32_t viewID);
+    void DestroyResources();
+    void CreateResources(const TextureDesc& desc);
+    bool RetireUploadSlots();
+    void UpdateResources();
+    void ReleaseCompletedUploads();
+
+    GLVideoRendererDesc m_desc{};
+
+    using FoveatedDecodeParamsPtr = std::shared_ptr<FoveatedDecodeParams>;
+    FoveatedDecodeParamsPtr m_fovDecodeParams{};
+    bool                    m_enableSRGBLinearize = true;
+
+    // per passthrough mode, with & without foveated decoding, single & multiview.
+    std::array<Program, static_cast<std::size_t>(PassthroughMode::TypeCount) * 4> m_programs{};
+    GLuint m_quadVAO{ 0 };
+    GLuint m_quadVertexBuffer{ 0 };
+    GLuint m_quadIndexBuffer{ 0 };
+
+    // requested from the decoder thread, applied by the render thread.
+    std::mutex                 m_descMutex{};
+    TextureDesc                m_requestedDesc{};
+    std::atomic<std::uint64_t> m_requestedGen{ 0 };
+    std::atomic<std::uint64_t> m_gen{ 0 };
+
+    // render thread owned, read by the decoder thread only while it holds an upload slot.
+    GLuint                    m_pbo{ 0 };
+    std::array<GLuint, 3>     m_textures{};
+    std::array<Plane, 3>      m_planes{};
+    std::size_t               m_planeCount{ 0 };
+    std::array<UploadSlot, 3> m_uploadSlots{};
+    std::atomic<std::size_t>  m_readySlot{ NoSlot };
+    std::uint64_t             m_frameIndex{ std::uint64_t(-1) };
+    PlaneCopier               m_planeCopier{};
+};
+
+}
+#endif
+#endif
@@ -67,6 +67,11 @@ struct IGraphicsPlugin {
 
     virtual void ClearSwapchainImageStructs() {}
 
+    // Optional, views rendered between Begin/EndRenderViews may be recorded & submitted to the GPU
+    // as one batch. EndRenderViews must be called before the swapchain images are released.
+    virtual void BeginRenderViews() {}
+    virtual void EndRenderViews() {}
+
     // Render to a swapchain image for a projection view.
     virtual void RenderView
     (
@@ -114,6 +119,8 @@ struct IGraphicsPlugin {
         return view.recommendedSwapchainSampleCount;
     }
 
+    // Called from the decoder thread on the first decoded frame & again if the stream changes size/format
+    // mid-stream, in which case the frame on display should stay up until a frame of the new size is uploaded.
     virtual void CreateVideoTextures(const std::size_t /*width*/, const std::size_t /*height*/, const XrPixelFormat /*pixfmt*/) {}
     virtual void CreateVideoTexturesD3D11VA(const std::size_t /*width*/, const std::size_t /*height*/, const XrPixelFormat /*pixfmt*/) { return; }
     virtual void CreateVideoTexturesCUDA(const std::size_t /*width*/, const std::size_t /*height*/, const XrPixelFormat /*pixfmt*/) { return; }
@@ -24,6 +24,7 @@
 #include "cuda/d3d11cuda_interop.h"
 #endif
 #include "foveation.h"
+#include "plane_copy.h"
 
 using namespace Microsoft::WRL;
 using namespace DirectX;
@@ -40,7 +41,7 @@ void InitializeD3D11DeviceForAdapter(IDXGIAdapter1* adapter, const std::vector<D
 
     // Create the Direct3D 11 API device object and a corresponding context.
     D3D_DRIVER_TYPE driverType = ((adapter == nullptr) ? D3D_DRIVER_TYPE_HARDWARE : D3D_DRIVER_TYPE_UNKNOWN);
-    Log::Write(Log::Level::Verbose, Fmt("Selected driver type: %d", static_cast<int>(driverType)));
+    ALXR_LOG_VERBOSE(Fmt("Selected driver type: %d", static_cast<int>(driverType)));
 
 TryAgain:
     HRESULT hr = D3D11CreateDevice(adapter, driverType, 0, creationFlags, featureLevels.data(), (UINT)featureLevels.size(),
@@ -797,26 +798,6 @@ struct D3D11GraphicsPlugin final : public IGraphicsPlugin {
             }            
             assert(lumaTexture != nullptr && chromaTexture != nullptr);
 
-            constexpr const auto copy2d = []
-            (
-                std::uint8_t* dst, const std::size_t dstPitchInBytes,
-                const std::uint8_t* src, const std::size_t srcPitchInBytes,
-                const std::size_t width, const std::size_t height, const std::size_t formatSize
-            )
-            {
-                if (dstPitchInBytes == srcPitchInBytes) {
-                    std::memcpy(dst, src, dstPitchInBytes * height);
-                    return;
-                }
-                const std::size_t lineDstSize = width * formatSize;
-                for (std::size_t h = 0; h < height; ++h)
-                {
-                    auto lineDstPtr = dst + (dstPitchInBytes * h);
-                    const auto lineSrcPtr = src + (srcPitchInBytes * h);
-                    std::memcpy(lineDstPtr, lineSrcPtr, lineDstSize);
-                    //std::copy_n(par_unseq, src, chromaLineSize, dst);
-                }
-            };
             const auto mapCopy2d = [&](const TexturePtr& dstTex, const Buffer& srcData)
             {
                 D3D11_TEXTURE2D_DESC texDesc{};
@@ -825,11 +806,15 @@ struct D3D11GraphicsPlugin final : public IGraphicsPlugin {
                 D3D11_MAPPED_SUBRESOURCE mappedResource{};
                 CHECK_HRCMD(m_uploadContext->Map(dstTex.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource));
                 {
-                    copy2d
-                    (
-                        reinterpret_cast<std::uint8_t*>(mappedResource.pData), (std::size_t)mappedResource.RowPitch,
-                        (const std::uint8_t*)srcData.data, srcData.pitch, (std::size_t)texDesc.Width, srcData.height, formatSize
-                    );
+                    const ALXR::Plane2D plane {
+                        .dst = reinterpret_cast<std::uint8_t*>(mappedResource.pData),
+                        .dstPitch = (std::size_t)mappedResource.RowPitch,
+                        .src = (const std::uint8_t*)srcData.data,
+                        .srcPitch = srcData.pitch,
+                        .rowBytes = (std::size_t)texDesc.Width * formatSize,
+                        .rows = srcData.height
+                    };
+                    m_planeCopier.Copy(&plane, 1);
                 }
                 m_uploadContext->Unmap(dstTex.Get(), 0);
             };
@@ -1117,6 +1102,7 @@ struct D3D11GraphicsPlugin final : public IGraphicsPlugin {
     std::array<NV12Texture, 2> m_videoTextures{};
     std::atomic<std::size_t>   m_currentVideoTex{ 0 }, m_renderTex{ -1 };
     std::size_t currentTextureIdx = std::size_t(-1);
+    ALXR::PlaneCopier          m_planeCopier{};
     //std::mutex                     m_renderMutex{};
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -362,7 +362,7 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
             return;
 
         const auto highestShaderModel = GetHighestSupportedShaderModel();
-        Log::Write(Log::Level::Verbose, Fmt("Highest supported shader model: 0x%02x", highestShaderModel));
+        ALXR_LOG_VERBOSE(Fmt("Highest supported shader model: 0x%02x", highestShaderModel));
 
         D3D12_FEATURE_DATA_D3D12_OPTIONS3 options {
             .ViewInstancingTier = D3D12_VIEW_INSTANCING_TIER_NOT_SUPPORTED
@@ -373,12 +373,12 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
             m_isMultiViewSupported = 
                 highestShaderModel >= D3D_SHADER_MODEL_6_1 &&
                 options.ViewInstancingTier != D3D12_VIEW_INSTANCING_TIER_NOT_SUPPORTED;
-            Log::Write(Log::Level::Verbose, Fmt("D3D12 View-instancing tier: %d", options.ViewInstancingTier));
+            ALXR_LOG_VERBOSE(Fmt("D3D12 View-instancing tier: %d", options.ViewInstancingTier));
         }
 
         CoreShaders::Path smDir{ "SM5" };
         if (m_isMultiViewSupported) {
-            Log::Write(Log::Level::Verbose, "Setting SM6 core (multi-view) shaders.");
+            ALXR_LOG_VERBOSE("Setting SM6 core (multi-view) shaders.");
             smDir = "multiview";
         }
         m_coreShaders = smDir;
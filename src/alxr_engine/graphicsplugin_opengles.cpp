@@ -12,6 +12,7 @@
 
 #include "common/gfxwrapper_opengl.h"
 #include <common/xr_linear.h>
+#include "gl_video_renderer.h"
 
 namespace {
 
@@ -31,6 +32,25 @@ static const char* VertexShaderGlsl = R"_(#version 320 es
     }
     )_";
 
+// The version statement has come on first line.
+// GL_OVR_multiview2 variant of VertexShaderGlsl, gl_ViewID_OVR selects the view's transform.
+static const char* MultiViewVertexShaderGlsl = R"_(#version 320 es
+    #extension GL_OVR_multiview2 : require
+    layout(num_views = 2) in;
+
+    in vec3 VertexPos;
+    in vec3 VertexColor;
+
+    out vec3 PSVertexColor;
+
+    uniform mat4 ModelViewProjection[2];
+
+    void main() {
+       gl_Position = ModelViewProjection[gl_ViewID_OVR] * vec4(VertexPos, 1.0);
+       PSVertexColor = VertexColor;
+    }
+    )_";
+
 // The version statement has come on first line.
 static const char* FragmentShaderGlsl = R"_(#version 320 es
 
@@ -58,6 +78,9 @@ struct OpenGLESGraphicsPlugin : public IGraphicsPlugin {
         if (m_program != 0) {
             glDeleteProgram(m_program);
         }
+        if (m_multiViewProgram != 0) {
+            glDeleteProgram(m_multiViewProgram);
+        }
         if (m_vao != 0) {
             glDeleteVertexArrays(1, &m_vao);
         }
@@ -74,6 +97,8 @@ struct OpenGLESGraphicsPlugin : public IGraphicsPlugin {
             }
         }
 
+        m_videoRenderer.Destroy();
+
         ksGpuWindow_Destroy(&window);
     }
 
@@ -119,6 +144,8 @@ struct OpenGLESGraphicsPlugin : public IGraphicsPlugin {
         }
 
         m_contextApiMajorVersion = major;
+        // without it OpenXrProgram falls back to a swapchain & draw per view.
+        m_isMultiViewSupported = GlCheckExtension("GL_OVR_multiview2") && glFramebufferTextureMultiviewOVR != nullptr;
 
 #if defined(XR_USE_PLATFORM_ANDROID)
         m_graphicsBinding.display = window.display;
@@ -166,6 +193,10 @@ struct OpenGLESGraphicsPlugin : public IGraphicsPlugin {
         m_vertexAttribCoords = glGetAttribLocation(m_program, "VertexPos");
         m_vertexAttribColor = glGetAttribLocation(m_program, "VertexColor");
 
+        if (m_isMultiViewSupported) {
+            InitializeMultiViewProgram();
+        }
+
         glGenBuffers(1, &m_cubeVertexBuffer);
         glBindBuffer(GL_ARRAY_BUFFER, m_cubeVertexBuffer);
         glBufferData(GL_ARRAY_BUFFER, sizeof(Geometry::c_cubeVertices), Geometry::c_cubeVertices, GL_STATIC_DRAW);
@@ -183,6 +214,39 @@ struct OpenGLESGraphicsPlugin : public IGraphicsPlugin {
         glVertexAttribPointer(m_vertexAttribCoords, 3, GL_FLOAT, GL_FALSE, sizeof(Geometry::Vertex), nullptr);
         glVertexAttribPointer(m_vertexAttribColor, 3, GL_FLOAT, GL_FALSE, sizeof(Geometry::Vertex),
                               reinterpret_cast<const void*>(sizeof(XrVector3f)));
+
+        m_videoRenderer.Initialize({
+            .shaderVersion = "#version 320 es\n",
+            .isPersistentMappingSupported = GlCheckExtension("GL_EXT_buffer_storage"),
+            .isNorm16Supported = GlCheckExtension("GL_EXT_texture_norm16"),
+            .isMultiviewSupported = m_isMultiViewSupported
+        });
+    }
+
+    void InitializeMultiViewProgram() {
+        GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(vertexShader, 1, &MultiViewVertexShaderGlsl, nullptr);
+        glCompileShader(vertexShader);
+        CheckShader(vertexShader);
+
+        GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(fragmentShader, 1, &FragmentShaderGlsl, nullptr);
+        glCompileShader(fragmentShader);
+        CheckShader(fragmentShader);
+
+        m_multiViewProgram = glCreateProgram();
+        glAttachShader(m_multiViewProgram, vertexShader);
+        glAttachShader(m_multiViewProgram, fragmentShader);
+        // same attribute locations as m_program so both share the cube vao.
+        glBindAttribLocation(m_multiViewProgram, static_cast<GLuint>(m_vertexAttribCoords), "VertexPos");
+        glBindAttribLocation(m_multiViewProgram, static_cast<GLuint>(m_vertexAttribColor), "VertexColor");
+        glLinkProgram(m_multiViewProgram);
+        CheckProgram(m_multiViewProgram);
+
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+
+        m_multiViewModelViewProjectionUniformLocation = glGetUniformLocation(m_multiViewProgram, "ModelViewProjection");
     }
 
     void CheckShader(GLuint shader) {
@@ -247,7 +311,7 @@ struct OpenGLESGraphicsPlugin : public IGraphicsPlugin {
         return swapchainImageBase;
     }
 
-    uint32_t GetDepthTexture(uint32_t colorTexture) {
+    uint32_t GetDepthTexture(uint32_t colorTexture, const bool isTextureArray = false) {
         // If a depth-stencil view has already been created for this back-buffer, use it.
         auto depthBufferIt = m_colorToDepthMap.find(colorTexture);
         if (depthBufferIt != m_colorToDepthMap.end()) {
@@ -256,26 +320,49 @@ struct OpenGLESGraphicsPlugin : public IGraphicsPlugin {
 
         // This back-buffer has no corresponding depth-stencil texture, so create one with matching dimensions.
 
+        const GLenum target = isTextureArray ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D;
         GLint width;
         GLint height;
-        glBindTexture(GL_TEXTURE_2D, colorTexture);
-        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
-        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+        GLint layers = 1;
+        glBindTexture(target, colorTexture);
+        glGetTexLevelParameteriv(target, 0, GL_TEXTURE_WIDTH, &width);
+        glGetTexLevelParameteriv(target, 0, GL_TEXTURE_HEIGHT, &height);
+        if (isTextureArray) {
+            glGetTexLevelParameteriv(target, 0, GL_TEXTURE_DEPTH, &layers);
+        }
 
         uint32_t depthTexture;
         glGenTextures(1, &depthTexture);
-        glBindTexture(GL_TEXTURE_2D, depthTexture);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width, height, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, nullptr);
+        glBindTexture(target, depthTexture);
+        glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        if (isTextureArray) {
+            glTexImage3D(target, 0, GL_DEPTH_COMPONENT24, width, height, layers, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, nullptr);
+        } else {
+            glTexImage2D(target, 0, GL_DEPTH_COMPONENT24, width, height, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, nullptr);
+        }
 
         m_colorToDepthMap.insert(std::make_pair(colorTexture, depthTexture));
 
         return depthTexture;
     }
 
+    static XrMatrix4x4f GetViewProjection(const XrCompositionLayerProjectionView& layerView) {
+        const auto& pose = layerView.pose;
+        XrMatrix4x4f proj;
+        XrMatrix4x4f_CreateProjectionFov(&proj, GRAPHICS_OPENGL_ES, layerView.fov, 0.05f, 100.0f);
+        XrMatrix4x4f toView;
+        XrVector3f scale{1.f, 1.f, 1.f};
+        XrMatrix4x4f_CreateTranslationRotationScale(&toView, &pose.position, &pose.orientation, &scale);
+        XrMatrix4x4f view;
+        XrMatrix4x4f_InvertRigidBody(&view, &toView);
+        XrMatrix4x4f vp;
+        XrMatrix4x4f_Multiply(&vp, &proj, &view);
+        return vp;
+    }
+
     void RenderView
     (
         const XrCompositionLayerProjectionView& layerView, const XrSwapchainImageBaseHeader* swapchainImage,
@@ -312,16 +399,7 @@ struct OpenGLESGraphicsPlugin : public IGraphicsPlugin {
         // Set shaders and uniform variables.
         glUseProgram(m_program);
 
-        const auto& pose = layerView.pose;
-        XrMatrix4x4f proj;
-        XrMatrix4x4f_CreateProjectionFov(&proj, GRAPHICS_OPENGL_ES, layerView.fov, 0.05f, 100.0f);
-        XrMatrix4x4f toView;
-        XrVector3f scale{1.f, 1.f, 1.f};
-        XrMatrix4x4f_CreateTranslationRotationScale(&toView, &pose.position, &pose.orientation, &scale);
-        XrMatrix4x4f view;
-        XrMatrix4x4f_InvertRigidBody(&view, &toView);
-        XrMatrix4x4f vp;
-        XrMatrix4x4f_Multiply(&vp, &proj, &view);
+        const XrMatrix4x4f vp = GetViewProjection(layerView);
 
         // Set cube primitive data.
         glBindVertexArray(m_vao);
@@ -344,12 +422,162 @@ struct OpenGLESGraphicsPlugin : public IGraphicsPlugin {
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
     }
 
+    void RenderMultiView
+    (
+        const std::array<XrCompositionLayerProjectionView, 2>& layerViews, const XrSwapchainImageBaseHeader* swapchainImage,
+        const std::int64_t /*swapchainFormat*/, const PassthroughMode /*newMode*/,
+        const std::vector<Cube>& cubes
+    ) override {
+        CHECK(m_isMultiViewSupported);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, m_swapchainFramebuffer);
+
+        const uint32_t colorTexture = reinterpret_cast<const XrSwapchainImageOpenGLESKHR*>(swapchainImage)->image;
+
+        // both views share the image rect of a 2-layer texture array.
+        const auto& imageRect = layerViews[0].subImage.imageRect;
+        glViewport(static_cast<GLint>(imageRect.offset.x), static_cast<GLint>(imageRect.offset.y),
+                   static_cast<GLsizei>(imageRect.extent.width), static_cast<GLsizei>(imageRect.extent.height));
+
+        glFrontFace(GL_CW);
+        glCullFace(GL_BACK);
+        glEnable(GL_CULL_FACE);
+        glEnable(GL_DEPTH_TEST);
+
+        const uint32_t depthTexture = GetDepthTexture(colorTexture, true);
+
+        glFramebufferTextureMultiviewOVR(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, colorTexture, 0, 0, 2);
+        glFramebufferTextureMultiviewOVR(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthTexture, 0, 0, 2);
+
+        // Clear swapchain and depth buffer.
+        glClearColor(m_clearColor[0], m_clearColor[1], m_clearColor[2], m_clearColor[3]);
+        glClearDepthf(1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+        glUseProgram(m_multiViewProgram);
+
+        const std::array<XrMatrix4x4f, 2> vp { GetViewProjection(layerViews[0]), GetViewProjection(layerViews[1]) };
+
+        glBindVertexArray(m_vao);
+
+        // Render each cube, once for both views.
+        for (const Cube& cube : cubes) {
+            XrMatrix4x4f model;
+            XrMatrix4x4f_CreateTranslationRotationScale(&model, &cube.Pose.position, &cube.Pose.orientation, &cube.Scale);
+            std::array<XrMatrix4x4f, 2> mvp;
+            XrMatrix4x4f_Multiply(&mvp[0], &vp[0], &model);
+            XrMatrix4x4f_Multiply(&mvp[1], &vp[1], &model);
+            glUniformMatrix4fv(m_multiViewModelViewProjectionUniformLocation, 2, GL_FALSE, reinterpret_cast<const GLfloat*>(mvp.data()));
+
+            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(ArraySize(Geometry::c_cubeIndices)), GL_UNSIGNED_SHORT, nullptr);
+        }
+
+        glBindVertexArray(0);
+        glUseProgram(0);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    virtual bool IsMultiViewEnabled() const override {
+        return m_isMultiViewSupported;
+    }
+
     uint32_t GetSupportedSwapchainSampleCount(const XrViewConfigurationView&) override { return 1; }
 
     inline void SetEnvironmentBlendMode(const XrEnvironmentBlendMode newMode) {
         m_clearColorIndex = (newMode - 1);
     }
 
+    // Video stream, see GLVideoRenderer. ////////////////////////////////////////////////////////////////
+
+    virtual void ClearVideoTextures() override {
+        m_videoRenderer.RequestTextures(0, 0, XrPixelFormat::Uknown);
+    }
+
+    virtual void CreateVideoTextures(const std::size_t width, const std::size_t height, const XrPixelFormat pixfmt) override {
+        m_videoRenderer.RequestTextures(width, height, pixfmt);
+    }
+
+    virtual void UpdateVideoTexture(const YUVBuffer& yuvBuffer) override {
+        m_videoRenderer.Update(yuvBuffer);
+    }
+
+    virtual void BeginVideoView() override {
+        m_videoRenderer.BeginView();
+    }
+
+    virtual std::uint64_t GetVideoFrameIndex() const override {
+        return m_videoRenderer.GetFrameIndex();
+    }
+
+    virtual void RenderVideoView
+    (
+        const std::uint32_t viewID, const XrCompositionLayerProjectionView& layerView,
+        const XrSwapchainImageBaseHeader* swapchainImage, const std::int64_t /*swapchainFormat*/,
+        const PassthroughMode newMode /*= PassthroughMode::None*/
+    ) override {
+        CHECK(layerView.subImage.imageArrayIndex == 0);  // Texture arrays not supported.
+
+        glBindFramebuffer(GL_FRAMEBUFFER, m_swapchainFramebuffer);
+
+        const uint32_t colorTexture = reinterpret_cast<const XrSwapchainImageOpenGLESKHR*>(swapchainImage)->image;
+
+        glViewport(static_cast<GLint>(layerView.subImage.imageRect.offset.x),
+                   static_cast<GLint>(layerView.subImage.imageRect.offset.y),
+                   static_cast<GLsizei>(layerView.subImage.imageRect.extent.width),
+                   static_cast<GLsizei>(layerView.subImage.imageRect.extent.height));
+
+        glDisable(GL_CULL_FACE);
+        glDisable(GL_DEPTH_TEST);
+
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, 0, 0);
+
+        const std::size_t clearColorIndex = newMode == PassthroughMode::None ? m_clearColorIndex : 3;
+        glClearColor(0.0f, 0.0f, 0.0f, ALXR::GLVideoRenderer::ClearAlpha[clearColorIndex]);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        m_videoRenderer.RenderView(viewID, newMode);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    virtual void RenderVideoMultiView
+    (
+        const std::array<XrCompositionLayerProjectionView, 2>& layerViews,
+        const XrSwapchainImageBaseHeader* swapchainImage, const std::int64_t /*swapchainFormat*/,
+        const PassthroughMode newMode /*= PassthroughMode::None*/
+    ) override {
+        CHECK(m_isMultiViewSupported);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, m_swapchainFramebuffer);
+
+        const uint32_t colorTexture = reinterpret_cast<const XrSwapchainImageOpenGLESKHR*>(swapchainImage)->image;
+
+        const auto& imageRect = layerViews[0].subImage.imageRect;
+        glViewport(static_cast<GLint>(imageRect.offset.x), static_cast<GLint>(imageRect.offset.y),
+                   static_cast<GLsizei>(imageRect.extent.width), static_cast<GLsizei>(imageRect.extent.height));
+
+        glDisable(GL_CULL_FACE);
+        glDisable(GL_DEPTH_TEST);
+
+        glFramebufferTextureMultiviewOVR(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, colorTexture, 0, 0, 2);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, 0, 0);
+
+        const std::size_t clearColorIndex = newMode == PassthroughMode::None ? m_clearColorIndex : 3;
+        glClearColor(0.0f, 0.0f, 0.0f, ALXR::GLVideoRenderer::ClearAlpha[clearColorIndex]);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        m_videoRenderer.RenderMultiView(newMode);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    virtual void SetEnableLinearizeRGB(const bool enable) override {
+        m_videoRenderer.SetEnableLinearizeRGB(enable);
+    }
+
+    virtual void SetFoveatedDecode(const ALXR::FoveatedDecodeParams* fovDecParm) override {
+        m_videoRenderer.SetFoveatedDecode(fovDecParm);
+    }
+
    private:
 #ifdef XR_USE_PLATFORM_ANDROID
     XrGraphicsBindingOpenGLESAndroidKHR m_graphicsBinding{XR_TYPE_GRAPHICS_BINDING_OPENGL_ES_ANDROID_KHR};
@@ -359,6 +587,9 @@ struct OpenGLESGraphicsPlugin : public IGraphicsPlugin {
     GLuint m_swapchainFramebuffer{0};
     GLuint m_program{0};
     GLint m_modelViewProjectionUniformLocation{0};
+    GLuint m_multiViewProgram{0};
+    GLint m_multiViewModelViewProjectionUniformLocation{0};
+    bool m_isMultiViewSupported{false};
     GLint m_vertexAttribCoords{0};
     GLint m_vertexAttribColor{0};
     GLuint m_vao{0};
@@ -372,6 +603,8 @@ struct OpenGLESGraphicsPlugin : public IGraphicsPlugin {
     // Map color buffer to associated depth buffer. This map is populated on demand.
     std::map<uint32_t, uint32_t> m_colorToDepthMap;
     const std::array<float, 4> m_clearColor;
+
+    ALXR::GLVideoRenderer m_videoRenderer{};
 };
 }  // namespace
 
@@ -16,10 +16,15 @@
 #endif
 
 #include <common/xr_linear.h>
+#include <cstdlib>
 #include <cstring>
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <mutex>
+#include <deque>
+#include <filesystem>
+#include <fstream>
 
 #ifdef USE_ONLINE_VULKAN_SHADERC
 #include <shaderc/shaderc.hpp>
@@ -56,6 +61,8 @@
 #include "concurrent_queue.h"
 #include "timing.h"
 #include "foveation.h"
+#include "plane_copy.h"
+#include "video_frame_mailbox.h"
 
 namespace {
 
@@ -585,8 +592,8 @@ struct CmdBuffer {
     }
 
     bool Wait() {
-        // Waiting on a not-in-flight command buffer is a no-op
-        if (state == CmdBufferState::Initialized) {
+        // Waiting on a not-in-flight (or already waited on) command buffer is a no-op
+        if (state == CmdBufferState::Initialized || state == CmdBufferState::Executable) {
             return true;
         }
 
@@ -1496,7 +1503,18 @@ struct RenderPass {
         const bool isMultiView = arraySize > 1;
 
         // Subpass dependencies for layout transitions
-        constexpr static const std::array<const VkSubpassDependency, 1> dependencies {
+        constexpr static const std::array<const VkSubpassDependency, 2> dependencies {
+            // The depth buffer is shared by every image of a swapchain, with multiple frames
+            // in-flight the clear/writes must wait on the previous frame's depth writes.
+            VkSubpassDependency {
+                .srcSubpass      = VK_SUBPASS_EXTERNAL,
+                .dstSubpass      = 0,
+                .srcStageMask    = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                .dstStageMask    = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                .srcAccessMask   = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                .dstAccessMask   = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                .dependencyFlags = 0
+            },
             VkSubpassDependency {
                 .srcSubpass      = VK_SUBPASS_EXTERNAL,
                 .dstSubpass      = 0,
@@ -1541,8 +1559,8 @@ struct RenderPass {
             .pAttachments = at.data(),
             .subpassCount = 1,
             .pSubpasses = &subpass,
-            .dependencyCount = isMultiView ? (std::uint32_t)dependencies.size() : 0,
-            .pDependencies = isMultiView ? dependencies.data() : nullptr
+            .dependencyCount = isMultiView ? (std::uint32_t)dependencies.size() : 1,
+            .pDependencies = dependencies.data()
         };
         VkAttachmentReference colorRef {
             .attachment = 0,
@@ -1945,7 +1963,7 @@ struct Pipeline {
     //void Dynamic(VkDynamicState state) { dynamicStateEnables.emplace_back(state); }
 
     void Create(VkDevice device, VkExtent2D size, const PipelineLayout& layout, const RenderPass& rp, const ShaderProgram& sp,
-                const VertexBufferBase& vb) {
+                const VertexBufferBase& vb, VkPipelineCache pipelineCache = VK_NULL_HANDLE) {
         m_vkDevice = device;
 
         const VkPipelineDynamicStateCreateInfo dynamicState {
@@ -2067,7 +2085,7 @@ struct Pipeline {
             .renderPass = rp.pass,
             .subpass = 0,
         };
-        CHECK_VKCMD(vkCreateGraphicsPipelines(m_vkDevice, VK_NULL_HANDLE, 1, &pipeInfo, nullptr, &pipe));
+        CHECK_VKCMD(vkCreateGraphicsPipelines(m_vkDevice, pipelineCache, 1, &pipeInfo, nullptr, &pipe));
     }
 
     void Clear() {
@@ -2085,6 +2103,189 @@ private:
     VkDevice m_vkDevice{VK_NULL_HANDLE};
 };
 
+// Directory the pipeline cache is persisted to, empty if there is no writable location.
+inline std::filesystem::path GetPipelineCacheDir() {
+    using Path = std::filesystem::path;
+#if defined(XR_USE_PLATFORM_ANDROID)
+    // No JNI env available here to query Context.getCacheDir, the process name is the package name
+    // (optionally suffixed with ":<process>") which gives the app's private cache dir.
+    std::ifstream cmdline("/proc/self/cmdline", std::ios::in | std::ios::binary);
+    std::string packageName;
+    std::getline(cmdline, packageName, '\0');
+    packageName = packageName.substr(0, packageName.find(':'));
+    if (packageName.empty())
+        return {};
+    return Path{ "/data/data" } / packageName / "cache";
+#else
+#if defined(XR_USE_PLATFORM_WIN32)
+    if (const char* const localAppData = std::getenv("LOCALAPPDATA"))
+        return Path{ localAppData } / "alxr";
+#else
+    if (const char* const xdgCacheHome = std::getenv("XDG_CACHE_HOME"))
+        return Path{ xdgCacheHome } / "alxr";
+    if (const char* const home = std::getenv("HOME"))
+        return Path{ home } / ".cache" / "alxr";
+#endif
+    std::error_code ec;
+    const auto tempDir = std::filesystem::temp_directory_path(ec);
+    return ec ? Path{} : tempDir / "alxr";
+#endif
+}
+
+// VkPipelineCache persisted to disk, the driver blob is prefixed with a header identifying the device
+// & driver that produced it so stale caches (driver updates, different GPU) are discarded on load.
+struct PipelineCache {
+    using Path = std::filesystem::path;
+    using UUID = std::array<std::uint8_t, VK_UUID_SIZE>;
+    VkPipelineCache cache{VK_NULL_HANDLE};
+
+    PipelineCache() = default;
+    ~PipelineCache() { Clear(); }
+
+    PipelineCache(const PipelineCache&) = delete;
+    PipelineCache& operator=(const PipelineCache&) = delete;
+    PipelineCache(PipelineCache&&) = delete;
+    PipelineCache& operator=(PipelineCache&&) = delete;
+
+    void Create(VkDevice device, const VkPhysicalDeviceProperties& deviceProps, const UUID& deviceUUID, const Path& cacheFile) {
+        CHECK(device != VK_NULL_HANDLE);
+        Clear();
+        m_vkDevice = device;
+        m_cacheFile = cacheFile;
+        m_key = {
+            .vendorID = deviceProps.vendorID,
+            .deviceID = deviceProps.deviceID,
+            .driverVersion = deviceProps.driverVersion,
+            .pipelineCacheUUID = {},
+            .deviceUUID = deviceUUID,
+        };
+        std::memcpy(m_key.pipelineCacheUUID.data(), deviceProps.pipelineCacheUUID, VK_UUID_SIZE);
+
+        const auto initialData = Load();
+        VkPipelineCacheCreateInfo createInfo {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = 0,
+            .initialDataSize = initialData.size(),
+            .pInitialData = initialData.empty() ? nullptr : initialData.data()
+        };
+        if (vkCreatePipelineCache(m_vkDevice, &createInfo, nullptr, &cache) != VK_SUCCESS) {
+            CHECK(!initialData.empty());
+            Log::Write(Log::Level::Warning, "Vulkan: pipeline cache data rejected by the driver, starting with an empty cache.");
+            createInfo.initialDataSize = 0;
+            createInfo.pInitialData = nullptr;
+            CHECK_VKCMD(vkCreatePipelineCache(m_vkDevice, &createInfo, nullptr, &cache));
+        }
+        m_savedSize = initialData.size();
+        Log::Write(Log::Level::Info, Fmt("Vulkan: pipeline cache \"%s\", %zu bytes loaded.", m_cacheFile.string().c_str(), initialData.size()));
+    }
+
+    // Writes the cache back to disk if it has grown since it was last loaded/saved.
+    bool Save() {
+        if (m_vkDevice == VK_NULL_HANDLE || cache == VK_NULL_HANDLE || m_cacheFile.empty())
+            return false;
+        std::size_t dataSize = 0;
+        if (vkGetPipelineCacheData(m_vkDevice, cache, &dataSize, nullptr) != VK_SUCCESS || dataSize == m_savedSize)
+            return false;
+        std::vector<std::uint8_t> data(dataSize);
+        if (vkGetPipelineCacheData(m_vkDevice, cache, &dataSize, data.data()) != VK_SUCCESS)
+            return false;
+
+        std::error_code ec;
+        std::filesystem::create_directories(m_cacheFile.parent_path(), ec);
+        // write to a temporary & rename so a crash mid-write never leaves a truncated cache behind.
+        auto tmpFile = m_cacheFile;
+        tmpFile += ".tmp";
+        {
+            std::ofstream outFile(tmpFile, std::ios::out | std::ios::binary | std::ios::trunc);
+            const FileHeader header {
+                .magic = FileMagic,
+                .version = FileVersion,
+                .key = m_key,
+                .dataSize = dataSize
+            };
+            outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            outFile.write(reinterpret_cast<const char*>(data.data()), dataSize);
+            if (!outFile) {
+                Log::Write(Log::Level::Warning, Fmt("Vulkan: failed to write pipeline cache \"%s\"", tmpFile.string().c_str()));
+                return false;
+            }
+        }
+        std::filesystem::rename(tmpFile, m_cacheFile, ec);
+        if (ec) {
+            Log::Write(Log::Level::Warning, Fmt("Vulkan: failed to write pipeline cache \"%s\", reason: %s", m_cacheFile.string().c_str(), ec.message().c_str()));
+            std::filesystem::remove(tmpFile, ec);
+            return false;
+        }
+        m_savedSize = dataSize;
+        ALXR_LOG_VERBOSE(Fmt("Vulkan: pipeline cache saved, %zu bytes.", dataSize));
+        return true;
+    }
+
+    void Clear() {
+        if (m_vkDevice != VK_NULL_HANDLE && cache != VK_NULL_HANDLE) {
+            vkDestroyPipelineCache(m_vkDevice, cache, nullptr);
+        }
+        cache = VK_NULL_HANDLE;
+        m_vkDevice = VK_NULL_HANDLE;
+        m_savedSize = 0;
+    }
+
+private:
+    struct Key {
+        std::uint32_t vendorID;
+        std::uint32_t deviceID;
+        std::uint32_t driverVersion;
+        UUID pipelineCacheUUID;
+        UUID deviceUUID;
+        bool operator==(const Key&) const = default;
+    };
+    struct FileHeader {
+        std::uint32_t magic;
+        std::uint32_t version;
+        Key key;
+        std::uint64_t dataSize;
+    };
+    static_assert(std::is_trivially_copyable_v<FileHeader>);
+    constexpr static const std::uint32_t FileMagic = 0x43505841; // "AXPC"
+    constexpr static const std::uint32_t FileVersion = 1;
+
+    std::vector<std::uint8_t> Load() const {
+        if (m_cacheFile.empty())
+            return {};
+        std::error_code ec;
+        const auto fileSize = std::filesystem::file_size(m_cacheFile, ec);
+        if (ec)
+            return {};
+        std::ifstream inFile(m_cacheFile, std::ios::in | std::ios::binary);
+        if (!inFile)
+            return {};
+        FileHeader header{};
+        if (fileSize < sizeof(header) ||
+            !inFile.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            header.magic != FileMagic || header.version != FileVersion ||
+            header.dataSize != fileSize - sizeof(header)) {
+            Log::Write(Log::Level::Warning, "Vulkan: ignoring invalid pipeline cache file.");
+            return {};
+        }
+        if (!(header.key == m_key)) {
+            Log::Write(Log::Level::Info, "Vulkan: pipeline cache was created by a different device/driver, discarding.");
+            return {};
+        }
+        std::vector<std::uint8_t> data(header.dataSize);
+        if (!inFile.read(reinterpret_cast<char*>(data.data()), data.size())) {
+            Log::Write(Log::Level::Warning, "Vulkan: ignoring truncated pipeline cache file.");
+            return {};
+        }
+        return data;
+    }
+
+    Key m_key{};
+    Path m_cacheFile{};
+    std::size_t m_savedSize = 0;
+    VkDevice m_vkDevice{VK_NULL_HANDLE};
+};
+
 struct DepthBuffer {
     VkDeviceMemory depthMemory{VK_NULL_HANDLE};
     VkImage depthImage{VK_NULL_HANDLE};
@@ -2208,7 +2409,8 @@ struct SwapchainImageContext {
     (
         VkDevice device, MemoryAllocator* memAllocator, uint32_t capacity,
         const XrSwapchainCreateInfo& swapchainCreateInfo, const PipelineLayout& layout,
-        const ShaderProgram& sp, const VertexBuffer<Geometry::Vertex>& vb
+        const ShaderProgram& sp, const VertexBuffer<Geometry::Vertex>& vb,
+        VkPipelineCache pipelineCache = VK_NULL_HANDLE
     )
     {
         m_vkDevice = device;
@@ -2222,7 +2424,7 @@ struct SwapchainImageContext {
         
         depthBuffer.Create(m_vkDevice, memAllocator, depthFormat, swapchainCreateInfo);
         rp.Create(m_vkDevice, colorFormat, depthFormat, arraySize);
-        pipe.Create(m_vkDevice, size, layout, rp, sp, vb);
+        pipe.Create(m_vkDevice, size, layout, rp, sp, vb, pipelineCache);
 
         swapchainImages.resize(capacity);
         renderTarget.resize(capacity);
@@ -2618,6 +2820,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         };
         fpGetPhysicalDeviceProperties2(m_vkPhysicalDevice, &vkPhysicalDeviceProperties2);
 
+        m_vkDeviceProperties = vkPhysicalDeviceProperties2.properties;
         std::memcpy(m_vkDeviceUUID.data(), vkPhysicalDeviceIDProperties.deviceUUID, VK_UUID_SIZE);
 
         if (vkPhysicalDeviceIDProperties.deviceLUIDValid)
@@ -2805,7 +3008,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         if (multiviewFeature.multiview && multiviewProps.maxMultiviewViewCount > 1) {
             m_isMultiViewSupported = true;
             deviceExtensions.push_back(VK_KHR_MULTIVIEW_EXTENSION_NAME);            
-            Log::Write(Log::Level::Verbose, Fmt(
+            ALXR_LOG_VERBOSE(Fmt(
                 "VulkanGraphicsPlugin: Multiview features:\n"
                 "\tmultiview: %s\n"
                 "\tmultiviewGeometryShader: %s\n"
@@ -2813,7 +3016,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
                 multiviewFeature.multiview ? "true" : "false",
                 multiviewFeature.multiviewGeometryShader ? "true" : "false",
                 multiviewFeature.multiviewTessellationShader ? "true" : "false"));
-            Log::Write(Log::Level::Verbose, Fmt(
+            ALXR_LOG_VERBOSE(Fmt(
                 "VulkanGraphicsPlugin: Multiview properties:\n"
                 "\tmaxMultiviewViewCount: %d\n"
                 "\tmaxMultiviewInstanceIndex: %d",
@@ -2823,9 +3026,21 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
 
         VkPhysicalDeviceFeatures features{};
         // features.samplerAnisotropy = VK_TRUE;
+#ifndef XR_USE_PLATFORM_ANDROID
+        // video uploads & rendering are ordered with timeline semaphores (m_texCopy/m_texRendereComplete).
+        VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineSemaphoreFeatures {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR,
+            .pNext = nullptr,
+            .timelineSemaphore = VK_TRUE
+        };
+#endif
         VkPhysicalDeviceVulkan11Features features11 {
             .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES,
+#ifndef XR_USE_PLATFORM_ANDROID
+            .pNext = &timelineSemaphoreFeatures,
+#else
             .pNext = nullptr,
+#endif
             .multiview = m_isMultiViewSupported ? VK_TRUE : VK_FALSE,
             .samplerYcbcrConversion = VK_TRUE,
         };
@@ -2915,7 +3130,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
 #endif
         // Create the Direct3D 11 API device object and a corresponding context.
         D3D_DRIVER_TYPE driverType = ((adapter == nullptr) ? D3D_DRIVER_TYPE_HARDWARE : D3D_DRIVER_TYPE_UNKNOWN);
-        Log::Write(Log::Level::Verbose, Fmt("Selected driver type: %d", static_cast<int>(driverType)));
+        ALXR_LOG_VERBOSE(Fmt("Selected driver type: %d", static_cast<int>(driverType)));
 
     TryAgain:
         const HRESULT hr = D3D11CreateDevice
@@ -3054,7 +3269,9 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             }
         }
 
-        if (!m_videoCpyCmdBuffer.Init(m_vkDevice, m_queueFamilyIndexVideoCpy)) THROW("Failed to create command buffer");
+        for (auto& videoCpyCmdBuffer : m_videoCpyCmdBuffers) {
+            if (!videoCpyCmdBuffer.Init(m_vkDevice, m_queueFamilyIndexVideoCpy)) THROW("Failed to create command buffer");
+        }
 
         m_quadBuffer.Init(m_vkDevice, &m_memAllocator,
             { {0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Geometry::QuadVertex, position)},
@@ -3068,7 +3285,20 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
 
     using CodeBuffer = ShaderProgram::CodeBuffer;
 
+    void InitializePipelineCache() {
+        PipelineCache::Path cacheFile{};
+        if (const auto cacheDir = GetPipelineCacheDir(); !cacheDir.empty()) {
+            std::string uuid;
+            for (const auto byte : m_vkDeviceUUID)
+                uuid += Fmt("%02x", byte);
+            cacheFile = cacheDir / ("vk_pipeline_cache_" + uuid + ".bin");
+        }
+        m_pipelineCache.Create(m_vkDevice, m_vkDeviceProperties, m_vkDeviceUUID, cacheFile);
+    }
+
     void InitializeResources() {
+        InitializePipelineCache();
+
 #ifdef USE_ONLINE_VULKAN_SHADERC
         auto vertexSPIRV = CompileGlslShader("vertex", shaderc_glsl_default_vertex_shader, VertexShaderGlsl);
         auto fragmentSPIRV = CompileGlslShader("fragment", shaderc_glsl_default_fragment_shader, FragmentShaderGlsl);
@@ -3104,8 +3334,6 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         m_shaderProgram.LoadVertexShader(vertexSPIRV);
         m_shaderProgram.LoadFragmentShader(fragmentSPIRV);
 
-        if (!m_cmdBuffer.Init(m_vkDevice, m_queueFamilyIndex)) THROW("Failed to create command buffer");
-
         m_pipelineLayout.Create(m_vkDevice, m_vkInstance, m_isMultiViewSupported);
 
         static_assert(sizeof(Geometry::Vertex) == 24, "Unexpected Vertex size");
@@ -3123,12 +3351,13 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
 #if defined(USE_MIRROR_WINDOW)
         m_swapchain.Create(m_vkInstance, m_vkPhysicalDevice, m_vkDevice, m_graphicsBinding.queueFamilyIndex);
 
-        m_cmdBuffer.Reset();
-        m_cmdBuffer.Begin();
-        m_swapchain.Prepare(m_cmdBuffer.buf);
-        m_cmdBuffer.End();
-        m_cmdBuffer.Exec(m_vkQueue);
-        m_cmdBuffer.Wait();
+        CmdBuffer setupCmdBuffer{};
+        if (!setupCmdBuffer.Init(m_vkDevice, m_queueFamilyIndex)) THROW("Failed to create command buffer");
+        setupCmdBuffer.Begin();
+        m_swapchain.Prepare(setupCmdBuffer.buf);
+        setupCmdBuffer.End();
+        setupCmdBuffer.Exec(m_vkQueue);
+        setupCmdBuffer.Wait();
 #endif
     }
 
@@ -3160,18 +3389,26 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         SwapchainImageContext& swapchainImageContext = m_swapchainImageContexts.back();
 
         std::vector<XrSwapchainImageBaseHeader*> bases = swapchainImageContext.Create(
-            m_vkDevice, &m_memAllocator, capacity, swapchainCreateInfo, m_pipelineLayout, m_shaderProgram, m_drawBuffer);
+            m_vkDevice, &m_memAllocator, capacity, swapchainCreateInfo, m_pipelineLayout, m_shaderProgram, m_drawBuffer,
+            m_pipelineCache.cache);
 
         // Map every swapchainImage base pointer to this context
         for (auto& base : bases) {
             m_swapchainImageContextMap[base] = &swapchainImageContext;
         }
 
+        // Allow as many frames in-flight as there are swapchain images.
+        while (m_frames.size() < capacity) {
+            auto& frame = m_frames.emplace_back();
+            if (!frame.cmdBuffer.Init(m_vkDevice, m_queueFamilyIndex)) THROW("Failed to create command buffer");
+        }
+
         return bases;
     }
 
     virtual void ClearSwapchainImageStructs() override
     {
+        WaitForFramesInFlight();
         m_swapchainImageContextMap.clear();
         m_swapchainImageContexts.clear();
     }
@@ -3189,6 +3426,62 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         XrMatrix4x4f_Multiply(&vp, &proj, &view);
     }
 
+    struct FrameContext;
+
+    virtual void BeginRenderViews() override
+    {
+        BeginFrame();
+        m_isBatchingViews = true;
+    }
+
+    virtual void EndRenderViews() override
+    {
+        m_isBatchingViews = false;
+        SubmitFrame();
+    }
+
+    // Starts recording the current frame if not already recording, only blocks on the GPU
+    // if every frame in-flight is still executing.
+    FrameContext& BeginFrame()
+    {
+        CHECK(!m_frames.empty());
+        auto& frame = m_frames[m_frameIndex];
+        if (m_isRecordingFrame)
+            return frame;
+        frame.cmdBuffer.Wait();
+        frame.cmdBuffer.Reset();
+        frame.retiredVideoTextures.clear();
+        frame.cmdBuffer.Begin();
+        m_isRecordingFrame = true;
+        return frame;
+    }
+
+    void SubmitFrame()
+    {
+        if (!m_isRecordingFrame)
+            return;
+        auto& cmdBuffer = m_frames[m_frameIndex].cmdBuffer;
+        cmdBuffer.End();
+#ifdef XR_USE_PLATFORM_ANDROID
+        cmdBuffer.Exec(m_vkQueue);
+#else
+        // Wait on the last submitted video upload & let the copy queue know when this frame is done sampling.
+        cmdBuffer.Exec<1, 1>(m_vkQueue, { &m_texRendereComplete }, { &m_texCopy }, { VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT });
+#endif
+        m_isRecordingFrame = false;
+        m_lastSubmittedFrame = m_frameIndex;
+        m_frameIndex = (m_frameIndex + 1) % m_frames.size();
+    }
+
+    void WaitForFramesInFlight()
+    {
+        SubmitFrame();
+        for (auto& frame : m_frames) {
+            frame.cmdBuffer.Wait();
+            frame.retiredVideoTextures.clear();
+        }
+    }
+
     template < typename RenderFunc >
     inline void RenderViewImpl(const XrSwapchainImageBaseHeader* swapchainImage, RenderFunc&& renderFun) {
 
@@ -3196,24 +3489,16 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         assert(swapchainContextPtr != nullptr);
         const std::uint32_t imageIndex = swapchainContextPtr->ImageIndex(swapchainImage);
 
-        m_cmdBuffer.Wait();
-        m_cmdBuffer.Reset();
-#ifdef XR_USE_PLATFORM_ANDROID
-        m_videoTextures[VidTextureIndex::DeferredDelete].Clear();
-#endif
-        m_cmdBuffer.Begin();
+        auto& cmdBuffer = BeginFrame().cmdBuffer;
 
         // Ensure depth is in the right layout
-        swapchainContextPtr->depthBuffer.TransitionLayout(&m_cmdBuffer, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+        swapchainContextPtr->depthBuffer.TransitionLayout(&cmdBuffer, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
 
-        renderFun(imageIndex, *swapchainContextPtr);
+        renderFun(imageIndex, *swapchainContextPtr, cmdBuffer);
 
-        m_cmdBuffer.End();
-#if 1 //#ifdef XR_USE_PLATFORM_ANDROID
-        m_cmdBuffer.Exec(m_vkQueue);
-#else
-        m_cmdBuffer.Exec<1, 1>(m_vkQueue, { &m_texRendereComplete }, { &m_texCopy }, { VK_PIPELINE_STAGE_ALL_COMMANDS_BIT });
-#endif
+        // Views rendered outside of Begin/EndRenderViews are submitted individually.
+        if (!m_isBatchingViews)
+            SubmitFrame();
 
 #if defined(USE_MIRROR_WINDOW)
         // Cycle the window's swapchain on the last view rendered
@@ -3291,7 +3576,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         const std::vector<Cube>& cubes
     ) override {
         assert(m_isMultiViewSupported);
-        RenderViewImpl(swapchainImage, [&, this](const std::uint32_t imageIndex, auto& swapchainContext)
+        RenderViewImpl(swapchainImage, [&, this](const std::uint32_t imageIndex, auto& swapchainContext, CmdBuffer& cmdBuffer)
         {
             const auto& clearValues = ConstClearValues[ClearValueIndex(newMode)];
             VkRenderPassBeginInfo renderPassBeginInfo{
@@ -3303,14 +3588,14 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             // Bind and clear eye render target
             swapchainContext.BindRenderTarget(imageIndex, /*out*/ renderPassBeginInfo);
 
-            vkCmdBeginRenderPass(m_cmdBuffer.buf, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+            vkCmdBeginRenderPass(cmdBuffer.buf, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
 
-            vkCmdBindPipeline(m_cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, swapchainContext.pipe.pipe);
+            vkCmdBindPipeline(cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, swapchainContext.pipe.pipe);
 
             // Bind index and vertex buffers
-            vkCmdBindIndexBuffer(m_cmdBuffer.buf, m_drawBuffer.idxBuf, 0, VK_INDEX_TYPE_UINT16);
+            vkCmdBindIndexBuffer(cmdBuffer.buf, m_drawBuffer.idxBuf, 0, VK_INDEX_TYPE_UINT16);
             constexpr const VkDeviceSize offset = 0;
-            vkCmdBindVertexBuffers(m_cmdBuffer.buf, 0, 1, &m_drawBuffer.vtxBuf, &offset);
+            vkCmdBindVertexBuffers(cmdBuffer.buf, 0, 1, &m_drawBuffer.vtxBuf, &offset);
 
             // Compute the view-projection transform.
             // Note all matrixes (including OpenXR's) are column-major, right-handed.
@@ -3328,13 +3613,13 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
                     XrMatrix4x4f_CreateTranslationRotationScale(&model, &cube.Pose.position, &cube.Pose.orientation, &cube.Scale);
                     XrMatrix4x4f_Multiply(&mvps.mvp[viewIndex], &vps[viewIndex], &model);
                 }
-                vkCmdPushConstants(m_cmdBuffer.buf, m_pipelineLayout.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(MultiViewProjectionUniform), &mvps);
+                vkCmdPushConstants(cmdBuffer.buf, m_pipelineLayout.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(MultiViewProjectionUniform), &mvps);
 
                 // Draw the cube.
-                vkCmdDrawIndexed(m_cmdBuffer.buf, m_drawBuffer.count.idx, 1, 0, 0, 0);
+                vkCmdDrawIndexed(cmdBuffer.buf, m_drawBuffer.count.idx, 1, 0, 0, 0);
             }
 
-            vkCmdEndRenderPass(m_cmdBuffer.buf);
+            vkCmdEndRenderPass(cmdBuffer.buf);
         });
     }
 
@@ -3345,7 +3630,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         const std::vector<Cube>& cubes
     ) override {
         assert(layerView.subImage.imageArrayIndex == 0);  // Texture arrays not supported.
-        RenderViewImpl(swapchainImage, [&, this](const std::uint32_t imageIndex, auto& swapchainContext)
+        RenderViewImpl(swapchainImage, [&, this](const std::uint32_t imageIndex, auto& swapchainContext, CmdBuffer& cmdBuffer)
         {
             const auto& clearValues = ConstClearValues[ClearValueIndex(newMode)];
             VkRenderPassBeginInfo renderPassBeginInfo{
@@ -3357,13 +3642,13 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             // Bind and clear eye render target
             swapchainContext.BindRenderTarget(imageIndex, /*out*/ renderPassBeginInfo);
 
-            vkCmdBeginRenderPass(m_cmdBuffer.buf, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
-            vkCmdBindPipeline(m_cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, swapchainContext.pipe.pipe);
+            vkCmdBeginRenderPass(cmdBuffer.buf, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+            vkCmdBindPipeline(cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, swapchainContext.pipe.pipe);
 
             // Bind index and vertex buffers
-            vkCmdBindIndexBuffer(m_cmdBuffer.buf, m_drawBuffer.idxBuf, 0, VK_INDEX_TYPE_UINT16);
+            vkCmdBindIndexBuffer(cmdBuffer.buf, m_drawBuffer.idxBuf, 0, VK_INDEX_TYPE_UINT16);
             constexpr const VkDeviceSize offset = 0;
-            vkCmdBindVertexBuffers(m_cmdBuffer.buf, 0, 1, &m_drawBuffer.vtxBuf, &offset);
+            vkCmdBindVertexBuffers(cmdBuffer.buf, 0, 1, &m_drawBuffer.vtxBuf, &offset);
 
             // Compute the view-projection transform.
             // Note all matrixes (including OpenXR's) are column-major, right-handed.
@@ -3377,13 +3662,13 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
                 XrMatrix4x4f_CreateTranslationRotationScale(&model, &cube.Pose.position, &cube.Pose.orientation, &cube.Scale);
                 XrMatrix4x4f mvp;
                 XrMatrix4x4f_Multiply(&mvp, &vp, &model);
-                vkCmdPushConstants(m_cmdBuffer.buf, m_pipelineLayout.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(mvp.m), &mvp.m[0]);
+                vkCmdPushConstants(cmdBuffer.buf, m_pipelineLayout.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(mvp.m), &mvp.m[0]);
 
                 // Draw the cube.
-                vkCmdDrawIndexed(m_cmdBuffer.buf, m_drawBuffer.count.idx, 1, 0, 0, 0);
+                vkCmdDrawIndexed(cmdBuffer.buf, m_drawBuffer.count.idx, 1, 0, 0, 0);
             }
 
-            vkCmdEndRenderPass(m_cmdBuffer.buf);
+            vkCmdEndRenderPass(cmdBuffer.buf);
         });
     }
 
@@ -3497,7 +3782,8 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         if (m_descriptorPool != VK_NULL_HANDLE ||
             m_vkDevice == VK_NULL_HANDLE)
             return;
-        const std::uint32_t swapChainCount = static_cast<uint32_t>(m_swapchainImageContexts.back().swapchainImages.size());
+        CHECK(!m_frames.empty());
+        const std::uint32_t swapChainCount = static_cast<uint32_t>(m_frames.size());
         
         const std::array<const VkDescriptorPoolSize, 1> poolSizes{
             VkDescriptorPoolSize {
@@ -3515,7 +3801,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         CHECK_VKCMD(vkCreateDescriptorPool(m_vkDevice, &poolInfo, nullptr, &m_descriptorPool));
         CHECK(m_descriptorPool != VK_NULL_HANDLE);
 
-        const std::vector<VkDescriptorSetLayout> layouts(swapChainCount, m_videoStreamLayout.descriptorSetLayout);
+        const std::vector<VkDescriptorSetLayout> layouts(swapChainCount, m_videoStream->layout.descriptorSetLayout);
         const VkDescriptorSetAllocateInfo allocInfo {
             .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
             .pNext = nullptr,
@@ -3525,8 +3811,37 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         };
         m_descriptorSets.resize(swapChainCount);
         CHECK_VKCMD(vkAllocateDescriptorSets(m_vkDevice, &allocInfo, m_descriptorSets.data()));
+        for (auto& frame : m_frames)
+            frame.boundVideoView = VK_NULL_HANDLE;
     }
 
+    using PipelineList = std::array<Pipeline, size_t(PassthroughMode::TypeCount)>;
+    // Everything a built video stream pipeline depends on.
+    struct VideoPipelineKey {
+        VkFormat format{ VK_FORMAT_UNDEFINED };
+        std::uint64_t externalFormat{ 0 };
+        VkSamplerYcbcrModelConversion ycbcrModel{};
+        VkSamplerYcbcrRange ycbcrRange{};
+        std::array<VkComponentSwizzle, 4> components{};
+        VkChromaLocation xChromaOffset{};
+        VkChromaLocation yChromaOffset{};
+        VkFilter chromaFilter{};
+        VkBool32 forceExplicitReconstruction{ VK_FALSE };
+        VkFormat colorFormat{ VK_FORMAT_UNDEFINED };
+        std::uint32_t width{ 0 };
+        std::uint32_t height{ 0 };
+        bool isMultiView{ false };
+        bool enableSRGBLinearize{ false };
+        bool enableFoveatedDecode{ false };
+        std::array<float, 8> fdParams{};
+        bool operator==(const VideoPipelineKey&) const = default;
+    };
+    struct VideoStreamPipeline {
+        VideoPipelineKey key{};
+        PipelineLayout layout{};
+        PipelineList pipelines{};
+    };
+
     struct alignas(16) SpecializationData {
         ALXR::FoveatedDecodeParams fdParams;
         VkBool32 enableSRGBLinearize;
@@ -3568,12 +3883,81 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         return specializationEMap;
     }
 
+    VideoPipelineKey MakeVideoPipelineKey(const VkSamplerYcbcrConversionCreateInfo& conversionInfo) const
+    {
+        CHECK(m_swapchainImageContexts.size() > 0);
+        const auto& swapChainInfo = m_swapchainImageContexts.back();
+        VideoPipelineKey key {
+            .format = conversionInfo.format,
+            .ycbcrModel = conversionInfo.ycbcrModel,
+            .ycbcrRange = conversionInfo.ycbcrRange,
+            .components {
+                conversionInfo.components.r, conversionInfo.components.g,
+                conversionInfo.components.b, conversionInfo.components.a
+            },
+            .xChromaOffset = conversionInfo.xChromaOffset,
+            .yChromaOffset = conversionInfo.yChromaOffset,
+            .chromaFilter = conversionInfo.chromaFilter,
+            .forceExplicitReconstruction = conversionInfo.forceExplicitReconstruction,
+            .colorFormat = swapChainInfo.rp.colorFmt,
+            .width = swapChainInfo.size.width,
+            .height = swapChainInfo.size.height,
+            .isMultiView = m_isMultiViewSupported,
+            .enableSRGBLinearize = m_enableSRGBLinearize,
+            .enableFoveatedDecode = m_fovDecodeParams != nullptr,
+        };
+#ifdef XR_USE_PLATFORM_ANDROID
+        for (auto next = reinterpret_cast<const VkBaseInStructure*>(conversionInfo.pNext); next != nullptr; next = next->pNext) {
+            if (next->sType == VK_STRUCTURE_TYPE_EXTERNAL_FORMAT_ANDROID)
+                key.externalFormat = reinterpret_cast<const VkExternalFormatANDROID*>(next)->externalFormat;
+        }
+#endif
+        if (const auto fdParams = m_fovDecodeParams) {
+            key.fdParams = {
+                fdParams->eyeSizeRatio.x, fdParams->eyeSizeRatio.y,
+                fdParams->centerSize.x,   fdParams->centerSize.y,
+                fdParams->centerShift.x,  fdParams->centerShift.y,
+                fdParams->edgeRatio.x,    fdParams->edgeRatio.y,
+            };
+        }
+        return key;
+    }
+
     void CreateVideoStreamPipeline(const VkSamplerYcbcrConversionCreateInfo& conversionInfo)
     {
         //ClearVideoTextures();
         /////////////////////////
-        assert(m_videoStreamLayout.IsNull());
-        m_videoStreamLayout.CreateVideoStreamLayout(conversionInfo, m_vkDevice, m_vkInstance, m_isMultiViewSupported);
+        assert(m_videoStream == nullptr);
+        const auto key = MakeVideoPipelineKey(conversionInfo);
+        const auto cachedItr = std::find_if(m_videoPipelineCache.begin(), m_videoPipelineCache.end(),
+            [&key](const VideoStreamPipeline& videoStream) { return videoStream.key == key; });
+        if (cachedItr != m_videoPipelineCache.end()) {
+            ALXR_LOG_VERBOSE("Stream config unchanged, re-binding cached video stream pipelines.");
+            m_videoPipelineCache.splice(m_videoPipelineCache.begin(), m_videoPipelineCache, cachedItr);
+            m_videoStream = &m_videoPipelineCache.front();
+            CreateImageDescriptorSetLayouts();
+            return;
+        }
+
+        if (m_videoPipelineCache.size() >= MaxCachedVideoPipelines)
+            m_videoPipelineCache.pop_back();
+        auto& videoStream = m_videoPipelineCache.emplace_front();
+        try {
+            CreateVideoStreamPipeline(conversionInfo, videoStream);
+        }
+        catch (...) {
+            m_videoPipelineCache.pop_front();
+            throw;
+        }
+        videoStream.key = key;
+        m_videoStream = &videoStream;
+        CreateImageDescriptorSetLayouts();
+        m_pipelineCache.Save();
+    }
+
+    void CreateVideoStreamPipeline(const VkSamplerYcbcrConversionCreateInfo& conversionInfo, VideoStreamPipeline& videoStream)
+    {
+        videoStream.layout.CreateVideoStreamLayout(conversionInfo, m_vkDevice, m_vkInstance, m_isMultiViewSupported);
                 
         const auto fovDecodeParamPtr = m_fovDecodeParams;
         const SpecializationData specializationConst {
@@ -3597,23 +3981,23 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         const auto& swapChainInfo = m_swapchainImageContexts.back();
         std::size_t pipelineIdx = 0;
         auto& shaderList = m_videoShaders[shaderType];
-        assert(shaderList.size() <= m_videoStreamPipelines.size());
+        assert(shaderList.size() <= videoStream.pipelines.size());
         for (auto& videoShader : shaderList) {
             auto& fragShaderInfo = videoShader.shaderInfo[1];
             fragShaderInfo.pSpecializationInfo = &speicalizationInfo;
-            m_videoStreamPipelines[pipelineIdx++].Create
+            videoStream.pipelines[pipelineIdx++].Create
             (
                 m_vkDevice,
                 swapChainInfo.size,
-                m_videoStreamLayout,
+                videoStream.layout,
                 swapChainInfo.rp,
                 videoShader,
-                m_quadBuffer
+                m_quadBuffer,
+                m_pipelineCache.cache
             );
             // null-out pSpecializationInfo as it refers to local stack vars.
             fragShaderInfo.pSpecializationInfo = nullptr;
         }
-        CreateImageDescriptorSetLayouts();
     }
 
     void CreateVideoStreamPipeline(const VkFormat pixFmt)
@@ -3649,77 +4033,116 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
     }
 
     constexpr static const std::size_t VideoQueueSize = 2;
+#ifdef XR_USE_PLATFORM_ANDROID
+    constexpr static const std::size_t VideoTexCount = 2;
+#else
+    // Triple buffered through m_videoMailbox: one slot being written by the decoder thread, one being
+    // sampled by the render thread & one holding the latest complete frame.
+    constexpr static const std::size_t VideoTexCount = 3;
+#endif
 
     virtual void ClearVideoTextures() override
     {
+        // video textures & descriptor sets are about to be destroyed.
+        WaitForFramesInFlight();
 #ifdef XR_ENABLE_CUDA_INTEROP
         ClearVideoTexturesCUDA();
 #endif
-        m_renderTex = std::size_t(-1);
+#ifndef XR_USE_PLATFORM_ANDROID
+        // staging buffers & textures may still be in use by in-flight uploads.
+        for (auto& videoCpyCmdBuffer : m_videoCpyCmdBuffers)
+            videoCpyCmdBuffer.Wait();
+#endif
+#ifdef XR_USE_PLATFORM_ANDROID
         m_currentVideoTex = 0;
-        
+#else
+        m_videoMailbox.Reset();
+        m_videoTexDesc = {};
+        m_requestedVideoFormat.store(VK_FORMAT_UNDEFINED, std::memory_order_relaxed);
+        m_boundVideoFormat.store(VK_FORMAT_UNDEFINED, std::memory_order_relaxed);
+        {
+            std::scoped_lock lk(m_retiredVideoTexMutex);
+            m_retiredVideoTextures.clear();
+        }
+#endif
+
         //m_texRendereComplete.WaitForGpu();
-        m_videoTextures = { VideoTexture {}, VideoTexture {} };
+        for (auto& videoTex : m_videoTextures)
+            videoTex = VideoTexture{};
 #ifdef XR_USE_PLATFORM_ANDROID
         m_videoTexQueue = VideoTextureQueue(VideoQueueSize);
-#else
-        m_lastTexIndex = std::size_t(-1);
-        textureIdx = std::size_t(-1);
 #endif
+        m_uploadStalls.Reset();
         ClearImageDescriptorSetLayouts();
-        for (auto& pipeline : m_videoStreamPipelines)
-            pipeline.Clear();
-        m_videoStreamLayout.Clear();
+        // pipelines are kept in m_videoPipelineCache, a new stream with the same config re-binds them.
+        m_videoStream = nullptr;
     }
 
     virtual void CreateVideoTextures(const std::size_t width, const std::size_t height, const XrPixelFormat pixfmt) override
     {
         const auto pixelFmt = MapFormat(pixfmt);
+#ifndef XR_USE_PLATFORM_ANDROID
+        if (m_videoTexDesc.format != VK_FORMAT_UNDEFINED) {
+            // Mid-stream size/format change, slots are re-created as the decoder thread next writes
+            // to them so the frame on display stays up until one of the new size is ready.
+            m_videoTexDesc = { .width = width, .height = height, .format = pixelFmt };
+            if (pixelFmt != m_boundVideoFormat.load(std::memory_order_acquire))
+                m_requestedVideoFormat.store(pixelFmt, std::memory_order_release);
+            return;
+        }
+        m_videoTexDesc = { .width = width, .height = height, .format = pixelFmt };
+        m_requestedVideoFormat.store(pixelFmt, std::memory_order_relaxed);
+        m_boundVideoFormat.store(pixelFmt, std::memory_order_release);
+#endif
         CreateVideoStreamPipeline(pixelFmt);
+        for (auto& vidTex : m_videoTextures)
+            CreateVideoTexture(vidTex, width, height, pixelFmt);
+    }
 
+    void CreateVideoTexture(VideoTexture& vidTex, const std::size_t width, const std::size_t height, const VkFormat pixelFmt)
+    {
         const VkDeviceSize texSize = StagingBufferSize(width, height, pixelFmt);
-        for (auto& vidTex : m_videoTextures)
-        {
-            vidTex.width = width;
-            vidTex.height = height;
-            vidTex.format = pixelFmt;
-            vidTex.stagingBufferSize = createStaggingBuffer
-            (
-                texSize,
-                VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                vidTex.stagingBuffer,
-                vidTex.stagingBufferMemory
-            );
-            vidTex.texture.Create
-            (
-                m_vkDevice, &m_memAllocator,
-                static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height),
-                pixelFmt, VK_IMAGE_TILING_LINEAR, VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT
-            );
-            CHECK(vidTex.texture.IsValid());
-            
-            const VkSamplerYcbcrConversionInfo ycbcrConverInfo {
-                .sType = VK_STRUCTURE_TYPE_SAMPLER_YCBCR_CONVERSION_INFO,
-                .pNext = nullptr,
-                .conversion = m_videoStreamLayout.ycbcrSamplerConversion
-            };
-            const VkImageViewCreateInfo viewInfo {
-                .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
-                .pNext = &ycbcrConverInfo,
-                .image = vidTex.texture.texImage,
-                .viewType = VK_IMAGE_VIEW_TYPE_2D,
-                .format = pixelFmt,
-                .subresourceRange {
-                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-                    .baseMipLevel = 0,
-                    .levelCount = 1,
-                    .baseArrayLayer = 0,
-                    .layerCount = 1,
-                }
-            };
-            CHECK_VKCMD(vkCreateImageView(m_vkDevice, &viewInfo, nullptr, &vidTex.imageView));
-        }
+        vidTex.width = width;
+        vidTex.height = height;
+        vidTex.format = pixelFmt;
+        vidTex.stagingBufferSize = createStaggingBuffer
+        (
+            texSize,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            vidTex.stagingBuffer,
+            vidTex.stagingBufferMemory
+        );
+        // Persistently mapped, host coherent so no flushes are needed after writing.
+        CHECK_VKCMD(vkMapMemory(m_vkDevice, vidTex.stagingBufferMemory, 0, vidTex.stagingBufferSize, 0, &vidTex.stagingBufferPtr));
+        vidTex.texture.Create
+        (
+            m_vkDevice, &m_memAllocator,
+            static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height),
+            pixelFmt, VK_IMAGE_TILING_LINEAR, VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT
+        );
+        CHECK(vidTex.texture.IsValid());
+        
+        const VkSamplerYcbcrConversionInfo ycbcrConverInfo {
+            .sType = VK_STRUCTURE_TYPE_SAMPLER_YCBCR_CONVERSION_INFO,
+            .pNext = nullptr,
+            .conversion = m_videoStream->layout.ycbcrSamplerConversion
+        };
+        const VkImageViewCreateInfo viewInfo {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .pNext = &ycbcrConverInfo,
+            .image = vidTex.texture.texImage,
+            .viewType = VK_IMAGE_VIEW_TYPE_2D,
+            .format = pixelFmt,
+            .subresourceRange {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel = 0,
+                .levelCount = 1,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            }
+        };
+        CHECK_VKCMD(vkCreateImageView(m_vkDevice, &viewInfo, nullptr, &vidTex.imageView));
     }
 
     virtual void CreateVideoTexturesMediaCodec(const std::size_t /*width*/, const std::size_t /*height*/, const XrPixelFormat /*pixfmt*/) override
@@ -3746,7 +4169,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             const VkSamplerYcbcrConversionInfo ycbcrConverInfo {
                 .sType = VK_STRUCTURE_TYPE_SAMPLER_YCBCR_CONVERSION_INFO,
                 .pNext = nullptr,
-                .conversion = m_videoStreamLayout.ycbcrSamplerConversion
+                .conversion = m_videoStream->layout.ycbcrSamplerConversion
             };
             const VkImageViewCreateInfo viewInfo{
                 .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
@@ -3834,7 +4257,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             const VkSamplerYcbcrConversionInfo ycbcrConverInfo {
                 .sType = VK_STRUCTURE_TYPE_SAMPLER_YCBCR_CONVERSION_INFO,
                 .pNext = nullptr,
-                .conversion = m_videoStreamLayout.ycbcrSamplerConversion
+                .conversion = m_videoStream->layout.ycbcrSamplerConversion
             };
             const VkImageViewCreateInfo viewInfo {
                 .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
@@ -3860,15 +4283,39 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
     bool WaitForAvailableBuffer()
     {
         //m_texRendereComplete.WaitForGpu();
-        //Log::Write(Log::Level::Info, Fmt("render idx: %d, copy idx: %d", m_renderTex.load(), m_currentVideoTex.load()));
         //CHECK_HRCMD(m_texRendereComplete.Wait(m_videoTexCmdCpyQueue));
         return true;
     }
 
     virtual void UpdateVideoTexture(const YUVBuffer& yuvBuffer) override
     {
-        const std::size_t freeIndex = m_currentVideoTex.load();
+#ifdef XR_USE_PLATFORM_ANDROID
+        const std::size_t freeIndex = m_currentVideoTex;
+#else
+        const std::size_t freeIndex = m_videoMailbox.AcquireWrite();
+        if (freeIndex == VideoFrameMailbox::NoSlot)
+            return;
+#endif
         auto& videoTex = m_videoTextures[freeIndex];
+        auto& cpyCmdBuffer = m_videoCpyCmdBuffers[freeIndex];
+
+        // Only blocks if this slot's previous upload has not finished on the GPU yet,
+        // with VideoTexCount slots in rotation that should be (close to) never.
+        {
+            const auto waitStart = GetSteadyTimestampUs();
+            cpyCmdBuffer.Wait();
+            m_uploadStalls.Add(GetSteadyTimestampUs() - waitStart);
+            if (m_uploadStalls.count == UploadStallLogInterval) {
+                ALXR_LOG_VERBOSE(Fmt("Video upload stalls, %s", m_uploadStalls.ToString().c_str()));
+                m_uploadStalls.Reset();
+            }
+        }
+#ifndef XR_USE_PLATFORM_ANDROID
+        if (!PrepareVideoTexture(freeIndex)) {
+            m_videoMailbox.CancelWrite(freeIndex);
+            return;
+        }
+#endif
 
         const bool has3Planes = yuvBuffer.chroma2.data != nullptr;
         const std::size_t lumaSize    = LumaSize(videoTex.format);
@@ -3880,64 +4327,35 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         const VkDeviceSize uPlaneOffset = textureSize * lumaSize;
         const VkDeviceSize vPlaneOffset = has3Planes ? uPlaneOffset + ((textureSize / 2) * chromaUSize) : 0;
 
-        void* data = nullptr;
-        vkMapMemory(m_vkDevice, videoTex.stagingBufferMemory, 0, videoTex.stagingBufferSize, 0, &data);
+        void* const data = videoTex.stagingBufferPtr;
+        assert(data != nullptr);
         {
-            constexpr const auto copy2d = []
-            (
-                std::uint8_t* dst, const std::uint8_t* src,
-                const std::size_t pitchInBytes, const std::size_t width, const std::size_t height, const std::size_t formatSize
-            )
+            const auto yPlanePtr = reinterpret_cast<std::uint8_t*>(data);
+            constexpr const auto makePlane = [](std::uint8_t* dst, const Buffer& src, const std::size_t width, const std::size_t formatSize)
             {
-                const std::size_t lineDstSize = width * formatSize;
-                if (lineDstSize == pitchInBytes) {
-                    //using namespace std::execution;
-                    //std::uninitialized_copy_n(par_unseq, src, lineDstSize * height, dst);
-                    std::memcpy(dst, src, lineDstSize * height);
-                    return;
-                }
-                for (std::size_t h = 0; h < height; ++h)
-                {
-                    auto lineDstPtr = dst + (lineDstSize * h);
-                    const auto lineSrcPtr = src + (pitchInBytes * h);
-                    std::memcpy(lineDstPtr, lineSrcPtr, lineDstSize);
-                    //std::copy_n(par_unseq, src, chromaLineSize, dst);
-                }
+                return ALXR::Plane2D {
+                    .dst = dst,
+                    .dstPitch = width * formatSize,
+                    .src = reinterpret_cast<const std::uint8_t*>(src.data),
+                    .srcPitch = src.pitch,
+                    .rowBytes = width * formatSize,
+                    .rows = src.height
+                };
             };
-
-            const auto& luma = yuvBuffer.luma;
-            const auto yPlanePtr = reinterpret_cast<std::uint8_t*>(data);               
-            copy2d
-            (
-                yPlanePtr, reinterpret_cast<const std::uint8_t*>(luma.data),
-                luma.pitch, videoTex.width, luma.height, lumaSize
-            );
-
-            const auto& chroma = yuvBuffer.chroma;
-            const auto uPlanePtr = yPlanePtr + uPlaneOffset;
-            copy2d
-            (
-                uPlanePtr, reinterpret_cast<const std::uint8_t*>(chroma.data),
-                chroma.pitch, videoTex.width / 2, chroma.height, chromaUSize
-            );
-
-            if (has3Planes)
-            {
-                const auto& chromaV = yuvBuffer.chroma2;
-                const auto vPlanePtr = yPlanePtr + vPlaneOffset;
-                copy2d
-                (
-                    vPlanePtr, reinterpret_cast<const std::uint8_t*>(chromaV.data),
-                    chromaV.pitch, videoTex.width / 2, chromaV.height, chromaVSize
-                );
-            }
+            const std::array<const ALXR::Plane2D, ALXR::PlaneCopier::MaxPlanes> planes {
+                makePlane(yPlanePtr, yuvBuffer.luma, videoTex.width, lumaSize),
+                makePlane(yPlanePtr + uPlaneOffset, yuvBuffer.chroma, videoTex.width / 2, chromaUSize),
+                has3Planes ?
+                    makePlane(yPlanePtr + vPlaneOffset, yuvBuffer.chroma2, videoTex.width / 2, chromaVSize) :
+                    ALXR::Plane2D{},
+            };
+            m_planeCopier.Copy(planes.data(), has3Planes ? 3 : 2);
         }
-        vkUnmapMemory(m_vkDevice, videoTex.stagingBufferMemory);
 
-        m_videoCpyCmdBuffer.Reset();
-        m_videoCpyCmdBuffer.Begin();
+        cpyCmdBuffer.Reset();
+        cpyCmdBuffer.Begin();
 
-        videoTex.texture.TransitionLayout(m_videoCpyCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        videoTex.texture.TransitionLayout(cpyCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
         {
             const VkBufferImageCopy buffImgCopy{
                 .bufferOffset = 0,
@@ -3969,17 +4387,25 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             region[2].imageSubresource.aspectMask = VK_IMAGE_ASPECT_PLANE_2_BIT;
             const auto regionCount = static_cast<std::uint32_t>(has3Planes ? region.size() : 2);
             const auto texImage = videoTex.texture.texImage;
-            vkCmdCopyBufferToImage(m_videoCpyCmdBuffer.buf, videoTex.stagingBuffer, texImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regionCount, region.data());
+            vkCmdCopyBufferToImage(cpyCmdBuffer.buf, videoTex.stagingBuffer, texImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regionCount, region.data());
         }
-        videoTex.texture.TransitionLayout(m_videoCpyCmdBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        videoTex.texture.TransitionLayout(cpyCmdBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+        cpyCmdBuffer.End();
+#ifdef XR_USE_PLATFORM_ANDROID
+        cpyCmdBuffer.Exec(m_VideoCpyQueue);
+#else
+        // No host wait, the render queue waits on m_texCopy before sampling & this slot is only
+        // written to again after the frames that sampled it signal m_texRendereComplete.
+        cpyCmdBuffer.Exec<1, 1>(m_VideoCpyQueue, { &m_texCopy }, { &m_texRendereComplete }, { VK_PIPELINE_STAGE_TRANSFER_BIT });
+#endif
 
-        m_videoCpyCmdBuffer.End();
-        m_videoCpyCmdBuffer.Exec(m_VideoCpyQueue);//ExecSignalers<1>(m_VideoCpyQueue, { &m_texCopy }); //Exec(m_VideoCpyQueue);
-        m_videoCpyCmdBuffer.Wait();
-        
         videoTex.frameIndex = yuvBuffer.frameIndex;
-        m_currentVideoTex.store((freeIndex + 1) % VideoTexCount);
-        m_renderTex.store(freeIndex);
+#ifdef XR_USE_PLATFORM_ANDROID
+        m_currentVideoTex = (freeIndex + 1) % VideoTexCount;
+#else
+        m_videoMailbox.Publish(freeIndex);
+#endif
     }
 
     virtual void BeginVideoView() override
@@ -3992,7 +4418,8 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         } else {
             std::size_t popCount = 0;
             while (m_videoTexQueue.try_dequeue(newVideoTex) && popCount < VideoQueueSize) {
-                ++popCount;
+                if (popCount++ > 0)
+                    LatencyManager::Instance().OnVideoFrameDropped();
             }
         }
 
@@ -4004,16 +4431,18 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
 
         if (newVideoTex.IsValid()) {
             auto& newCurrentTexture = m_videoTextures[VidTextureIndex::Current];
-            m_videoTextures[VidTextureIndex::DeferredDelete] = std::move(newCurrentTexture);
+            // May still be sampled by frames in-flight, released once the last frame submitted has completed.
+            if (m_lastSubmittedFrame < m_frames.size())
+                m_frames[m_lastSubmittedFrame].retiredVideoTextures.push_back(std::move(newCurrentTexture));
             newCurrentTexture = std::move(newVideoTex);
-            UpdateVideoTextureBinding(newCurrentTexture);
+            LatencyManager::Instance().OnVideoFrameDisplayed();
+        } else if (m_videoTextures[VidTextureIndex::Current].IsValid()) {
+            LatencyManager::Instance().OnVideoFrameReRendered();
         }
 #else
-        textureIdx = m_renderTex.load();
-        if (textureIdx == std::size_t(-1) || textureIdx == m_lastTexIndex)
-            return;
-        UpdateVideoTextureBinding(textureIdx);
-        m_lastTexIndex = textureIdx;
+        ReleaseRetiredVideoTextures();
+        ApplyVideoFormatChange();
+        m_videoMailbox.AcquireLatest();
 #endif
     }
 
@@ -4028,8 +4457,9 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
 #ifdef XR_USE_PLATFORM_ANDROID
         return m_videoTextures[VidTextureIndex::Current].frameIndex;
 #else
-        return textureIdx == std::uint64_t(-1) ?
-            textureIdx :
+        const std::size_t textureIdx = m_videoMailbox.DisplaySlot();
+        return textureIdx == VideoFrameMailbox::NoSlot ?
+            std::uint64_t(-1) :
             m_videoTextures[textureIdx].frameIndex;
 #endif
     }
@@ -4122,7 +4552,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             formatProperties
         );
 
-        if (m_videoStreamLayout.IsNull()) {
+        if (m_videoStream == nullptr) {
             const VkExternalFormatANDROID externalFormat{
                 .sType = VK_STRUCTURE_TYPE_EXTERNAL_FORMAT_ANDROID,
                 .pNext = nullptr,
@@ -4144,12 +4574,12 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             LogSuggestedYCBCRConversionParams(formatProperties);
             CreateVideoStreamPipeline(samplerInfo);
         }
-        CHECK(!m_videoStreamLayout.IsNull() && m_videoStreamLayout.ycbcrSamplerConversion != VK_NULL_HANDLE);
+        CHECK(m_videoStream != nullptr && m_videoStream->layout.ycbcrSamplerConversion != VK_NULL_HANDLE);
 
         const VkSamplerYcbcrConversionInfo ycbcrConverInfo{
             .sType = VK_STRUCTURE_TYPE_SAMPLER_YCBCR_CONVERSION_INFO,
             .pNext = nullptr,
-            .conversion = m_videoStreamLayout.ycbcrSamplerConversion,
+            .conversion = m_videoStream->layout.ycbcrSamplerConversion,
         };
         const VkImageViewCreateInfo viewInfo{
             .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
@@ -4175,8 +4605,10 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
 
         using namespace std::literals::chrono_literals;
         constexpr static const auto QueueTextureWaitTime = 100ms;
+        LatencyManager::Instance().OnVideoFrameDecoded();
         if (!m_videoTexQueue.wait_enqueue_timed(std::move(newVideoTex), QueueTextureWaitTime)) {
             Log::Write(Log::Level::Warning, Fmt("Waiting to queue decoded video frame (pts: %llu) timed-out after %lld seconds, this frame will be ignored", yuvBuffer.frameIndex, QueueTextureWaitTime.count()));
+            LatencyManager::Instance().OnVideoFrameDropped();
         }
     }
 #endif
@@ -4184,7 +4616,9 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
     virtual void UpdateVideoTextureD3D11VA(const YUVBuffer& yuvBuffer) override
     {
 #if defined(XR_USE_GRAPHICS_API_D3D11)
-        const std::size_t freeIndex = m_currentVideoTex.load();
+        const std::size_t freeIndex = m_videoMailbox.AcquireWrite();
+        if (freeIndex == VideoFrameMailbox::NoSlot)
+            return;
         {
             /*const*/ auto& videoTex = m_videoTextures[freeIndex];
             videoTex.frameIndex = yuvBuffer.frameIndex;
@@ -4209,24 +4643,24 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
                 .bottom = desc.Height,                
                 .back = 1,
             };
-            m_videoCpyCmdBuffer.Wait();
-            m_videoCpyCmdBuffer.Reset();
-            m_videoCpyCmdBuffer.Begin();
+            auto& cpyCmdBuffer = m_videoCpyCmdBuffers[freeIndex];
+            cpyCmdBuffer.Wait();
+            cpyCmdBuffer.Reset();
+            cpyCmdBuffer.Begin();
 
-            videoTex.texture.TransitionLayout(m_videoCpyCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+            videoTex.texture.TransitionLayout(cpyCmdBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
             devCtx->CopySubresourceRegion(dstVideoTexture.Get(), 0, 0, 0, 0, src_texture.Get(), texture_index, &sourceRegion);
             // Flush to submit the 11 command list to the shared command queue.
             devCtx->Flush();
 
-            videoTex.texture.TransitionLayout(m_videoCpyCmdBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            videoTex.texture.TransitionLayout(cpyCmdBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
-            m_videoCpyCmdBuffer.End();
-            m_videoCpyCmdBuffer.ExecSignalers<1>(m_VideoCpyQueue, { &m_texCopy });//Exec(m_VideoCpyQueue);//ExecSignalers<1>(m_VideoCpyQueue, { &m_texCopy }); //Exec(m_VideoCpyQueue);
+            cpyCmdBuffer.End();
+            cpyCmdBuffer.Exec<1, 1>(m_VideoCpyQueue, { &m_texCopy }, { &m_texRendereComplete }, { VK_PIPELINE_STAGE_TRANSFER_BIT });
         }
 
-        m_currentVideoTex.store((freeIndex + 1) % m_videoTextures.size());
-        m_renderTex.store(freeIndex);
+        m_videoMailbox.Publish(freeIndex);
 #else
         (void)yuvBuffer;
 #endif
@@ -4240,7 +4674,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
     ) override
     {
         assert(m_isMultiViewSupported);
-        RenderViewImpl(swapchainImage, [&, this](const std::uint32_t imageIndex, auto& swapchainContext)
+        RenderViewImpl(swapchainImage, [&, this](const std::uint32_t imageIndex, auto& swapchainContext, CmdBuffer& cmdBuffer)
         {
             const auto& clearValues = VideoClearValues[ClearValueIndex(newMode)];
             VkRenderPassBeginInfo renderPassBeginInfo{
@@ -4256,23 +4690,28 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             auto& currentTexture = m_videoTextures[VidTextureIndex::Current];
             if (currentTexture.texture.texImage == VK_NULL_HANDLE)
                 return;
-            currentTexture.texture.TransitionLayout(m_cmdBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            currentTexture.texture.TransitionLayout(cmdBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 #else
-            if (textureIdx == std::size_t(-1))
+            const std::size_t textureIdx = m_videoMailbox.DisplaySlot();
+            if (textureIdx == VideoFrameMailbox::NoSlot)
+                return;
+            const auto& currentTexture = m_videoTextures[textureIdx];
+            if (currentTexture.format != m_boundVideoFormat.load(std::memory_order_relaxed))
                 return;
 #endif
-            vkCmdBeginRenderPass(m_cmdBuffer.buf, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+            const VkDescriptorSet descriptorSet = UpdateVideoTextureBinding(currentTexture);
+            vkCmdBeginRenderPass(cmdBuffer.buf, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
 
-            vkCmdBindPipeline(m_cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_videoStreamPipelines[static_cast<std::size_t>(newMode)].pipe);
-            vkCmdBindDescriptorSets(m_cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_videoStreamLayout.layout, 0, 1, m_descriptorSets.data(), 0, nullptr);
+            vkCmdBindPipeline(cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_videoStream->pipelines[static_cast<std::size_t>(newMode)].pipe);
+            vkCmdBindDescriptorSets(cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_videoStream->layout.layout, 0, 1, &descriptorSet, 0, nullptr);
 
             // Bind index and vertex buffers
-            vkCmdBindIndexBuffer(m_cmdBuffer.buf, m_quadBuffer.idxBuf, 0, VK_INDEX_TYPE_UINT16);
+            vkCmdBindIndexBuffer(cmdBuffer.buf, m_quadBuffer.idxBuf, 0, VK_INDEX_TYPE_UINT16);
             constexpr static const VkDeviceSize offset = 0;
-            vkCmdBindVertexBuffers(m_cmdBuffer.buf, 0, 1, &m_quadBuffer.vtxBuf, &offset);
+            vkCmdBindVertexBuffers(cmdBuffer.buf, 0, 1, &m_quadBuffer.vtxBuf, &offset);
 
-            vkCmdDrawIndexed(m_cmdBuffer.buf, m_quadBuffer.count.idx, 1, 0, 0, 0);
-            vkCmdEndRenderPass(m_cmdBuffer.buf);
+            vkCmdDrawIndexed(cmdBuffer.buf, m_quadBuffer.count.idx, 1, 0, 0, 0);
+            vkCmdEndRenderPass(cmdBuffer.buf);
         });
     }
 
@@ -4283,7 +4722,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         const PassthroughMode mode /*= PassthroughMode::None*/
     ) override
     {
-        RenderViewImpl(swapchainImage, [&, this](const std::uint32_t imageIndex, auto& swapchainContext)
+        RenderViewImpl(swapchainImage, [&, this](const std::uint32_t imageIndex, auto& swapchainContext, CmdBuffer& cmdBuffer)
         {
             const auto& clearValues = VideoClearValues[ClearValueIndex(mode)];
             VkRenderPassBeginInfo renderPassBeginInfo{
@@ -4299,26 +4738,31 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             auto& currentTexture = m_videoTextures[VidTextureIndex::Current];
             if (currentTexture.texture.texImage == VK_NULL_HANDLE)
                 return;
-            currentTexture.texture.TransitionLayout(m_cmdBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            currentTexture.texture.TransitionLayout(cmdBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 #else
-            if (textureIdx == std::size_t(-1))
+            const std::size_t textureIdx = m_videoMailbox.DisplaySlot();
+            if (textureIdx == VideoFrameMailbox::NoSlot)
+                return;
+            const auto& currentTexture = m_videoTextures[textureIdx];
+            if (currentTexture.format != m_boundVideoFormat.load(std::memory_order_relaxed))
                 return;
 #endif
-            vkCmdBeginRenderPass(m_cmdBuffer.buf, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+            const VkDescriptorSet descriptorSet = UpdateVideoTextureBinding(currentTexture);
+            vkCmdBeginRenderPass(cmdBuffer.buf, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
 
-            vkCmdBindPipeline(m_cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_videoStreamPipelines[static_cast<std::size_t>(mode)].pipe);
-            vkCmdBindDescriptorSets(m_cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_videoStreamLayout.layout, 0, 1, m_descriptorSets.data(), 0, nullptr);
+            vkCmdBindPipeline(cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_videoStream->pipelines[static_cast<std::size_t>(mode)].pipe);
+            vkCmdBindDescriptorSets(cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_videoStream->layout.layout, 0, 1, &descriptorSet, 0, nullptr);
 
             // Bind index and vertex buffers
-            vkCmdBindIndexBuffer(m_cmdBuffer.buf, m_quadBuffer.idxBuf, 0, VK_INDEX_TYPE_UINT16);
+            vkCmdBindIndexBuffer(cmdBuffer.buf, m_quadBuffer.idxBuf, 0, VK_INDEX_TYPE_UINT16);
             constexpr static const VkDeviceSize offset = 0;
-            vkCmdBindVertexBuffers(m_cmdBuffer.buf, 0, 1, &m_quadBuffer.vtxBuf, &offset);
+            vkCmdBindVertexBuffers(cmdBuffer.buf, 0, 1, &m_quadBuffer.vtxBuf, &offset);
 
             const ViewProjectionUniform mvp1{ .ViewID = viewID };
-            vkCmdPushConstants(m_cmdBuffer.buf, m_videoStreamLayout.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(ViewProjectionUniform), &mvp1);
+            vkCmdPushConstants(cmdBuffer.buf, m_videoStream->layout.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(ViewProjectionUniform), &mvp1);
 
-            vkCmdDrawIndexed(m_cmdBuffer.buf, m_quadBuffer.count.idx, 1, 0, 0, 0);
-            vkCmdEndRenderPass(m_cmdBuffer.buf);
+            vkCmdDrawIndexed(cmdBuffer.buf, m_quadBuffer.count.idx, 1, 0, 0, 0);
+            vkCmdEndRenderPass(cmdBuffer.buf);
         });
     }
 
@@ -4331,8 +4775,10 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
     }
     
     virtual ~VulkanGraphicsPlugin() override {
+        WaitForFramesInFlight();
         ClearImageDescriptorSetLayouts();
-        Log::Write(Log::Level::Verbose, "VulkanGraphicsPlugin destroyed.");
+        m_pipelineCache.Save();
+        ALXR_LOG_VERBOSE("VulkanGraphicsPlugin destroyed.");
     }
 
 #include "cuda/vulkancuda_interop.inl"
@@ -4358,12 +4804,13 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
     
     MemoryAllocator m_memAllocator{};
     ShaderProgram m_shaderProgram{};
-    CmdBuffer m_cmdBuffer{};
     PipelineLayout m_pipelineLayout{};
+    PipelineCache m_pipelineCache{};
     VertexBuffer<Geometry::Vertex> m_drawBuffer{};
     bool m_isMultiViewSupported = false;
 
 // BEGIN VIDEO STREAM DATA /////////////////////////////////////////////////////////////
+    VkPhysicalDeviceProperties m_vkDeviceProperties{};
     std::array<std::uint8_t, VK_UUID_SIZE> m_vkDeviceUUID{};
     std::array<std::uint8_t, VK_UUID_SIZE> m_vkDeviceLUID{};
 
@@ -4378,23 +4825,23 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
     VkDescriptorPool m_descriptorPool{ VK_NULL_HANDLE };
     std::vector<VkDescriptorSet> m_descriptorSets{};
 
-    CmdBuffer m_videoCpyCmdBuffer{};
+    // one per video texture, so an upload never has to wait on the previous one to finish.
+    std::array<CmdBuffer, VideoTexCount> m_videoCpyCmdBuffers{};
     
     using VideoShaderList = std::array<ShaderProgram, size_t(PassthroughMode::TypeCount)>;
     using VideoShaderMap  = std::array<VideoShaderList, size_t(VideoFragShaderType::TypeCount)>;
     VideoShaderMap m_videoShaders {};
     
     VertexBuffer<Geometry::QuadVertex> m_quadBuffer{};
-    PipelineLayout m_videoStreamLayout{};
-    using PipelineList = std::array<Pipeline, size_t(PassthroughMode::TypeCount)>;
-    PipelineList m_videoStreamPipelines{};
+    constexpr static const std::size_t MaxCachedVideoPipelines = 4;
+    // most recently used first, m_videoStream points to the entry bound for the current stream.
+    std::list<VideoStreamPipeline> m_videoPipelineCache{};
+    VideoStreamPipeline* m_videoStream = nullptr;
     bool m_enableSRGBLinearize = true;
 
     using FoveatedDecodeParamsPtr = std::shared_ptr<ALXR::FoveatedDecodeParams>;
     FoveatedDecodeParamsPtr m_fovDecodeParams{};
 
-    constexpr static const std::size_t VideoTexCount = 2;
-
 #ifndef XR_USE_PLATFORM_ANDROID
     SemaphoreTimeline m_texRendereComplete{};
     SemaphoreTimeline m_texCopy{};
@@ -4411,6 +4858,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         VkBuffer stagingBuffer{ VK_NULL_HANDLE };
         VkDeviceMemory stagingBufferMemory{ VK_NULL_HANDLE };
         VkDeviceSize stagingBufferSize {0};
+        void* stagingBufferPtr{ nullptr }; // persistently mapped stagingBufferMemory.
 
         VkImageView imageView{ VK_NULL_HANDLE };
 
@@ -4439,6 +4887,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             std::swap(stagingBuffer, other.stagingBuffer);
             std::swap(stagingBufferMemory, other.stagingBufferMemory);
             std::swap(stagingBufferSize, other.stagingBufferSize);
+            std::swap(stagingBufferPtr, other.stagingBufferPtr);
             std::swap(imageView, other.imageView);
             std::swap(frameIndex, other.frameIndex);
             std::swap(width, other.width);
@@ -4462,6 +4911,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             std::swap(stagingBuffer, other.stagingBuffer);
             std::swap(stagingBufferMemory, other.stagingBufferMemory);
             std::swap(stagingBufferSize, other.stagingBufferSize);
+            std::swap(stagingBufferPtr, other.stagingBufferPtr);
             std::swap(imageView, other.imageView);
             std::swap(frameIndex, other.frameIndex);
             std::swap(width, other.width);
@@ -4493,6 +4943,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
                     vkDestroyBuffer(vkDevice, stagingBuffer, nullptr);
                 }
                 if (stagingBufferMemory != VK_NULL_HANDLE) {
+                    // implicitly unmaps stagingBufferPtr.
                     vkFreeMemory(vkDevice, stagingBufferMemory, nullptr);
                 }
                 if (imageView != VK_NULL_HANDLE) {
@@ -4502,6 +4953,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             stagingBuffer = VK_NULL_HANDLE;
             stagingBufferMemory = VK_NULL_HANDLE;
             stagingBufferSize = 0;
+            stagingBufferPtr = nullptr;
             imageView = VK_NULL_HANDLE;
             texture.Clear();
             frameIndex = std::uint64_t(-1);
@@ -4527,16 +4979,19 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         }
     };
 
-    void UpdateVideoTextureBinding(const VideoTexture& vidTexture)
+    // Returns the current frame's descriptor set, pointed at vidTexture. Each frame in-flight owns one set,
+    // it is only written to while the frame is being recorded, after its previous submission has completed.
+    VkDescriptorSet UpdateVideoTextureBinding(const VideoTexture& vidTexture)
     {
-        CHECK(m_videoStreamLayout.textureSampler != VK_NULL_HANDLE);
+        CHECK(m_videoStream != nullptr && m_videoStream->layout.textureSampler != VK_NULL_HANDLE);
         CHECK(vidTexture.imageView != VK_NULL_HANDLE);
-        const auto swapChainCount = static_cast<std::uint32_t>(m_swapchainImageContexts.back().swapchainImages.size());
-        CHECK(m_descriptorSets.size() == swapChainCount);
-        for (size_t i = 0; i < swapChainCount; ++i)
+        CHECK(m_isRecordingFrame && m_descriptorSets.size() == m_frames.size());
+        auto& frame = m_frames[m_frameIndex];
+        const VkDescriptorSet descriptorSet = m_descriptorSets[m_frameIndex];
+        if (frame.boundVideoView != vidTexture.imageView)
         {
             const VkDescriptorImageInfo imageInfo{
-                .sampler = m_videoStreamLayout.textureSampler,
+                .sampler = m_videoStream->layout.textureSampler,
                 .imageView = vidTexture.imageView,
                 .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
             };
@@ -4544,7 +4999,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
                 VkWriteDescriptorSet {
                     .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
                     .pNext = nullptr,
-                    .dstSet = m_descriptorSets[i],
+                    .dstSet = descriptorSet,
                     .dstBinding = 0,
                     .dstArrayElement = 0,
                     .descriptorCount = 1,
@@ -4555,29 +5010,110 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
                 }
             };
             vkUpdateDescriptorSets(m_vkDevice, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+            frame.boundVideoView = vidTexture.imageView;
         }
-    }
-
-    inline void UpdateVideoTextureBinding(const std::size_t vidTexIndex)
-    {
-        UpdateVideoTextureBinding(m_videoTextures[vidTexIndex]);
+        return descriptorSet;
     }
 
     static_assert(VideoTexCount >= 2);
     std::array<VideoTexture, VideoTexCount>  m_videoTextures{};
-    std::atomic<std::size_t>            m_currentVideoTex{ 0 },
-                                        m_renderTex{ std::size_t(-1) };
+
+    // Recording state of a single frame in-flight, there is one per swapchain image so
+    // recording the next frame does not have to wait on the GPU finishing the previous one.
+    struct FrameContext {
+        CmdBuffer   cmdBuffer{};
+        // image view last written to this frame's video descriptor set.
+        VkImageView boundVideoView{ VK_NULL_HANDLE };
+        // video textures replaced after this frame was submitted, released once it has completed.
+        std::vector<VideoTexture> retiredVideoTextures{};
+    };
+    std::deque<FrameContext> m_frames{};
+    std::size_t m_frameIndex = 0; // frame being (or to be) recorded.
+    std::size_t m_lastSubmittedFrame = std::size_t(-1);
+    bool m_isRecordingFrame = false;
+    bool m_isBatchingViews = false;
+
+    constexpr static const std::uint64_t UploadStallLogInterval = 1000;
+    LatencyHistogramUs<> m_uploadStalls{};
+    ALXR::PlaneCopier m_planeCopier{};
 
 #ifndef XR_USE_PLATFORM_ANDROID
-    std::size_t m_lastTexIndex = std::size_t(-1);
-    std::size_t textureIdx = std::size_t(-1);
+    // m_videoTextures slot ownership between the decoder & render threads.
+    using VideoFrameMailbox = ALXR::VideoFrameMailbox<VideoTexCount>;
+    VideoFrameMailbox m_videoMailbox{};
+
+    // Decoder thread owned, size & format video texture slots are (re-)created with.
+    struct VideoTextureDesc {
+        std::size_t width = 0;
+        std::size_t height = 0;
+        VkFormat    format = VK_FORMAT_UNDEFINED;
+    };
+    VideoTextureDesc m_videoTexDesc{};
+    // A format change needs new video stream pipelines (the ycbcr conversion is baked into them), the
+    // decoder thread requests it & only writes new format slots once the render thread has bound them.
+    std::atomic<VkFormat> m_requestedVideoFormat{ VK_FORMAT_UNDEFINED };
+    std::atomic<VkFormat> m_boundVideoFormat{ VK_FORMAT_UNDEFINED };
+    // Slot textures replaced by the decoder thread, handed to the last submitted frame by the render thread.
+    std::mutex                m_retiredVideoTexMutex{};
+    std::vector<VideoTexture> m_retiredVideoTextures{};
+
+    // Decoder thread, slotIndex is held for writing. Re-creates the slot's texture if the stream
+    // changed size/format, false if the new format's pipelines are not bound yet.
+    bool PrepareVideoTexture(const std::size_t slotIndex)
+    {
+        const auto& desc = m_videoTexDesc;
+        if (m_boundVideoFormat.load(std::memory_order_acquire) != desc.format)
+            return false;
+        auto& videoTex = m_videoTextures[slotIndex];
+        if (videoTex.width == desc.width && videoTex.height == desc.height && videoTex.format == desc.format)
+            return true;
+        {
+            std::scoped_lock lk(m_retiredVideoTexMutex);
+            m_retiredVideoTextures.push_back(std::move(videoTex));
+        }
+        videoTex = VideoTexture{};
+        CreateVideoTexture(videoTex, desc.width, desc.height, desc.format);
+        ALXR_LOG_VERBOSE(Fmt("Re-created video texture slot %zu, width=%zu, height=%zu, format=%d",
+            slotIndex, desc.width, desc.height, desc.format));
+        return true;
+    }
+
+    // Render thread, retired textures may still be sampled by frames in-flight.
+    void ReleaseRetiredVideoTextures()
+    {
+        std::scoped_lock lk(m_retiredVideoTexMutex);
+        if (m_retiredVideoTextures.empty())
+            return;
+        if (m_lastSubmittedFrame < m_frames.size()) {
+            auto& retired = m_frames[m_lastSubmittedFrame].retiredVideoTextures;
+            std::move(m_retiredVideoTextures.begin(), m_retiredVideoTextures.end(), std::back_inserter(retired));
+        }
+        m_retiredVideoTextures.clear();
+        // a new image view may reuse a released handle value.
+        for (auto& frame : m_frames)
+            frame.boundVideoView = VK_NULL_HANDLE;
+    }
+
+    // Render thread, binds the video stream pipelines of a format requested by the decoder thread.
+    void ApplyVideoFormatChange()
+    {
+        const VkFormat requestedFormat = m_requestedVideoFormat.load(std::memory_order_acquire);
+        if (requestedFormat == VK_FORMAT_UNDEFINED || requestedFormat == m_boundVideoFormat.load(std::memory_order_relaxed))
+            return;
+        Log::Write(Log::Level::Info, Fmt("Video format changed to %d, switching video stream pipelines.", requestedFormat));
+        // descriptor sets are re-allocated & the frame on display can not be sampled by the new pipelines.
+        WaitForFramesInFlight();
+        m_videoStream = nullptr;
+        CreateVideoStreamPipeline(requestedFormat);
+        m_boundVideoFormat.store(requestedFormat, std::memory_order_release);
+    }
 #else
     enum VidTextureIndex : std::size_t {
-        Current,
-        DeferredDelete
+        Current
     };
     using VideoTextureQueue = moodycamel::BlockingReaderWriterCircularBuffer<VideoTexture>; //atomic_queue::AtomicQueue2<VideoTexture, 2>;// moodycamel::BlockingReaderWriterCircularBuffer<VideoTexture>; // xrconcurrency::concurrent_queue<VideoTexture>; //
     VideoTextureQueue m_videoTexQueue{ VideoQueueSize };
+    std::size_t m_currentVideoTex = 0; // decoder thread owned, cpu decoded uploads only.
 #endif
 
     static_assert(XR_ENVIRONMENT_BLEND_MODE_OPAQUE == 1);
@@ -0,0 +1,235 @@
+#include "pch.h"
+#include "common.h"
+#include "hand_skeleton.h"
+
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <array>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define ALXR_HAND_SKELETON_SSE2
+        #include <emmintrin.h>
+    #endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define ALXR_HAND_SKELETON_NEON
+    #include <arm_neon.h>
+#endif
+
+namespace ALXR {
+namespace {
+
+#if defined(ALXR_HAND_SKELETON_SSE2)
+using Float4 = __m128;
+inline Float4 Load(const float* p) { return _mm_load_ps(p); }
+inline void Store(float* p, const Float4 v) { _mm_store_ps(p, v); }
+inline Float4 Splat(const float f) { return _mm_set1_ps(f); }
+inline Float4 Add(const Float4 a, const Float4 b) { return _mm_add_ps(a, b); }
+inline Float4 Sub(const Float4 a, const Float4 b) { return _mm_sub_ps(a, b); }
+inline Float4 Mul(const Float4 a, const Float4 b) { return _mm_mul_ps(a, b); }
+#elif defined(ALXR_HAND_SKELETON_NEON)
+using Float4 = float32x4_t;
+inline Float4 Load(const float* p) { return vld1q_f32(p); }
+inline void Store(float* p, const Float4 v) { vst1q_f32(p, v); }
+inline Float4 Splat(const float f) { return vdupq_n_f32(f); }
+inline Float4 Add(const Float4 a, const Float4 b) { return vaddq_f32(a, b); }
+inline Float4 Sub(const Float4 a, const Float4 b) { return vsubq_f32(a, b); }
+inline Float4 Mul(const Float4 a, const Float4 b) { return vmulq_f32(a, b); }
+#else
+struct Float4 { float v[4]; };
+inline Float4 Load(const float* p) { return { p[0], p[1], p[2], p[3] }; }
+inline void Store(float* p, const Float4 v) { std::copy(v.v, v.v + 4, p); }
+inline Float4 Splat(const float f) { return { f, f, f, f }; }
+inline Float4 Add(const Float4 a, const Float4 b) { return { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] }; }
+inline Float4 Sub(const Float4 a, const Float4 b) { return { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] }; }
+inline Float4 Mul(const Float4 a, const Float4 b) { return { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] }; }
+#endif
+
+// 4 quaternions/vectors, one per lane.
+struct Quat4 { Float4 x, y, z, w; };
+struct Vec4  { Float4 x, y, z; };
+
+// a * b, i.e. b then a.
+inline Quat4 Multiply(const Quat4& a, const Quat4& b) {
+    return {
+        .x = Sub(Add(Add(Mul(a.w, b.x), Mul(a.x, b.w)), Mul(a.y, b.z)), Mul(a.z, b.y)),
+        .y = Add(Add(Sub(Mul(a.w, b.y), Mul(a.x, b.z)), Mul(a.y, b.w)), Mul(a.z, b.x)),
+        .z = Add(Sub(Add(Mul(a.w, b.z), Mul(a.x, b.y)), Mul(a.y, b.x)), Mul(a.z, b.w)),
+        .w = Sub(Sub(Sub(Mul(a.w, b.w), Mul(a.x, b.x)), Mul(a.y, b.y)), Mul(a.z, b.z))
+    };
+}
+
+// conjugate(a) * b
+inline Quat4 ConjugateMultiply(const Quat4& a, const Quat4& b) {
+    return {
+        .x = Add(Sub(Sub(Mul(a.w, b.x), Mul(a.x, b.w)), Mul(a.y, b.z)), Mul(a.z, b.y)),
+        .y = Sub(Sub(Add(Mul(a.w, b.y), Mul(a.x, b.z)), Mul(a.y, b.w)), Mul(a.z, b.x)),
+        .z = Sub(Add(Sub(Mul(a.w, b.z), Mul(a.x, b.y)), Mul(a.y, b.x)), Mul(a.z, b.w)),
+        .w = Add(Add(Add(Mul(a.w, b.w), Mul(a.x, b.x)), Mul(a.y, b.y)), Mul(a.z, b.z))
+    };
+}
+
+inline Vec4 Cross(const Float4 ax, const Float4 ay, const Float4 az, const Vec4& b) {
+    return {
+        .x = Sub(Mul(ay, b.z), Mul(az, b.y)),
+        .y = Sub(Mul(az, b.x), Mul(ax, b.z)),
+        .z = Sub(Mul(ax, b.y), Mul(ay, b.x))
+    };
+}
+
+// v rotated by conjugate(q), for unit q: v - w*c + u x c with c = 2(u x v).
+inline Vec4 InverseRotate(const Quat4& q, const Vec4& v) {
+    const Float4 two = Splat(2.0f);
+    Vec4 c = Cross(q.x, q.y, q.z, v);
+    c = { Mul(c.x, two), Mul(c.y, two), Mul(c.z, two) };
+    const Vec4 uc = Cross(q.x, q.y, q.z, c);
+    return {
+        .x = Add(Sub(v.x, Mul(q.w, c.x)), uc.x),
+        .y = Add(Sub(v.y, Mul(q.w, c.y)), uc.y),
+        .z = Add(Sub(v.z, Mul(q.w, c.z)), uc.z)
+    };
+}
+
+constexpr const std::size_t BoneCount = ALVR_HAND::alvrHandBone_MaxSkinnable;
+constexpr const std::size_t PaddedBoneCount = (BoneCount + 3) & ~std::size_t(3);
+
+// Joint & parent joint of every bone, bones without a joint (& padding) are palm relative to palm.
+struct BoneJointTable {
+    std::array<std::uint8_t, PaddedBoneCount> joint;
+    std::array<std::uint8_t, PaddedBoneCount> parent;
+    std::array<bool, PaddedBoneCount>         hasJoint;
+};
+constexpr const BoneJointTable BoneJoints = []() {
+    BoneJointTable table{};
+    for (std::size_t bone = 0; bone < PaddedBoneCount; ++bone) {
+        const auto xrJoint = bone < BoneCount ?
+            ToXRHandJointType(static_cast<ALVR_HAND>(bone)) : XR_HAND_JOINT_MAX_ENUM_EXT;
+        table.hasJoint[bone] = xrJoint != XR_HAND_JOINT_MAX_ENUM_EXT;
+        table.joint[bone]    = static_cast<std::uint8_t>(table.hasJoint[bone] ? xrJoint : XR_HAND_JOINT_PALM_EXT);
+        table.parent[bone]   = static_cast<std::uint8_t>(GetJointParent(static_cast<XrHandJointEXT>(table.joint[bone])));
+    }
+    return table;
+}();
+
+// Joint poses of every bone & of its parent, gathered from HandJoints.
+struct BonePoses {
+    alignas(16) float qx[PaddedBoneCount];
+    alignas(16) float qy[PaddedBoneCount];
+    alignas(16) float qz[PaddedBoneCount];
+    alignas(16) float qw[PaddedBoneCount];
+    alignas(16) float px[PaddedBoneCount];
+    alignas(16) float py[PaddedBoneCount];
+    alignas(16) float pz[PaddedBoneCount];
+};
+
+template < typename Poses >
+inline Quat4 LoadQuat4(const Poses& poses, const std::size_t i) {
+    return { Load(poses.qx + i), Load(poses.qy + i), Load(poses.qz + i), Load(poses.qw + i) };
+}
+
+template < typename Poses >
+inline Vec4 LoadVec4(const Poses& poses, const std::size_t i) {
+    return { Load(poses.px + i), Load(poses.py + i), Load(poses.pz + i) };
+}
+
+template < typename Poses >
+inline void StoreQuat4(Poses& poses, const std::size_t i, const Quat4& q) {
+    Store(poses.qx + i, q.x);
+    Store(poses.qy + i, q.y);
+    Store(poses.qz + i, q.z);
+    Store(poses.qw + i, q.w);
+}
+
+template < typename Poses >
+inline void StoreVec4(Poses& poses, const std::size_t i, const Vec4& v) {
+    Store(poses.px + i, v.x);
+    Store(poses.py + i, v.y);
+    Store(poses.pz + i, v.z);
+}
+
+constexpr inline bool IsPoseValid(const XrHandJointLocationEXT& jointLocation) {
+    constexpr const XrSpaceLocationFlags PoseValidFlags = XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_VALID_BIT;
+    return (jointLocation.locationFlags & PoseValidFlags) == PoseValidFlags;
+}
+
+}
+
+void LoadHandJoints(const HandJointLocations& jointLocations, const XrQuaternionf& baseOrientation, /*[out]*/ HandJoints& joints)
+{
+    std::uint32_t invalidJoints = 0;
+    for (std::size_t i = 0; i < HandJoints::PaddedCount; ++i) {
+        if (i < HandJoints::Count && IsPoseValid(jointLocations[i])) {
+            const auto& pose = jointLocations[i].pose;
+            joints.qx[i] = pose.orientation.x;
+            joints.qy[i] = pose.orientation.y;
+            joints.qz[i] = pose.orientation.z;
+            joints.qw[i] = pose.orientation.w;
+            joints.px[i] = pose.position.x;
+            joints.py[i] = pose.position.y;
+            joints.pz[i] = pose.position.z;
+            continue;
+        }
+        invalidJoints |= std::uint32_t(1) << i;
+        joints.qx[i] = joints.qy[i] = joints.qz[i] = 0.0f;
+        joints.qw[i] = 1.0f;
+        joints.px[i] = joints.py[i] = joints.pz[i] = 0.0f;
+    }
+
+    const Quat4 base{ Splat(baseOrientation.x), Splat(baseOrientation.y), Splat(baseOrientation.z), Splat(baseOrientation.w) };
+    for (std::size_t i = 0; i < HandJoints::PaddedCount; i += 4)
+        StoreQuat4(joints, i, Multiply(LoadQuat4(joints, i), base));
+
+    // the base orientation only applies to tracked joints, the others stay identity.
+    for (std::size_t i = 0; invalidJoints != 0; ++i, invalidJoints >>= 1) {
+        if ((invalidJoints & 1) == 0)
+            continue;
+        joints.qx[i] = joints.qy[i] = joints.qz[i] = 0.0f;
+        joints.qw[i] = 1.0f;
+    }
+}
+
+void ToHandSkeleton(const HandJoints& joints, /*[out]*/ TrackingInfo::Controller& controller)
+{
+    BonePoses bonePoses, parentPoses;
+    const auto gather = [&joints](BonePoses& poses, const std::size_t bone, const std::size_t joint) {
+        poses.qx[bone] = joints.qx[joint];
+        poses.qy[bone] = joints.qy[joint];
+        poses.qz[bone] = joints.qz[joint];
+        poses.qw[bone] = joints.qw[joint];
+        poses.px[bone] = joints.px[joint];
+        poses.py[bone] = joints.py[joint];
+        poses.pz[bone] = joints.pz[joint];
+    };
+    for (std::size_t bone = 0; bone < PaddedBoneCount; ++bone) {
+        gather(bonePoses,   bone, BoneJoints.joint[bone]);
+        gather(parentPoses, bone, BoneJoints.parent[bone]);
+    }
+
+    // inverse(parent) * joint: rotation conjugate(qParent) * qJoint, translation (pJoint - pParent)
+    // rotated by conjugate(qParent). The local poses overwrite the joint poses.
+    for (std::size_t i = 0; i < PaddedBoneCount; i += 4) {
+        const Quat4 parentRot = LoadQuat4(parentPoses, i);
+        const Vec4 parentPos  = LoadVec4(parentPoses, i);
+        const Vec4 jointPos   = LoadVec4(bonePoses, i);
+        const Vec4 offset{ Sub(jointPos.x, parentPos.x), Sub(jointPos.y, parentPos.y), Sub(jointPos.z, parentPos.z) };
+        StoreQuat4(bonePoses, i, ConjugateMultiply(parentRot, LoadQuat4(bonePoses, i)));
+        StoreVec4(bonePoses, i, InverseRotate(parentRot, offset));
+    }
+
+    for (std::size_t bone = 0; bone < BoneCount; ++bone) {
+        if (!BoneJoints.hasJoint[bone]) {
+            controller.boneRotations[bone] = { 0,0,0,1 };
+            controller.bonePositionsBase[bone] = { 0,0,0 };
+            continue;
+        }
+        controller.boneRotations[bone] = { bonePoses.qx[bone], bonePoses.qy[bone], bonePoses.qz[bone], bonePoses.qw[bone] };
+        controller.bonePositionsBase[bone] = { bonePoses.px[bone], bonePoses.py[bone], bonePoses.pz[bone] };
+    }
+
+    constexpr const std::size_t Palm = XR_HAND_JOINT_PALM_EXT;
+    controller.boneRootPosition = { joints.px[Palm], joints.py[Palm], joints.pz[Palm] };
+    controller.boneRootOrientation = { joints.qx[Palm], joints.qy[Palm], joints.qz[Palm], joints.qw[Palm] };
+}
+
+}
@@ -19,6 +19,7 @@
 #include "alxr_ctypes.h"
 #include "xr_utils.h"
 #include "interaction_profiles.h"
+#include "action_table.h"
 #include "timing.h"
 #include "ALVR-common/packet_types.h"
 
@@ -138,8 +139,20 @@ private:
     PFN_xrVibrateControllerPico m_pfnXrVibrateControllerPico { nullptr };
 #endif
 
-    using InteractionProfilePtr = std::atomic<const InteractionProfile*>;
-    InteractionProfilePtr m_activeProfile{ nullptr };
+    // Every InteractionProfile with its actions compiled once they are created, selecting the active
+    // profile is then a pointer swap that is safe while the tracking thread polls.
+    struct CompiledProfile {
+        const InteractionProfile* profile{ nullptr };
+        XrPath                    path{ XR_NULL_PATH };
+        ActionTable               actionTable{};
+    };
+    using CompiledProfileList = std::array<CompiledProfile, ProfileMapSize>;
+    CompiledProfileList m_compiledProfiles{};
+
+    using InteractionProfilePtr = std::atomic<CompiledProfile*>;
+    InteractionProfilePtr      m_activeProfile{ nullptr };
+    std::atomic<std::uint32_t> m_activeProfileGeneration{ 0 };
+    std::uint32_t              m_polledProfileGeneration{ 0 }; // PollActions only.
 
     using HandPathList   = std::array<XrPath, Side::COUNT>;
     using HandSpaceList  = std::array<XrSpace, Side::COUNT>;
@@ -235,14 +248,16 @@ inline InteractionManager::InteractionManager
 }
 
 inline InteractionManager::~InteractionManager() {
-    Log::Write(Log::Level::Verbose, "Destroying InteractionManager");
+    ALXR_LOG_VERBOSE("Destroying InteractionManager");
     Clear();
 }
 
 inline void InteractionManager::Clear() {
 
     m_activeProfile.store(nullptr);
-    Log::Write(Log::Level::Verbose, "Destroying Hand Action Spaces");
+    for (auto& compiledProfile : m_compiledProfiles)
+        compiledProfile.actionTable.Clear();
+    ALXR_LOG_VERBOSE("Destroying Hand Action Spaces");
     for (auto hand : { Side::LEFT, Side::RIGHT }) {
         if (m_handSpace[hand] != XR_NULL_HANDLE) {
             xrDestroySpace(m_handSpace[hand]);
@@ -251,7 +266,7 @@ inline void InteractionManager::Clear() {
     }
 
     if (m_actionSet != XR_NULL_HANDLE) {
-        Log::Write(Log::Level::Verbose, "Destroying ActionSet");
+        ALXR_LOG_VERBOSE("Destroying ActionSet");
         xrDestroyActionSet(m_actionSet);
         m_actionSet = XR_NULL_HANDLE;
     }
@@ -492,6 +507,28 @@ inline void InteractionManager::InitializeActions(IsProfileSupportedFn&& isProfi
     CreateActions(XR_ACTION_TYPE_BOOLEAN_INPUT,  m_boolToScalarActionMap);
     CreateActions(XR_ACTION_TYPE_BOOLEAN_INPUT,  m_scalarToBoolActionMap);
 
+    const auto lookupAction = [this](const ActionKind kind, const ALVR_INPUT button) -> XrAction
+    {
+        const auto& actionMap = [&]() -> const ALVRActionMap& {
+            switch (kind) {
+            case ActionKind::Scalar:       return m_scalarActionMap;
+            case ActionKind::Vector2f:     return m_vector2fActionMap;
+            case ActionKind::BoolToScalar: return m_boolToScalarActionMap;
+            case ActionKind::ScalarToBool: return m_scalarToBoolActionMap;
+            case ActionKind::Bool:
+            default: return m_boolActionMap;
+            }
+        }();
+        const auto actionItr = actionMap.find(button);
+        return actionItr == actionMap.end() ? XR_NULL_HANDLE : actionItr->second.xrAction;
+    };
+    for (std::size_t index = 0; index < ALXR::InteractionProfileMap.size(); ++index) {
+        auto& compiledProfile = m_compiledProfiles[index];
+        compiledProfile.profile = &ALXR::InteractionProfileMap[index];
+        compiledProfile.path = GetXrPath(*compiledProfile.profile);
+        compiledProfile.actionTable.Compile(*compiledProfile.profile, m_handSubactionPath, lookupAction);
+    }
+
     XrActionSpaceCreateInfo actionSpaceInfo {
         .type = XR_TYPE_ACTION_SPACE_CREATE_INFO,
         .next = nullptr,
@@ -532,6 +569,7 @@ inline void InteractionManager::PollActions(InteractionManager::ControllerInfoLi
     if (m_session == XR_NULL_HANDLE)
         return;
 
+    const auto prevHandActive = m_handActive;
     m_handActive = { XR_FALSE, XR_FALSE };
 
     // Sync actions
@@ -550,7 +588,7 @@ inline void InteractionManager::PollActions(InteractionManager::ControllerInfoLi
     const auto activeProfilePtr = m_activeProfile.load();
     for (const auto hand : { Side::LEFT, Side::RIGHT })
     {
-        XrActionStateGetInfo getInfo{
+        const XrActionStateGetInfo getInfo{
             .type = XR_TYPE_ACTION_STATE_GET_INFO,
             .next = nullptr,
             .action = m_poseAction,
@@ -560,118 +598,33 @@ inline void InteractionManager::PollActions(InteractionManager::ControllerInfoLi
         CHECK_XRCMD(xrGetActionStatePose(m_session, &getInfo, &poseState));
         m_handActive[hand] = poseState.isActive;
 
-        auto& controllerInfo = controllerInfoList[hand];
         if (poseState.isActive == XR_TRUE)
-            controllerInfo.enabled = true;
-
-        if (activeProfilePtr == nullptr)
-            continue;
-        const auto forEachButton = [this, &getInfo](/*const*/ auto& actionMap, const ALXR::InputMap& inputMap, auto&& fn) -> void
-        {
-            for (const auto& buttonMap : inputMap) {
-                if (buttonMap == ALXR::MapEnd)
-                    break;
-                const auto actionItr = actionMap.find(buttonMap.button);
-                if (actionItr == actionMap.end())
-                    continue;
-                /*const*/ auto& alvrAction = actionItr->second;
-                if (alvrAction.xrAction == XR_NULL_HANDLE)
-                    continue;
-                getInfo.action = alvrAction.xrAction;
-                fn(buttonMap.button);
-            }
-        };
-        const auto& activeProfile = *activeProfilePtr;
-        forEachButton(m_boolActionMap, activeProfile.boolMap[hand], [&](const ALVR_INPUT button)
-        {
-            XrActionStateBoolean boolValue{ .type = XR_TYPE_ACTION_STATE_BOOLEAN, .next = nullptr, .isActive = XR_FALSE };
-            if (XR_FAILED(xrGetActionStateBoolean(m_session, &getInfo, &boolValue)))
-                return;
-            if (boolValue.isActive == XR_TRUE && boolValue.currentState == XR_TRUE) {
-                controllerInfo.buttons |= ALVR_BUTTON_FLAG(button);
-            }
-        });
-
-        constexpr static const auto GetFloatRef = [](ControllerInfo& c, const ALVR_INPUT input) -> float&
-        {
-            switch (input) {
-            case ALVR_INPUT_JOYSTICK_X:
-            case ALVR_INPUT_TRACKPAD_X:
-                return c.trackpadPosition.x;
-            case ALVR_INPUT_JOYSTICK_Y:
-            case ALVR_INPUT_TRACKPAD_Y:
-                return c.trackpadPosition.y;
-            case ALVR_INPUT_TRIGGER_VALUE:
-                return c.triggerValue;
-            case ALVR_INPUT_GRIP_VALUE:
-            default:
-                return c.gripValue;
-            }
-        };
-        forEachButton(m_scalarActionMap, activeProfile.scalarMap[hand], [&](const ALVR_INPUT button)
-        {
-            XrActionStateFloat floatValue{ .type = XR_TYPE_ACTION_STATE_FLOAT, .next = nullptr, .isActive = XR_FALSE };
-            if (XR_FAILED(xrGetActionStateFloat(m_session, &getInfo, &floatValue)) ||
-                floatValue.isActive == XR_FALSE)
-                return;
-            auto& val = GetFloatRef(controllerInfo, button);
-            val = floatValue.currentState;
-            controllerInfo.enabled = true;
-        });
-
-        constexpr static const auto GetVector2fRef = [](ControllerInfo& c, const ALVR_INPUT input) -> decltype(ControllerInfo::trackpadPosition)&
-        {
-            switch (input) {
-            case ALVR_INPUT_JOYSTICK_X:
-            case ALVR_INPUT_JOYSTICK_Y:
-            case ALVR_INPUT_TRACKPAD_X:
-            case ALVR_INPUT_TRACKPAD_Y:
-            default: return c.trackpadPosition;
-            }
-        };
-        forEachButton(m_vector2fActionMap, activeProfile.vector2fMap[hand], [&](const ALVR_INPUT button)
-        {
-            XrActionStateVector2f vec2Value{ .type = XR_TYPE_ACTION_STATE_VECTOR2F, .next = nullptr, .isActive = XR_FALSE };
-            if (XR_FAILED(xrGetActionStateVector2f(m_session, &getInfo, &vec2Value)) ||
-                vec2Value.isActive == XR_FALSE)
-                return;
-            auto& val = GetVector2fRef(controllerInfo, button);
-            val.x = vec2Value.currentState.x;
-            val.y = vec2Value.currentState.y;
-            controllerInfo.enabled = true;
-        });
-
-        forEachButton(m_boolToScalarActionMap, activeProfile.boolToScalarMap[hand], [&](const ALVR_INPUT button)
-        {
-            XrActionStateBoolean boolValue{ .type = XR_TYPE_ACTION_STATE_BOOLEAN, .next = nullptr, .isActive = XR_FALSE };
-            if (XR_FAILED(xrGetActionStateBoolean(m_session, &getInfo, &boolValue)))
-                return;
-            if (boolValue.isActive == XR_TRUE && boolValue.currentState == XR_TRUE) {
-                auto& val = GetFloatRef(controllerInfo, button);
-                val = 1.0f;
-                controllerInfo.enabled = true;
-            }
-        });
+            controllerInfoList[hand].enabled = true;
+    }
 
-        forEachButton(m_scalarToBoolActionMap, activeProfile.scalarToBoolMap[hand], [&](const ALVR_INPUT button)
-        {
-            XrActionStateBoolean boolValue{ .type = XR_TYPE_ACTION_STATE_BOOLEAN, .next = nullptr, .isActive = XR_FALSE };
-            if (XR_FAILED(xrGetActionStateBoolean(m_session, &getInfo, &boolValue)))
-                return;
-            if (boolValue.isActive == XR_TRUE && boolValue.currentState == XR_TRUE) {
-                controllerInfo.buttons |= ALVR_BUTTON_FLAG(button);
-            }
-        });
+    if (activeProfilePtr == nullptr)
+        return;
+    auto& actionTable = activeProfilePtr->actionTable;
+    // bindings change with the profile & a hand coming back may have been inactive long enough for its
+    // actions to have gone dormant.
+    if (const auto generation = m_activeProfileGeneration.load(); generation != m_polledProfileGeneration) {
+        m_polledProfileGeneration = generation;
+        actionTable.ResetDormancy();
+    }
+    for (const auto hand : { Side::LEFT, Side::RIGHT }) {
+        if (m_handActive[hand] == XR_TRUE && prevHandActive[hand] == XR_FALSE)
+            actionTable.ResetDormancy(hand);
+    }
+    actionTable.Poll(m_session, controllerInfoList);
 
+    for (auto& controllerInfo : controllerInfoList) {
         if (controllerInfo.buttons != 0)
             controllerInfo.enabled = true;
     }
-    
-    if (activeProfilePtr) {
-        const auto& activeProfile = *activeProfilePtr;
-        PollPassthrougMode(activeProfile);
-        PollQuitAction(activeProfile);
-    }
+
+    const auto& activeProfile = *activeProfilePtr->profile;
+    PollPassthrougMode(activeProfile);
+    PollQuitAction(activeProfile);
 }
 
 inline bool InteractionManager::PollQuitAction(const InteractionProfile& activeProfile) {
@@ -795,7 +748,7 @@ inline void InteractionManager::ApplyHapticFeedback(const HapticsFeedback& hapti
     if (m_session == XR_NULL_HANDLE)
         return;
     const auto activeProfilePtr = m_activeProfile.load();
-    if (activeProfilePtr == nullptr || !activeProfilePtr->hapticPath)
+    if (activeProfilePtr == nullptr || !activeProfilePtr->profile->hapticPath)
         return;
     const size_t hand = hapticFeedback.alxrPath == m_alxrPaths.right_haptics ? 1 : 0;
     const XrHapticVibration vibration{
@@ -825,17 +778,18 @@ inline void InteractionManager::SetActiveProfile(const XrPath newProfilePath)
 {
     const auto newProfileItr = std::find_if
     (
-        ALXR::InteractionProfileMap.begin(),
-        ALXR::InteractionProfileMap.end(),
-        [&](const ALXR::InteractionProfile& ip) { return newProfilePath == GetXrPath(ip.path); }
+        m_compiledProfiles.begin(),
+        m_compiledProfiles.end(),
+        [&](const CompiledProfile& cp) { return cp.path != XR_NULL_PATH && newProfilePath == cp.path; }
     );
-    const auto* const newProfile = newProfileItr == ALXR::InteractionProfileMap.end() ?
+    auto* const newProfile = newProfileItr == m_compiledProfiles.end() ?
         nullptr : &*newProfileItr;
     m_activeProfile.store(newProfile);
+    m_activeProfileGeneration.fetch_add(1);
 
     Log::Write(Log::Level::Info, "Interaction Profile Changed");
     if (newProfile)
-        Log::Write(Log::Level::Info, Fmt("\tNew selected profile: \"%s\"", newProfile->path));
+        Log::Write(Log::Level::Info, Fmt("\tNew selected profile: \"%s\", %zu input actions", newProfile->profile->path, newProfile->actionTable.Size()));
     else
         Log::Write(Log::Level::Info, "No new profile selected.");
 }
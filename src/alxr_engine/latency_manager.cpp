@@ -4,6 +4,7 @@
 #include <cstdlib>
 #include <chrono>
 #include "timing.h"
+#include "frame_trace.h"
 #include "packet_types.h"
 
 LatencyManager LatencyManager::m_instance{};
@@ -28,10 +29,11 @@ void LatencyManager::OnTimeSyncRecieved(const TimeSync& timeSync)
         LatencyCollector::Instance().received(timeSync.trackingRecvFrameIndex);
 }
 
-void LatencyManager::OnPreVideoPacketRecieved(const VideoFrame& header)
+std::int64_t LatencyManager::OnPreVideoPacketRecieved(const VideoFrame& header)
 {
     if (m_rt_state.lastFrameIndex != header.trackingFrameIndex) {
         LatencyCollector::Instance().receivedFirst(header.trackingFrameIndex);
+        ALXR::FrameTracer::Instance().Record(ALXR::FrameTraceEvent::FirstPacket, header.trackingFrameIndex);
         const auto diff = static_cast<std::int64_t>(header.sentTime) - m_rt_state.timeDiff;
         const auto timeStamp = static_cast<std::int64_t>(GetSystemTimestampUs());
         const auto offset = diff > timeStamp ?
@@ -39,8 +41,10 @@ void LatencyManager::OnPreVideoPacketRecieved(const VideoFrame& header)
         LatencyCollector::Instance().estimatedSent(header.trackingFrameIndex, offset);
         m_rt_state.lastFrameIndex = header.trackingFrameIndex;
     }
-    if (const auto lostCount = ProcessVideoSeq(header))
+    const auto lostCount = ProcessVideoSeq(header);
+    if (lostCount > 0)
         LatencyCollector::Instance().packetLoss(lostCount);
+    return lostCount;
 }
 
 void LatencyManager::OnPostVideoPacketRecieved
@@ -49,14 +53,41 @@ void LatencyManager::OnPostVideoPacketRecieved
     const LatencyManager::PacketRecievedStatus& status
 )
 {
-    if (status.complete)
+    if (status.complete) {
         LatencyCollector::Instance().receivedLast(header.trackingFrameIndex);
+        ALXR::FrameTracer::Instance().Record(ALXR::FrameTraceEvent::LastPacket, header.trackingFrameIndex);
+    }
     if (status.fecFailed) {
         LatencyCollector::Instance().fecFailure();
-        SendPacketLossReport(0, 0);
     }
 }
 
+LatencyManager::VideoFrameCounters LatencyManager::GetVideoFrameCounters() const
+{
+    return {
+        .decoded = m_videoFrameCounters.decoded.load(std::memory_order_relaxed),
+        .displayed = m_videoFrameCounters.displayed.load(std::memory_order_relaxed),
+        .dropped = m_videoFrameCounters.dropped.load(std::memory_order_relaxed),
+        .reRendered = m_videoFrameCounters.reRendered.load(std::memory_order_relaxed),
+        .corrupted = m_videoFrameCounters.corrupted.load(std::memory_order_relaxed),
+        .skipped = m_videoFrameCounters.skipped.load(std::memory_order_relaxed),
+        .idrRequests = m_videoFrameCounters.idrRequests.load(std::memory_order_relaxed),
+        .queueFlushes = m_videoFrameCounters.queueFlushes.load(std::memory_order_relaxed)
+    };
+}
+
+void LatencyManager::LogVideoFrameCounters() const
+{
+    const auto counters = GetVideoFrameCounters();
+    if (counters.decoded == 0 && counters.skipped == 0)
+        return;
+    Log::Write(Log::Level::Info, Fmt("Video frames decoded: %llu, displayed: %llu, dropped: %llu (%.2f%%), re-rendered: %llu",
+        counters.decoded, counters.displayed, counters.dropped,
+        counters.decoded > 0 ? counters.dropped * 100.0 / counters.decoded : 0.0, counters.reRendered));
+    Log::Write(Log::Level::Info, Fmt("Video frames corrupted: %llu, skipped: %llu, IDR requests: %llu, decoder queue flushes: %llu",
+        counters.corrupted, counters.skipped, counters.idrRequests, counters.queueFlushes));
+}
+
 std::int64_t LatencyManager::ProcessVideoSeq(const VideoFrame& header)
 {
     const auto nextSeq = m_rt_state.prevVideoSequence + 1;
@@ -66,6 +97,11 @@ std::int64_t LatencyManager::ProcessVideoSeq(const VideoFrame& header)
         std::abs(static_cast<std::int32_t>(header.packetCounter - nextSeq)) : 0;
 }
 
+void LatencyManager::SendVideoErrorReport()
+{
+    SendPacketLossReport(0, 0);
+}
+
 void LatencyManager::SendPacketLossReport
 (
     const std::uint32_t /*fromPacketCounter*/,
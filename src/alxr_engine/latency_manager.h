@@ -14,7 +14,8 @@ struct TrackingInfo;
 
 struct LatencyManager
 {
-	void OnPreVideoPacketRecieved(const VideoFrame& header);
+	// Returns the number of video packets lost since the previous one.
+	std::int64_t OnPreVideoPacketRecieved(const VideoFrame& header);
 
 	struct PacketRecievedStatus
 	{
@@ -28,6 +29,9 @@ struct LatencyManager
 	);
 	void OnTimeSyncRecieved(const TimeSync& timeSync);
 
+	// Asks the server to recover the stream, throttled by the caller (see ALXR::ReferenceChainTracker).
+	void SendVideoErrorReport();
+
 	inline void SubmitAndSync(const std::uint64_t frameIndex, const bool reRenderOnly = false)
 	{
 		if (frameIndex == std::uint64_t(-1))
@@ -39,7 +43,31 @@ struct LatencyManager
 			SendTimeSync();
 	}
 
+	// Decoded video frame accounting, updated by the graphics plugins' decoded frame mailbox.
+	struct VideoFrameCounters
+	{
+		std::uint64_t decoded;	  // published by the decoder thread.
+		std::uint64_t displayed;  // taken by the render thread.
+		std::uint64_t dropped;	  // decoded but replaced by a newer frame before being displayed.
+		std::uint64_t reRendered; // render frames which showed the previous video frame again.
+		std::uint64_t corrupted;  // lost to the network, not recoverable by FEC.
+		std::uint64_t skipped;    // received but never decoded, stale or referencing a corrupted frame.
+		std::uint64_t idrRequests;
+		std::uint64_t queueFlushes; // the decoder fell behind its packet queue budget.
+	};
+	inline void OnVideoFrameDecoded() { m_videoFrameCounters.decoded.fetch_add(1, std::memory_order_relaxed); }
+	inline void OnVideoFrameDisplayed() { m_videoFrameCounters.displayed.fetch_add(1, std::memory_order_relaxed); }
+	inline void OnVideoFrameDropped() { m_videoFrameCounters.dropped.fetch_add(1, std::memory_order_relaxed); }
+	inline void OnVideoFrameReRendered() { m_videoFrameCounters.reRendered.fetch_add(1, std::memory_order_relaxed); }
+	inline void OnVideoFrameCorrupted() { m_videoFrameCounters.corrupted.fetch_add(1, std::memory_order_relaxed); }
+	inline void OnVideoFrameSkipped() { m_videoFrameCounters.skipped.fetch_add(1, std::memory_order_relaxed); }
+	inline void OnIDRRequested() { m_videoFrameCounters.idrRequests.fetch_add(1, std::memory_order_relaxed); }
+	inline void OnVideoQueueFlushed() { m_videoFrameCounters.queueFlushes.fetch_add(1, std::memory_order_relaxed); }
+	VideoFrameCounters GetVideoFrameCounters() const;
+	void LogVideoFrameCounters() const;
+
 	inline void ResetAll() {
+		m_videoFrameCounters.Reset();
 		m_rt_state.isFecFailed = false;
 		m_rt_state.prevVideoSequence = 0;
 		m_rt_state.lastFrameIndex = 0;
@@ -88,6 +116,30 @@ private:
 	};
 	RecieveThreadState m_rt_state{};
 
+	struct AtomicVideoFrameCounters
+	{
+		std::atomic<std::uint64_t> decoded{ 0 };
+		std::atomic<std::uint64_t> displayed{ 0 };
+		std::atomic<std::uint64_t> dropped{ 0 };
+		std::atomic<std::uint64_t> reRendered{ 0 };
+		std::atomic<std::uint64_t> corrupted{ 0 };
+		std::atomic<std::uint64_t> skipped{ 0 };
+		std::atomic<std::uint64_t> idrRequests{ 0 };
+		std::atomic<std::uint64_t> queueFlushes{ 0 };
+
+		inline void Reset() {
+			decoded = 0;
+			displayed = 0;
+			dropped = 0;
+			reRendered = 0;
+			corrupted = 0;
+			skipped = 0;
+			idrRequests = 0;
+			queueFlushes = 0;
+		}
+	};
+	AtomicVideoFrameCounters m_videoFrameCounters{};
+
 	static LatencyManager m_instance;
 };
 #endif //ALXR_LATENCY_MANAGER_H
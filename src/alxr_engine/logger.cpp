@@ -4,8 +4,14 @@
 
 #include "pch.h"
 #include "logger.h"
+#include "concurrent_queue.h"
 
 #include <sstream>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 #if defined(ANDROID)
 #define ALOGE(...) __android_log_print(ANDROID_LOG_ERROR, "alxr-client", __VA_ARGS__)
@@ -13,20 +19,27 @@
 #endif
 
 namespace {
-Log::Level g_minSeverity{Log::Level::Info};
-std::mutex g_logLock;
-}  // namespace
+using Clock = std::chrono::system_clock;
 
-namespace Log {
-void SetLevel(Level minSeverity) { g_minSeverity = minSeverity; }
+struct Record {
+    Clock::time_point time{};
+    Log::Level severity{Log::Level::Info};
+    std::string msg{};
+};
 
-void Write(Level severity, const std::string& msg) {
-    if (severity < g_minSeverity) {
-        return;
-    }
+// Pushed to only by the owning thread, popped by whoever holds the sink lock.
+struct ThreadRing {
+    constexpr static const std::size_t Capacity = 1024;
+    xrconcurrency::spsc_queue<Record, Capacity> records{};
+    std::atomic<bool> closed{false};
+};
+using ThreadRingPtr = std::shared_ptr<ThreadRing>;
+
+std::atomic<Log::Level> g_minSeverity{Log::Level::Info};
+std::atomic<bool> g_loggerStarted{false};
 
-    const auto now = std::chrono::system_clock::now();
-    const time_t now_time = std::chrono::system_clock::to_time_t(now);
+void WriteRecord(const Record& record) {
+    const time_t now_time = Clock::to_time_t(record.time);
     tm now_tm;
 #ifdef _WIN32
     localtime_s(&now_tm, &now_time);
@@ -34,28 +47,148 @@ void Write(Level severity, const std::string& msg) {
     localtime_r(&now_time, &now_tm);
 #endif
     // time_t only has second precision. Use the rounding error to get sub-second precision.
-    const auto secondRemainder = now - std::chrono::system_clock::from_time_t(now_time);
+    const auto secondRemainder = record.time - Clock::from_time_t(now_time);
     const int64_t milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(secondRemainder).count();
 
-    static std::map<Level, const char*> severityName = {
-        {Level::Verbose, "Verbose"}, {Level::Info, "Info   "}, {Level::Warning, "Warning"}, {Level::Error, "Error  "}};
+    constexpr static const std::array<const char*, 4> severityName{"Verbose", "Info   ", "Warning", "Error  "};
 
     std::ostringstream out;
     out.fill('0');
     out << "[" << std::setw(2) << now_tm.tm_hour << ":" << std::setw(2) << now_tm.tm_min << ":" << std::setw(2) << now_tm.tm_sec
         << "." << std::setw(3) << milliseconds << "]"
-        << "[" << severityName[severity] << "] " << msg << std::endl;
+        << "[" << severityName[static_cast<std::size_t>(record.severity)] << "] " << record.msg << std::endl;
 
-    std::lock_guard<std::mutex> lock(g_logLock);  // Ensure output is serialized
-    ((severity == Level::Error) ? std::clog : std::cout) << out.str();
+    const auto line = out.str();
+    ((record.severity == Log::Level::Error) ? std::clog : std::cout) << line;
 #if defined(_WIN32)
-    OutputDebugStringA(out.str().c_str());
+    OutputDebugStringA(line.c_str());
 #endif
 #if defined(ANDROID)
-    if (severity == Level::Error)
-        ALOGE("%s", out.str().c_str());
+    if (record.severity == Log::Level::Error)
+        ALOGE("%s", line.c_str());
     else
-        ALOGV("%s", out.str().c_str());
+        ALOGV("%s", line.c_str());
 #endif
 }
+
+// Formatting & sink I/O happen on a single drain thread, callers only move their message into a
+// per-thread ring. When a ring is full the message is dropped and counted, the drain thread reports
+// the count. The instance is intentionally leaked, the drain thread is never joined (joining from
+// static destructors can deadlock on dll unload), queued messages are flushed at exit instead.
+class AsyncLogger {
+public:
+    static AsyncLogger& Instance() {
+        static AsyncLogger* const instance = new AsyncLogger();
+        return *instance;
+    }
+
+    void Push(Record&& record) {
+        if (record.severity == Log::Level::Error) {
+            std::scoped_lock lock(m_sinkMutex);
+            DrainLocked();
+            WriteRecord(record);
+            return;
+        }
+        thread_local const ThreadRingHandle threadRing{*this};
+        const bool wakeDrain = record.severity >= Log::Level::Warning;
+        if (!threadRing.ring->records.push(std::move(record))) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (wakeDrain)
+            m_wake.notify_one();
+    }
+
+    void Flush() {
+        std::scoped_lock lock(m_sinkMutex);
+        DrainLocked();
+    }
+
+private:
+    constexpr static const auto DrainInterval = std::chrono::milliseconds(10);
+
+    struct ThreadRingHandle {
+        ThreadRingPtr ring;
+        ThreadRingHandle(AsyncLogger& logger) : ring(logger.Register()) {}
+        ~ThreadRingHandle() { ring->closed.store(true, std::memory_order_release); }
+    };
+
+    AsyncLogger() {
+        g_loggerStarted.store(true);
+        std::thread([this]() { DrainMain(); }).detach();
+    }
+
+    ThreadRingPtr Register() {
+        auto ring = std::make_shared<ThreadRing>();
+        std::scoped_lock lock(m_ringsMutex);
+        m_rings.push_back(ring);
+        return ring;
+    }
+
+    void DrainMain() {
+        std::unique_lock wakeLock(m_wakeMutex);
+        for (;;) {
+            m_wake.wait_for(wakeLock, DrainInterval);
+            Flush();
+        }
+    }
+
+    // m_sinkMutex must be held, it makes the holder the single consumer of every ring.
+    void DrainLocked() {
+        {
+            std::scoped_lock lock(m_ringsMutex);
+            m_drainRings = m_rings;
+            // rings of exited threads are dropped once emptied, closed is checked first so no push can follow.
+            m_rings.erase(std::remove_if(m_rings.begin(), m_rings.end(), [](const ThreadRingPtr& ring) {
+                return ring->closed.load(std::memory_order_acquire) && ring->records.empty();
+            }), m_rings.end());
+        }
+        Record record;
+        for (const auto& ring : m_drainRings) {
+            while (ring->records.try_pop(record))
+                m_batch.push_back(std::move(record));
+        }
+        m_drainRings.clear();
+        // interleave threads' messages in the order they were written.
+        std::stable_sort(m_batch.begin(), m_batch.end(), [](const Record& lhs, const Record& rhs) { return lhs.time < rhs.time; });
+        for (const auto& batchRecord : m_batch)
+            WriteRecord(batchRecord);
+        m_batch.clear();
+
+        if (const auto dropped = m_dropped.exchange(0, std::memory_order_relaxed)) {
+            WriteRecord({Clock::now(), Log::Level::Warning, std::to_string(dropped) + " log message(s) dropped, per-thread log queue full."});
+        }
+    }
+
+    std::mutex m_ringsMutex;
+    std::vector<ThreadRingPtr> m_rings;
+
+    std::mutex m_sinkMutex;
+    std::vector<ThreadRingPtr> m_drainRings;
+    std::vector<Record> m_batch;
+
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    std::atomic<std::uint64_t> m_dropped{0};
+};
+
+struct FlushOnExit {
+    ~FlushOnExit() {
+        if (g_loggerStarted.load())
+            Log::Flush();
+    }
+} g_flushOnExit;
+}  // namespace
+
+namespace Log {
+void SetLevel(Level minSeverity) { g_minSeverity.store(minSeverity, std::memory_order_relaxed); }
+
+void Enqueue(Level severity, std::string&& msg) {
+    if (severity < g_minSeverity.load(std::memory_order_relaxed)) {
+        return;
+    }
+    AsyncLogger::Instance().Push({Clock::now(), severity, std::move(msg)});
+}
+
+void Flush() { AsyncLogger::Instance().Flush(); }
 }  // namespace Log
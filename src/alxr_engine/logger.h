@@ -5,10 +5,46 @@
 #pragma once
 
 #include <string>
+#include <utility>
+
+// Severities below this are compiled out, Verbose is only kept in debug builds by default.
+#ifndef ALXR_LOG_COMPILED_MIN_LEVEL
+    #ifdef NDEBUG
+        #define ALXR_LOG_COMPILED_MIN_LEVEL 1
+    #else
+        #define ALXR_LOG_COMPILED_MIN_LEVEL 0
+    #endif
+#endif
 
 namespace Log {
 enum class Level { Verbose, Info, Warning, Error };
 
+constexpr inline const Level CompiledMinLevel = static_cast<Level>(ALXR_LOG_COMPILED_MIN_LEVEL);
+constexpr inline bool IsCompiledIn(const Level severity) { return severity >= CompiledMinLevel; }
+
 void SetLevel(Level minSeverity);
-void Write(Level severity, const std::string& msg);
+
+// Messages are queued on a per-thread lock-free ring and written out by a background thread,
+// errors are written synchronously (after any queued messages) so they survive a following crash.
+void Enqueue(Level severity, std::string&& msg);
+// Blocks until all messages queued so far have been written.
+void Flush();
+
+inline void Write(Level severity, std::string&& msg) {
+    if (IsCompiledIn(severity))
+        Enqueue(severity, std::move(msg));
+}
+inline void Write(Level severity, const std::string& msg) {
+    if (IsCompiledIn(severity))
+        Enqueue(severity, std::string(msg));
+}
 }  // namespace Log
+
+// Log::Write that does not evaluate its message (e.g. a Fmt call) when severity is compiled out,
+// Log::Write's own check only skips the enqueue of an already formatted string.
+#define ALXR_LOG(severity, ...)                \
+    do {                                       \
+        if (Log::IsCompiledIn(severity))       \
+            Log::Write(severity, __VA_ARGS__); \
+    } while (false)
+#define ALXR_LOG_VERBOSE(...) ALXR_LOG(Log::Level::Verbose, __VA_ARGS__)
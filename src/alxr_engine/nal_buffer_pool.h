@@ -0,0 +1,240 @@
+#pragma once
+#ifndef ALXR_NAL_BUFFER_POOL_H
+#define ALXR_NAL_BUFFER_POOL_H
+
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace ALXR {
+
+class NALBufferPool;
+
+// A single encoded frame buffer, either owned by a NALBufferPool or a heap
+// fallback allocated when the pool is exhausted / the frame does not fit.
+struct NALBufferSlot {
+    using NALBufferPoolPtr = std::shared_ptr<NALBufferPool>;
+
+    std::unique_ptr<std::uint8_t[]> data{};
+    std::size_t                     capacity{ 0 };
+    std::size_t                     size{ 0 };
+    std::atomic<std::uint32_t>      refCount{ 0 };
+    // Only set while the slot is acquired from a pool, keeps the pool alive
+    // until every outstanding buffer has been released.
+    NALBufferPoolPtr                pool{ nullptr };
+};
+
+// Reference counted handle to a NALBufferSlot, copies share the same underlying
+// frame data. The last handle released returns the slot to its pool.
+class NALBuffer {
+    NALBufferSlot* m_slot{ nullptr };
+
+    static inline void Release(NALBufferSlot* slot);
+
+public:
+    using ConstSpan = std::span<const std::uint8_t>;
+
+    constexpr inline NALBuffer() noexcept = default;
+    constexpr inline NALBuffer(std::nullptr_t) noexcept {}
+
+    // Takes ownership of an existing reference, the slot's reference count is not incremented.
+    static inline NALBuffer Adopt(NALBufferSlot* slot) noexcept {
+        NALBuffer ret{};
+        ret.m_slot = slot;
+        return ret;
+    }
+
+    inline NALBuffer(const NALBuffer& other) noexcept
+    : m_slot(other.m_slot) {
+        if (m_slot)
+            m_slot->refCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    inline NALBuffer(NALBuffer&& other) noexcept
+    : m_slot(other.m_slot) {
+        other.m_slot = nullptr;
+    }
+
+    inline NALBuffer& operator=(const NALBuffer& other) noexcept {
+        NALBuffer tmp{ other };
+        std::swap(m_slot, tmp.m_slot);
+        return *this;
+    }
+
+    inline NALBuffer& operator=(NALBuffer&& other) noexcept {
+        NALBuffer tmp{ std::move(other) };
+        std::swap(m_slot, tmp.m_slot);
+        return *this;
+    }
+
+    inline ~NALBuffer() { reset(); }
+
+    inline void reset() {
+        if (m_slot == nullptr)
+            return;
+        Release(m_slot);
+        m_slot = nullptr;
+    }
+
+    // Gives up ownership of the reference without releasing it, see Adopt.
+    inline NALBufferSlot* detach() noexcept {
+        auto slot = m_slot;
+        m_slot = nullptr;
+        return slot;
+    }
+
+    constexpr inline bool empty() const { return m_slot == nullptr || m_slot->size == 0; }
+    constexpr inline explicit operator bool() const { return m_slot != nullptr; }
+
+    constexpr inline std::uint8_t* data() const { return m_slot ? m_slot->data.get() : nullptr; }
+    constexpr inline std::size_t size() const { return m_slot ? m_slot->size : 0; }
+    constexpr inline std::size_t capacity() const { return m_slot ? m_slot->capacity : 0; }
+    constexpr inline ConstSpan span() const { return { data(), size() }; }
+
+    inline bool IsPooled() const { return m_slot != nullptr && m_slot->pool != nullptr; }
+};
+
+// Fixed-capacity pool of pre-allocated encoded frame buffers, shared between the network
+// thread (acquire) and decoder thread(s) (release). In steady state acquiring a buffer does
+// not touch the heap, counters are kept to track when the pool runs dry or is undersized.
+class NALBufferPool final : public std::enable_shared_from_this<NALBufferPool> {
+
+    std::vector<NALBufferSlot>  m_slots;
+    std::vector<NALBufferSlot*> m_freeList;
+    std::mutex                  m_freeListMutex;
+    const std::size_t           m_slotCapacity;
+
+    // Enough to satisfy AV_INPUT_BUFFER_PADDING_SIZE, trailing bytes are always zeroed.
+    constexpr static const std::size_t PaddingSize = 64;
+
+    friend class NALBuffer;
+
+    inline void ReturnSlot(NALBufferSlot* slot) {
+        std::scoped_lock lk(m_freeListMutex);
+        m_freeList.push_back(slot);
+    }
+
+    inline NALBufferSlot* TakeSlot() {
+        std::scoped_lock lk(m_freeListMutex);
+        if (m_freeList.empty())
+            return nullptr;
+        const auto slot = m_freeList.back();
+        m_freeList.pop_back();
+        const std::size_t inUse = m_slots.size() - m_freeList.size();
+        if (inUse > m_stats.highWatermark.load(std::memory_order_relaxed))
+            m_stats.highWatermark.store(inUse, std::memory_order_relaxed);
+        return slot;
+    }
+
+    static inline void InitSlot(NALBufferSlot& slot, const std::size_t capacity) {
+        slot.data = std::make_unique<std::uint8_t[]>(capacity + PaddingSize);
+        slot.capacity = capacity;
+        slot.size = 0;
+        slot.refCount.store(0, std::memory_order_relaxed);
+    }
+
+    struct PrivateTag {};
+
+public:
+    struct Stats {
+        std::atomic<std::uint64_t> acquired{ 0 };
+        std::atomic<std::uint64_t> exhausted{ 0 }; // no free slot, heap fallback used.
+        std::atomic<std::uint64_t> oversized{ 0 }; // frame larger than slot capacity, heap fallback used.
+        std::atomic<std::size_t>   highWatermark{ 0 };
+    };
+
+    NALBufferPool(PrivateTag, const std::size_t slotCount, const std::size_t slotCapacity)
+    : m_slots(slotCount), m_slotCapacity(slotCapacity)
+    {
+        m_freeList.reserve(slotCount);
+        for (auto& slot : m_slots) {
+            InitSlot(slot, slotCapacity);
+            m_freeList.push_back(&slot);
+        }
+    }
+
+    inline NALBufferPool(const NALBufferPool&) = delete;
+    inline NALBufferPool(NALBufferPool&&) = delete;
+    inline NALBufferPool& operator=(const NALBufferPool&) = delete;
+    inline NALBufferPool& operator=(NALBufferPool&&) = delete;
+
+    static inline std::shared_ptr<NALBufferPool> Create(const std::size_t slotCount, const std::size_t slotCapacity) {
+        return std::make_shared<NALBufferPool>(PrivateTag{}, slotCount, slotCapacity);
+    }
+
+    // Rough upper bound of a single encoded frame (typically an IDR) for a stereo
+    // eyeWidth x eyeHeight stream, assumes a compression ratio of at least 8:1 over 8bit 4:2:0.
+    // With the stream's bitrate known (non-zero), also room for an IDR of IDRBitrateFactor
+    // average frames, a high bitrate at a low frame rate can exceed the resolution bound.
+    constexpr static const std::size_t IDRBitrateFactor = 8;
+    constexpr static inline std::size_t EstimateFrameCapacity
+    (
+        const std::size_t eyeWidth,
+        const std::size_t eyeHeight,
+        const std::uint64_t bitrateBps = 0,
+        const float refreshRate = 0.0f
+    ) {
+        constexpr const std::size_t MinCapacity = 1u << 20;
+        const std::size_t yuv420Size = (eyeWidth * 2) * eyeHeight * 3 / 2;
+        std::size_t capacity = std::max(MinCapacity, yuv420Size / 8);
+        if (bitrateBps > 0 && refreshRate >= 1.0f) {
+            const auto averageFrameSize = static_cast<std::size_t>(bitrateBps / 8 / refreshRate);
+            capacity = std::max(capacity, averageFrameSize * IDRBitrateFactor);
+        }
+        return capacity;
+    }
+
+    // Copies newData into a pooled buffer, falls back to a (counted) heap allocation when the
+    // pool is exhausted or newData exceeds the slot capacity.
+    inline NALBuffer Acquire(const std::span<const std::uint8_t>& newData) {
+        m_stats.acquired.fetch_add(1, std::memory_order_relaxed);
+        NALBufferSlot* slot = nullptr;
+        if (newData.size() > m_slotCapacity) {
+            m_stats.oversized.fetch_add(1, std::memory_order_relaxed);
+        } else if ((slot = TakeSlot()) == nullptr) {
+            m_stats.exhausted.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (slot != nullptr) {
+            slot->pool = shared_from_this();
+        } else {
+            slot = new NALBufferSlot();
+            InitSlot(*slot, newData.size());
+        }
+        assert(slot->refCount.load() == 0);
+        slot->refCount.store(1, std::memory_order_relaxed);
+        slot->size = newData.size();
+        if (!newData.empty())
+            std::memcpy(slot->data.get(), newData.data(), newData.size());
+        std::memset(slot->data.get() + newData.size(), 0, PaddingSize);
+        return NALBuffer::Adopt(slot);
+    }
+
+    constexpr inline std::size_t SlotCount() const { return m_slots.size(); }
+    constexpr inline std::size_t SlotCapacity() const { return m_slotCapacity; }
+    inline const Stats& GetStats() const { return m_stats; }
+
+private:
+    Stats m_stats{};
+};
+
+inline void NALBuffer::Release(NALBufferSlot* slot) {
+    assert(slot != nullptr);
+    if (slot->refCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+    if (auto pool = std::move(slot->pool)) {
+        slot->size = 0;
+        pool->ReturnSlot(slot);
+        return;
+    }
+    delete slot;
+}
+
+}
+#endif
@@ -0,0 +1,407 @@
+#include "pch.h"
+#include "common.h"
+#include "nal_parser.h"
+
+#include <bit>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define ALXR_NAL_PARSER_SSE2
+        #include <emmintrin.h>
+    #endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define ALXR_NAL_PARSER_NEON
+    #include <arm_neon.h>
+#endif
+
+namespace ALXR {
+
+std::size_t FindStartCodeScalar(const std::uint8_t* data, const std::size_t offset, const std::size_t size) {
+    if (size < 3)
+        return size;
+    // skips ahead by how far the byte at i + 2 rules out a start code beginning before it.
+    std::size_t i = offset;
+    while (i + 2 < size) {
+        const std::uint8_t c = data[i + 2];
+        if (c > 1)
+            i += 3;
+        else if (c == 0)
+            ++i;
+        else if (data[i + 1] != 0 || data[i] != 0)
+            i += 3;
+        else
+            return i;
+    }
+    return size;
+}
+
+namespace {
+
+constexpr const std::uint8_t StartCode[] = { 0x00, 0x00, 0x00, 0x01 };
+
+#ifdef ALXR_NAL_PARSER_SSE2
+std::size_t FindStartCodeSSE2(const std::uint8_t* data, const std::size_t size) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    std::size_t i = 0;
+    for (; i + 18 <= size; i += 16) {
+        const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 1));
+        const __m128i b2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 2));
+        const __m128i match = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi8(b0, zero), _mm_cmpeq_epi8(b1, zero)),
+                                            _mm_cmpeq_epi8(b2, one));
+        const unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(match));
+        if (mask != 0)
+            return i + std::countr_zero(mask);
+    }
+    return FindStartCodeScalar(data, i, size);
+}
+#endif
+
+#ifdef ALXR_NAL_PARSER_NEON
+std::size_t FindStartCodeNEON(const std::uint8_t* data, const std::size_t size) {
+    const uint8x16_t zero = vdupq_n_u8(0);
+    const uint8x16_t one = vdupq_n_u8(1);
+    std::size_t i = 0;
+    for (; i + 18 <= size; i += 16) {
+        const uint8x16_t match = vandq_u8(vandq_u8(vceqq_u8(vld1q_u8(data + i), zero),
+                                                   vceqq_u8(vld1q_u8(data + i + 1), zero)),
+                                          vceqq_u8(vld1q_u8(data + i + 2), one));
+        if (vmaxvq_u8(match) != 0) {
+            // narrow each lane to a nibble for a 64-bit mask, 4 bits per byte.
+            const std::uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(match), 4)), 0);
+            return i + (std::countr_zero(mask) >> 2);
+        }
+    }
+    return FindStartCodeScalar(data, i, size);
+}
+#endif
+
+// RBSP bit reader, skips emulation prevention bytes (00 00 03) while reading.
+class BitReader {
+public:
+    BitReader(const NALSpan& data, const std::size_t headerSize)
+    : m_data(data), m_pos(headerSize) {}
+
+    inline bool IsValid() const { return !m_overrun; }
+
+    std::uint32_t ReadBit() {
+        if (m_bitsLeft == 0 && !LoadByte())
+            return 0;
+        --m_bitsLeft;
+        return (m_byte >> m_bitsLeft) & 1;
+    }
+
+    std::uint32_t ReadBits(std::uint32_t count) {
+        std::uint32_t value = 0;
+        while (count-- > 0)
+            value = (value << 1) | ReadBit();
+        return value;
+    }
+
+    void SkipBits(std::uint32_t count) {
+        while (count-- > 0)
+            ReadBit();
+    }
+
+    // ue(v) exp-Golomb, values past 32 bits are treated as malformed.
+    std::uint32_t ReadUE() {
+        std::uint32_t leadingZeros = 0;
+        while (ReadBit() == 0) {
+            if (m_overrun || ++leadingZeros > 31) {
+                m_overrun = true;
+                return 0;
+            }
+        }
+        return ((1u << leadingZeros) - 1) + ReadBits(leadingZeros);
+    }
+
+private:
+    bool LoadByte() {
+        if (m_pos >= m_data.size()) {
+            m_overrun = true;
+            return false;
+        }
+        std::uint8_t byte = m_data[m_pos++];
+        if (m_zeroCount >= 2 && byte == 0x03) {
+            if (m_pos >= m_data.size()) {
+                m_overrun = true;
+                return false;
+            }
+            byte = m_data[m_pos++];
+            m_zeroCount = 0;
+        }
+        m_zeroCount = byte == 0 ? m_zeroCount + 1 : 0;
+        m_byte = byte;
+        m_bitsLeft = 8;
+        return true;
+    }
+
+    NALSpan       m_data;
+    std::size_t   m_pos;
+    std::uint32_t m_zeroCount = 0;
+    std::uint32_t m_bitsLeft = 0;
+    std::uint8_t  m_byte = 0;
+    bool          m_overrun = false;
+};
+
+inline std::size_t NALHeaderSize(const ALVR_CODEC codec) {
+    return codec == ALVR_CODEC_H264 ? 1 : 2;
+}
+
+inline bool IsParameterSet(const std::uint8_t type, const ALVR_CODEC codec) {
+    if (codec == ALVR_CODEC_H264)
+        return type == H264NalType::SPS || type == H264NalType::PPS;
+    return type == HEVCNalType::VPS || type == HEVCNalType::SPS || type == HEVCNalType::PPS;
+}
+
+inline bool IsSlice(const std::uint8_t type, const ALVR_CODEC codec) {
+    if (codec == ALVR_CODEC_H264)
+        return type == H264NalType::Slice || type == H264NalType::PartitionA || type == H264NalType::IDR;
+    return type <= HEVCNalType::IRAPEnd && (type < 10 || type >= HEVCNalType::IRAPBegin);
+}
+
+inline bool IsKeyFrameSlice(const std::uint8_t type, const ALVR_CODEC codec) {
+    if (codec == ALVR_CODEC_H264)
+        return type == H264NalType::IDR;
+    return type >= HEVCNalType::IRAPBegin && type <= HEVCNalType::IRAPEnd;
+}
+
+inline bool IsSEI(const std::uint8_t type, const ALVR_CODEC codec) {
+    if (codec == ALVR_CODEC_H264)
+        return type == H264NalType::SEI;
+    return type == HEVCNalType::PrefixSEI || type == HEVCNalType::SuffixSEI;
+}
+
+void SkipHEVCProfileTierLevel(BitReader& reader, const std::uint32_t maxSubLayersMinus1) {
+    // general_profile_space .. general_level_idc
+    reader.SkipBits(2 + 1 + 5 + 32 + 4 + 43 + 1 + 8);
+    std::uint32_t subLayerProfilePresent = 0, subLayerLevelPresent = 0;
+    for (std::uint32_t i = 0; i < maxSubLayersMinus1; ++i) {
+        subLayerProfilePresent |= reader.ReadBit() << i;
+        subLayerLevelPresent |= reader.ReadBit() << i;
+    }
+    if (maxSubLayersMinus1 > 0)
+        reader.SkipBits(2 * (8 - maxSubLayersMinus1));
+    for (std::uint32_t i = 0; i < maxSubLayersMinus1; ++i) {
+        if (subLayerProfilePresent & (1u << i))
+            reader.SkipBits(2 + 1 + 5 + 32 + 4 + 43 + 1);
+        if (subLayerLevelPresent & (1u << i))
+            reader.SkipBits(8);
+    }
+}
+
+SliceType ParseSliceType(const NALUnit& unit, const ALVR_CODEC codec, const ParameterSetCache* paramSets) {
+    BitReader reader(unit.data, NALHeaderSize(codec));
+    if (codec == ALVR_CODEC_H264) {
+        reader.ReadUE(); // first_mb_in_slice
+        const std::uint32_t sliceType = reader.ReadUE();
+        if (!reader.IsValid())
+            return SliceType::Unknown;
+        switch (sliceType % 5) {
+        case 0: case 3: return SliceType::P; // P, SP
+        case 1: return SliceType::B;
+        default: return SliceType::I;        // I, SI
+        }
+    }
+
+    if (IsKeyFrameSlice(unit.type, codec))
+        return SliceType::I;
+    // only the first segment of a picture has slice_type at a fixed position.
+    if (reader.ReadBit() == 0 || paramSets == nullptr)
+        return SliceType::Unknown;
+    const std::uint32_t ppsId = reader.ReadUE();
+    const int extraSliceHeaderBits = paramSets->ExtraSliceHeaderBits(ppsId);
+    if (!reader.IsValid() || extraSliceHeaderBits < 0)
+        return SliceType::Unknown;
+    reader.SkipBits(extraSliceHeaderBits);
+    const std::uint32_t sliceType = reader.ReadUE();
+    if (!reader.IsValid())
+        return SliceType::Unknown;
+    switch (sliceType) {
+    case 0: return SliceType::B;
+    case 1: return SliceType::P;
+    case 2: return SliceType::I;
+    }
+    return SliceType::Unknown;
+}
+
+}
+
+std::size_t FindStartCode(const std::uint8_t* data, const std::size_t size) {
+    if (data == nullptr)
+        return size;
+#if defined(ALXR_NAL_PARSER_SSE2)
+    return FindStartCodeSSE2(data, size);
+#elif defined(ALXR_NAL_PARSER_NEON)
+    return FindStartCodeNEON(data, size);
+#else
+    return FindStartCodeScalar(data, 0, size);
+#endif
+}
+
+bool NextNALUnit(const NALSpan& frame, std::size_t& offset, const ALVR_CODEC codec, /*[out]*/ NALUnit& unit) {
+    if (offset >= frame.size())
+        return false;
+    const std::size_t startCode = offset + FindStartCode(frame.data() + offset, frame.size() - offset);
+    const std::size_t begin = startCode + 3;
+    if (begin + NALHeaderSize(codec) > frame.size()) {
+        offset = frame.size();
+        return false;
+    }
+    std::size_t end = begin + FindStartCode(frame.data() + begin, frame.size() - begin);
+    offset = end;
+    // trailing_zero_8bits & a 4 byte start code's zero_byte belong to neither unit.
+    while (end > begin && frame[end - 1] == 0)
+        --end;
+    unit.data = frame.subspan(begin, end - begin);
+    unit.offset = (startCode > 0 && frame[startCode - 1] == 0) ? startCode - 1 : startCode;
+    unit.type = codec == ALVR_CODEC_H264 ?
+        frame[begin] & std::uint8_t(0x1F) :
+        (frame[begin] >> 1) & std::uint8_t(0x3F);
+    return true;
+}
+
+const char* ToString(const SliceType sliceType) {
+    switch (sliceType) {
+    case SliceType::I: return "I";
+    case SliceType::P: return "P";
+    case SliceType::B: return "B";
+    default: return "Unknown";
+    }
+}
+
+ParameterSetCache::ParameterSetCache(const ALVR_CODEC codec) {
+    Reset(codec);
+}
+
+void ParameterSetCache::Reset(const ALVR_CODEC codec) {
+    m_codec = codec;
+    for (auto& vps : m_vps) vps.clear();
+    for (auto& sps : m_sps) sps.clear();
+    for (auto& pps : m_pps) pps.clear();
+    m_ppsExtraSliceHeaderBits.fill(-1);
+}
+
+bool ParameterSetCache::Update(const NALUnit& unit) {
+    if (!IsParameterSet(unit.type, m_codec))
+        return false;
+    BitReader reader(unit.data, NALHeaderSize(m_codec));
+    std::vector<std::uint8_t>* entry = nullptr;
+    if (m_codec == ALVR_CODEC_H264) {
+        if (unit.type == H264NalType::SPS) {
+            reader.SkipBits(8 + 8 + 8); // profile_idc, constraint_set flags, level_idc
+            const std::uint32_t spsId = reader.ReadUE();
+            if (reader.IsValid() && spsId < MaxSPSCount)
+                entry = &m_sps[spsId];
+        } else {
+            const std::uint32_t ppsId = reader.ReadUE();
+            if (reader.IsValid() && ppsId < MaxPPSCount)
+                entry = &m_pps[ppsId];
+        }
+    } else {
+        switch (unit.type) {
+        case HEVCNalType::VPS: {
+            const std::uint32_t vpsId = reader.ReadBits(4);
+            if (reader.IsValid())
+                entry = &m_vps[vpsId];
+        } break;
+        case HEVCNalType::SPS: {
+            reader.SkipBits(4); // sps_video_parameter_set_id
+            const std::uint32_t maxSubLayersMinus1 = reader.ReadBits(3);
+            reader.SkipBits(1); // sps_temporal_id_nesting_flag
+            SkipHEVCProfileTierLevel(reader, maxSubLayersMinus1);
+            const std::uint32_t spsId = reader.ReadUE();
+            if (reader.IsValid() && spsId < 16)
+                entry = &m_sps[spsId];
+        } break;
+        case HEVCNalType::PPS: {
+            const std::uint32_t ppsId = reader.ReadUE();
+            reader.ReadUE();    // pps_seq_parameter_set_id
+            reader.SkipBits(2); // dependent_slice_segments_enabled_flag, output_flag_present_flag
+            const std::uint32_t extraSliceHeaderBits = reader.ReadBits(3);
+            if (reader.IsValid() && ppsId < 64) {
+                entry = &m_pps[ppsId];
+                m_ppsExtraSliceHeaderBits[ppsId] = static_cast<std::int8_t>(extraSliceHeaderBits);
+            }
+        } break;
+        }
+    }
+    if (entry == nullptr)
+        return false;
+    entry->assign(unit.data.begin(), unit.data.end());
+    return true;
+}
+
+bool ParameterSetCache::IsComplete() const {
+    const auto hasAny = [](const auto& sets) {
+        for (const auto& ps : sets)
+            if (!ps.empty())
+                return true;
+        return false;
+    };
+    return hasAny(m_sps) && hasAny(m_pps) && (m_codec == ALVR_CODEC_H264 || hasAny(m_vps));
+}
+
+std::vector<std::uint8_t> ParameterSetCache::Serialize() const {
+    std::vector<std::uint8_t> csd;
+    const auto append = [&csd](const auto& sets) {
+        for (const auto& ps : sets) {
+            if (ps.empty())
+                continue;
+            csd.insert(csd.end(), std::begin(StartCode), std::end(StartCode));
+            csd.insert(csd.end(), ps.begin(), ps.end());
+        }
+    };
+    append(m_vps);
+    append(m_sps);
+    append(m_pps);
+    return csd;
+}
+
+int ParameterSetCache::ExtraSliceHeaderBits(const std::uint32_t ppsId) const {
+    return ppsId < MaxPPSCount ? m_ppsExtraSliceHeaderBits[ppsId] : -1;
+}
+
+NALFrameInfo ParseNALFrame(const NALSpan& frame, const ALVR_CODEC codec, ParameterSetCache* paramSets) {
+    NALFrameInfo info {
+        .nalCount = 0,
+        .configSize = 0,
+        .hasParameterSets = false,
+        .isKeyFrame = false,
+        .hasSEI = false,
+        .hasSlices = false,
+        .sliceType = SliceType::Unknown
+    };
+    bool isLeadingConfig = true;
+    std::size_t offset = 0;
+    NALUnit unit;
+    while (NextNALUnit(frame, offset, codec, unit)) {
+        ++info.nalCount;
+        if (IsParameterSet(unit.type, codec)) {
+            info.hasParameterSets = true;
+            if (paramSets != nullptr)
+                paramSets->Update(unit);
+            continue;
+        }
+        if (isLeadingConfig) {
+            isLeadingConfig = false;
+            if (info.hasParameterSets)
+                info.configSize = unit.offset;
+        }
+        if (IsSEI(unit.type, codec)) {
+            info.hasSEI = true;
+        } else if (IsSlice(unit.type, codec)) {
+            info.isKeyFrame |= IsKeyFrameSlice(unit.type, codec);
+            if (!info.hasSlices) {
+                info.hasSlices = true;
+                info.sliceType = ParseSliceType(unit, codec, paramSets);
+            }
+        }
+    }
+    if (isLeadingConfig && info.hasParameterSets)
+        info.configSize = frame.size();
+    return info;
+}
+
+}
@@ -0,0 +1,107 @@
+#pragma once
+#ifndef ALXR_NAL_PARSER_H
+#define ALXR_NAL_PARSER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <span>
+#include <vector>
+#include "ALVR-common/packet_types.h"
+
+namespace ALXR {
+
+using NALSpan = std::span<const std::uint8_t>;
+
+// Offset of the first Annex-B start code (00 00 01) in [data, data + size), size if there is none.
+// SSE2/NEON accelerated, slice data can not contain a start code (emulation prevention) so a 4MB
+// frame is scanned in 16 byte strides with only a handful of candidate checks.
+std::size_t FindStartCode(const std::uint8_t* data, const std::size_t size);
+// The byte-wise scan FindStartCode falls back to (& finishes the SIMD scan's tail with), from offset.
+std::size_t FindStartCodeScalar(const std::uint8_t* data, const std::size_t offset, const std::size_t size);
+
+struct NALUnit {
+    NALSpan       data;   // NAL header & payload, up to the next start code.
+    std::size_t   offset; // of the unit's start code within the frame, including a 4 byte start code's zero_byte.
+    std::uint8_t  type;   // nal_unit_type
+};
+
+// Finds the NAL unit at or after offset & advances offset past it, false once the frame is exhausted.
+bool NextNALUnit(const NALSpan& frame, std::size_t& offset, const ALVR_CODEC codec, /*[out]*/ NALUnit& unit);
+
+enum class SliceType : std::uint8_t {
+    Unknown,
+    I,
+    P,
+    B
+};
+const char* ToString(const SliceType sliceType);
+
+namespace H264NalType {
+    constexpr const std::uint8_t Slice = 1;
+    constexpr const std::uint8_t PartitionA = 2; // slice header & mb types, partitions B & C (3, 4) have neither.
+    constexpr const std::uint8_t IDR = 5;
+    constexpr const std::uint8_t SEI = 6;
+    constexpr const std::uint8_t SPS = 7;
+    constexpr const std::uint8_t PPS = 8;
+}
+namespace HEVCNalType {
+    constexpr const std::uint8_t IRAPBegin = 16; // BLA_W_LP
+    constexpr const std::uint8_t IRAPEnd = 23;   // RSV_IRAP_VCL23, inclusive.
+    constexpr const std::uint8_t VPS = 32;
+    constexpr const std::uint8_t SPS = 33;
+    constexpr const std::uint8_t PPS = 34;
+    constexpr const std::uint8_t PrefixSEI = 39;
+    constexpr const std::uint8_t SuffixSEI = 40;
+}
+
+// VPS/SPS/PPS units seen in the stream, by id. A decoder (re)started after packet loss can be fed the
+// cached parameter sets instead of waiting for the next in-band ones, HEVC slice headers also depend
+// on PPS fields to be parsed.
+class ParameterSetCache {
+public:
+    explicit ParameterSetCache(const ALVR_CODEC codec = ALVR_CODEC_H265);
+
+    void Reset(const ALVR_CODEC codec);
+    inline ALVR_CODEC Codec() const { return m_codec; }
+
+    // Stores unit if it is a parameter set, returns false for any other unit (or a malformed one).
+    bool Update(const NALUnit& unit);
+
+    // At least an SPS & PPS (& VPS for HEVC) have been cached.
+    bool IsComplete() const;
+
+    // Every cached parameter set as Annex-B units (4 byte start codes), VPS then SPS then PPS.
+    std::vector<std::uint8_t> Serialize() const;
+
+    // HEVC num_extra_slice_header_bits of PPS ppsId, -1 if it has not been seen.
+    int ExtraSliceHeaderBits(const std::uint32_t ppsId) const;
+
+private:
+    constexpr static const std::size_t MaxVPSCount = 16;
+    constexpr static const std::size_t MaxSPSCount = 32;
+    constexpr static const std::size_t MaxPPSCount = 256;
+
+    ALVR_CODEC m_codec;
+    std::array<std::vector<std::uint8_t>, MaxVPSCount> m_vps{};
+    std::array<std::vector<std::uint8_t>, MaxSPSCount> m_sps{};
+    std::array<std::vector<std::uint8_t>, MaxPPSCount> m_pps{};
+    std::array<std::int8_t, MaxPPSCount>               m_ppsExtraSliceHeaderBits{};
+};
+
+struct NALFrameInfo {
+    std::uint32_t nalCount;
+    std::size_t   configSize;       // bytes of the leading parameter set units, 0 if the frame does not start with one.
+    bool          hasParameterSets;
+    bool          isKeyFrame;       // H.264 IDR, HEVC IRAP (IDR/CRA/BLA) slices.
+    bool          hasSEI;
+    bool          hasSlices;
+    SliceType     sliceType;        // of the frame's first slice.
+};
+
+// Walks every NAL unit of an encoded frame. Parameter sets are cached into paramSets when given,
+// which also supplies the PPS fields HEVC slice types are parsed with.
+NALFrameInfo ParseNALFrame(const NALSpan& frame, const ALVR_CODEC codec, ParameterSetCache* paramSets = nullptr);
+
+}
+#endif
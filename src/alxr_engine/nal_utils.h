@@ -4,6 +4,7 @@
 
 #include <span>
 #include "ALVR-common/packet_types.h"
+#include "nal_parser.h"
 
 enum class NalType : std::uint8_t
 {
@@ -32,12 +33,16 @@ constexpr inline bool is_idr(const NalType t, const ALVR_CODEC codec) {
 using PacketType = std::span<std::uint8_t>;
 using ConstPacketType = std::span<const std::uint8_t>;
 
+// NAL type of the packet's first unit, which must follow a 3 or 4 byte start code.
 constexpr inline NalType get_nal_type(const ConstPacketType& packet, const ALVR_CODEC codec)
 {
-    if (packet.size() < 5) return NalType::Unknown;
+    if (packet.size() < 4 || packet[0] != 0 || packet[1] != 0) return NalType::Unknown;
+    const std::size_t header = packet[2] == 1 ? 3 : 4;
+    if (packet.size() <= header || (header == 4 && (packet[2] != 0 || packet[3] != 1)))
+        return NalType::Unknown;
     return NalType(codec == ALVR_CODEC_H264 ?
-        packet[4] & std::uint8_t(0x1F) :
-        (packet[4] >> 1) & std::uint8_t(0x3F));
+        packet[header] & std::uint8_t(0x1F) :
+        (packet[header] >> 1) & std::uint8_t(0x3F));
 }
 
 constexpr inline bool is_config(const ConstPacketType& packet, const ALVR_CODEC codec)
@@ -51,41 +56,13 @@ constexpr inline bool is_idr(const ConstPacketType& packet, const ALVR_CODEC cod
 }
 
 // This frame contains (VPS + )SPS + PPS + IDR on NVENC H.264 (H.265) stream.
- // (VPS + )SPS + PPS has short size (8bytes + 28bytes in some environment), so we can assume SPS + PPS is contained in first fragment.
+// Returns the leading parameter set units, empty if the packet does not start with them.
 inline ConstPacketType find_vpssps(const ConstPacketType& packet, const ALVR_CODEC codec)
 {
-    const auto nalType = get_nal_type(packet, codec);
-    if (!is_config(nalType, codec))
+    if (!is_config(get_nal_type(packet, codec), codec))
         return PacketType{};
-
-    const std::size_t nalCount = [&]() -> std::size_t
-    {
-        switch (codec)
-        {
-        case ALVR_CODEC_H264: return 3;
-        case ALVR_CODEC_H265: return 4;
-        }
-        return std::size_t(-1);
-    }();
-    std::size_t zeroes = 0, foundNals = 0;
-    for (std::size_t i = 0; i < packet.size(); ++i)
-    {
-        if (packet[i] == 0)
-            ++zeroes;
-        else if (packet[i] == 1)
-        {
-            if (zeroes >= 2)
-            {
-                ++foundNals;
-                if (foundNals >= nalCount)
-                    return packet.subspan(0, i - 3);
-            }
-            zeroes = 0;
-        }
-        else
-            zeroes = 0;
-    }
-    return PacketType{};
+    const auto frameInfo = ALXR::ParseNALFrame(packet, codec);
+    return packet.subspan(0, frameInfo.configSize);
 }
 
 #endif
@@ -36,13 +36,17 @@
 
 #include "xr_utils.h"
 #include "concurrent_queue.h"
+#include "tracking_frame_ring.h"
 //#include "alxr_engine.h"
 #include "alxr_ctypes.h"
 #include "ALVR-common/packet_types.h"
 #include "timing.h"
 #include "latency_manager.h"
+#include "frame_trace.h"
 #include "interaction_profiles.h"
 #include "interaction_manager.h"
+#include "pose_prediction.h"
+#include "hand_skeleton.h"
 
 #ifdef XR_USE_PLATFORM_ANDROID
 #ifndef ALXR_ENGINE_DISABLE_QUIT_ACTION
@@ -260,66 +264,6 @@ constexpr inline const XrView IdentityView {
     .fov = { 0,0,0,0 }
 };
 
-constexpr inline XrHandJointEXT GetJointParent(const XrHandJointEXT h)
-{
-    switch (h)
-    {
-    case XR_HAND_JOINT_PALM_EXT: return XR_HAND_JOINT_PALM_EXT;
-    case XR_HAND_JOINT_WRIST_EXT: return XR_HAND_JOINT_PALM_EXT;
-    case XR_HAND_JOINT_THUMB_METACARPAL_EXT: return XR_HAND_JOINT_WRIST_EXT;
-    case XR_HAND_JOINT_THUMB_PROXIMAL_EXT: return XR_HAND_JOINT_THUMB_METACARPAL_EXT;
-    case XR_HAND_JOINT_THUMB_DISTAL_EXT: return XR_HAND_JOINT_THUMB_PROXIMAL_EXT;
-    case XR_HAND_JOINT_THUMB_TIP_EXT: return XR_HAND_JOINT_THUMB_DISTAL_EXT;
-    case XR_HAND_JOINT_INDEX_METACARPAL_EXT: return XR_HAND_JOINT_WRIST_EXT;
-    case XR_HAND_JOINT_INDEX_PROXIMAL_EXT: return XR_HAND_JOINT_INDEX_METACARPAL_EXT;
-    case XR_HAND_JOINT_INDEX_INTERMEDIATE_EXT: return XR_HAND_JOINT_INDEX_PROXIMAL_EXT;
-    case XR_HAND_JOINT_INDEX_DISTAL_EXT: return XR_HAND_JOINT_INDEX_INTERMEDIATE_EXT;
-    case XR_HAND_JOINT_INDEX_TIP_EXT: return XR_HAND_JOINT_INDEX_DISTAL_EXT;
-    case XR_HAND_JOINT_MIDDLE_METACARPAL_EXT: return XR_HAND_JOINT_WRIST_EXT;
-    case XR_HAND_JOINT_MIDDLE_PROXIMAL_EXT: return XR_HAND_JOINT_MIDDLE_METACARPAL_EXT;
-    case XR_HAND_JOINT_MIDDLE_INTERMEDIATE_EXT: return XR_HAND_JOINT_MIDDLE_PROXIMAL_EXT;
-    case XR_HAND_JOINT_MIDDLE_DISTAL_EXT: return XR_HAND_JOINT_MIDDLE_INTERMEDIATE_EXT;
-    case XR_HAND_JOINT_MIDDLE_TIP_EXT: return XR_HAND_JOINT_MIDDLE_DISTAL_EXT;
-    case XR_HAND_JOINT_RING_METACARPAL_EXT: return XR_HAND_JOINT_WRIST_EXT;
-    case XR_HAND_JOINT_RING_PROXIMAL_EXT: return XR_HAND_JOINT_RING_METACARPAL_EXT;
-    case XR_HAND_JOINT_RING_INTERMEDIATE_EXT: return XR_HAND_JOINT_RING_PROXIMAL_EXT;
-    case XR_HAND_JOINT_RING_DISTAL_EXT: return XR_HAND_JOINT_RING_INTERMEDIATE_EXT;
-    case XR_HAND_JOINT_RING_TIP_EXT: return XR_HAND_JOINT_RING_DISTAL_EXT;
-    case XR_HAND_JOINT_LITTLE_METACARPAL_EXT: return XR_HAND_JOINT_WRIST_EXT;
-    case XR_HAND_JOINT_LITTLE_PROXIMAL_EXT: return XR_HAND_JOINT_LITTLE_METACARPAL_EXT;
-    case XR_HAND_JOINT_LITTLE_INTERMEDIATE_EXT: return XR_HAND_JOINT_LITTLE_PROXIMAL_EXT;
-    case XR_HAND_JOINT_LITTLE_DISTAL_EXT: return XR_HAND_JOINT_LITTLE_INTERMEDIATE_EXT;
-    case XR_HAND_JOINT_LITTLE_TIP_EXT: return XR_HAND_JOINT_LITTLE_DISTAL_EXT;
-    }
-    return h;
-}
-
-constexpr inline XrHandJointEXT ToXRHandJointType(const ALVR_HAND h)
-{
-    switch (h)
-    {
-    case ALVR_HAND::alvrHandBone_WristRoot: return XR_HAND_JOINT_WRIST_EXT;
-    case ALVR_HAND::alvrHandBone_Thumb0: return XR_HAND_JOINT_THUMB_METACARPAL_EXT;
-    case ALVR_HAND::alvrHandBone_Thumb1: return XR_HAND_JOINT_THUMB_PROXIMAL_EXT;
-    case ALVR_HAND::alvrHandBone_Thumb2: return XR_HAND_JOINT_THUMB_DISTAL_EXT;
-    case ALVR_HAND::alvrHandBone_Thumb3: return XR_HAND_JOINT_THUMB_TIP_EXT;
-    case ALVR_HAND::alvrHandBone_Index1: return XR_HAND_JOINT_INDEX_PROXIMAL_EXT;
-    case ALVR_HAND::alvrHandBone_Index2: return XR_HAND_JOINT_INDEX_INTERMEDIATE_EXT;
-    case ALVR_HAND::alvrHandBone_Index3: return XR_HAND_JOINT_INDEX_DISTAL_EXT;
-    case ALVR_HAND::alvrHandBone_Middle1: return XR_HAND_JOINT_MIDDLE_PROXIMAL_EXT;
-    case ALVR_HAND::alvrHandBone_Middle2: return XR_HAND_JOINT_MIDDLE_INTERMEDIATE_EXT;
-    case ALVR_HAND::alvrHandBone_Middle3: return XR_HAND_JOINT_MIDDLE_DISTAL_EXT;
-    case ALVR_HAND::alvrHandBone_Ring1: return XR_HAND_JOINT_RING_PROXIMAL_EXT;
-    case ALVR_HAND::alvrHandBone_Ring2: return XR_HAND_JOINT_RING_INTERMEDIATE_EXT;
-    case ALVR_HAND::alvrHandBone_Ring3: return XR_HAND_JOINT_RING_DISTAL_EXT;
-    case ALVR_HAND::alvrHandBone_Pinky0: return XR_HAND_JOINT_LITTLE_METACARPAL_EXT;
-    case ALVR_HAND::alvrHandBone_Pinky1: return XR_HAND_JOINT_LITTLE_PROXIMAL_EXT;
-    case ALVR_HAND::alvrHandBone_Pinky2: return XR_HAND_JOINT_LITTLE_INTERMEDIATE_EXT;
-    case ALVR_HAND::alvrHandBone_Pinky3: return XR_HAND_JOINT_LITTLE_DISTAL_EXT;
-    default: return XR_HAND_JOINT_MAX_ENUM_EXT;
-    }
-}
-
 #ifdef XR_USE_OXR_OCULUS
 constexpr inline auto make_local_dimming_info(const bool enabled) {
     return XrLocalDimmingFrameEndInfoMETA{
@@ -379,7 +323,7 @@ struct OpenXrProgram final : IOpenXrProgram {
     }
 
     virtual ~OpenXrProgram() override {
-        Log::Write(Log::Level::Verbose, "Destroying OpenXrProgram");
+        ALXR_LOG_VERBOSE("Destroying OpenXrProgram");
                 
         if (IsSessionRunning()) {
             CHECK_XRCMD(xrEndSession(m_session));
@@ -387,14 +331,14 @@ struct OpenXrProgram final : IOpenXrProgram {
         }
 
         if (m_ptLayerData.reconPassthroughLayer != XR_NULL_HANDLE) {
-            Log::Write(Log::Level::Verbose, "Destroying PassthroughLayer");
+            ALXR_LOG_VERBOSE("Destroying PassthroughLayer");
             assert(m_pfnDestroyPassthroughLayerFB);
             m_pfnDestroyPassthroughLayerFB(m_ptLayerData.reconPassthroughLayer);
             m_ptLayerData.reconPassthroughLayer = XR_NULL_HANDLE;
         }
 
         if (m_ptLayerData.passthrough != XR_NULL_HANDLE) {
-            Log::Write(Log::Level::Verbose, "Destroying Passthrough");
+            ALXR_LOG_VERBOSE("Destroying Passthrough");
             assert(m_pfnDestroyPassthroughFB);
             m_pfnDestroyPassthroughFB(m_ptLayerData.passthrough);
             m_ptLayerData.passthrough = XR_NULL_HANDLE;
@@ -402,7 +346,7 @@ struct OpenXrProgram final : IOpenXrProgram {
 
         if (m_pfnDestroyHandTrackerEXT != nullptr)
         {
-            Log::Write(Log::Level::Verbose, "Destroying HandTrackers");
+            ALXR_LOG_VERBOSE("Destroying HandTrackers");
             assert(m_pfnCreateHandTrackerEXT != nullptr);
             for (auto& handTracker : m_input.handerTrackers) {
                 if (handTracker.tracker != XR_NULL_HANDLE) {
@@ -415,7 +359,7 @@ struct OpenXrProgram final : IOpenXrProgram {
         m_interactionManager.reset();
 
         if (m_visualizedSpaces.size() > 0) {
-            Log::Write(Log::Level::Verbose, "Destroying Visualized XrSpaces");
+            ALXR_LOG_VERBOSE("Destroying Visualized XrSpaces");
         }
         for (XrSpace visualizedSpace : m_visualizedSpaces) {
             xrDestroySpace(visualizedSpace);
@@ -423,46 +367,46 @@ struct OpenXrProgram final : IOpenXrProgram {
         m_visualizedSpaces.clear();
 
         if (m_viewSpace != XR_NULL_HANDLE) {
-            Log::Write(Log::Level::Verbose, "Destroying View XrSpaces");
+            ALXR_LOG_VERBOSE("Destroying View XrSpaces");
             xrDestroySpace(m_viewSpace);
             m_viewSpace = XR_NULL_HANDLE;
         }
 
         if (m_boundingStageSpace != XR_NULL_HANDLE) {
-            Log::Write(Log::Level::Verbose, "Destroying BoundingStage XrSpaces");
+            ALXR_LOG_VERBOSE("Destroying BoundingStage XrSpaces");
             xrDestroySpace(m_boundingStageSpace);
             m_boundingStageSpace = XR_NULL_HANDLE;
         }
 
         if (m_appSpace != XR_NULL_HANDLE) {
-            Log::Write(Log::Level::Verbose, "Destroying App XrSpaces");
+            ALXR_LOG_VERBOSE("Destroying App XrSpaces");
             xrDestroySpace(m_appSpace);
             m_appSpace = XR_NULL_HANDLE;
         }
 
-        Log::Write(Log::Level::Verbose, "Destroying XrSwapChains");
+        ALXR_LOG_VERBOSE("Destroying XrSwapChains");
         ClearSwapchains();
 
         if (m_session != XR_NULL_HANDLE) {
-            Log::Write(Log::Level::Verbose, "Destroying XrSession");
+            ALXR_LOG_VERBOSE("Destroying XrSession");
             xrDestroySession(m_session);
             m_session = XR_NULL_HANDLE;
         }
 
         if (m_instance != XR_NULL_HANDLE) {
-            Log::Write(Log::Level::Verbose, "Destroying XrInstance");
+            ALXR_LOG_VERBOSE("Destroying XrInstance");
             xrDestroyInstance(m_instance);
             m_instance = XR_NULL_HANDLE;
         }
 
-        Log::Write(Log::Level::Verbose, "Destroying GraphicsPlugin");
+        ALXR_LOG_VERBOSE("Destroying GraphicsPlugin");
         m_graphicsPlugin.reset();
-        Log::Write(Log::Level::Verbose, "Destroying PlatformPlugin");
+        ALXR_LOG_VERBOSE("Destroying PlatformPlugin");
         m_platformPlugin.reset();
 
         m_systemId = XR_NULL_SYSTEM_ID;
 
-        Log::Write(Log::Level::Verbose, "OpenXrProgram Destroyed.");
+        ALXR_LOG_VERBOSE("OpenXrProgram Destroyed.");
     }
 
     using ExtensionMap = std::unordered_map<std::string_view, bool>;
@@ -556,12 +500,12 @@ struct OpenXrProgram final : IOpenXrProgram {
                 itr->second = true;
             };
             const std::string indentStr(indent, ' ');
-            Log::Write(Log::Level::Verbose, Fmt("%sAvailable Extensions: (%d)", indentStr.c_str(), instanceExtensionCount));
+            ALXR_LOG_VERBOSE(Fmt("%sAvailable Extensions: (%d)", indentStr.c_str(), instanceExtensionCount));
             for (const XrExtensionProperties& extension : extensions) {
 
                 SetExtensionMap(m_availableSupportedExtMap,  extension.extensionName);
                 SetExtensionMap(m_supportedGraphicsContexts, extension.extensionName);
-                Log::Write(Log::Level::Verbose, Fmt("%s  Name=%s SpecVersion=%d", indentStr.c_str(), extension.extensionName,
+                ALXR_LOG_VERBOSE(Fmt("%s  Name=%s SpecVersion=%d", indentStr.c_str(), extension.extensionName,
                     extension.extensionVersion));
             }
         };
@@ -581,7 +525,7 @@ struct OpenXrProgram final : IOpenXrProgram {
 
             Log::Write(Log::Level::Info, Fmt("Available Layers: (%d)", layerCount));
             for (const XrApiLayerProperties& layer : layers) {
-                Log::Write(Log::Level::Verbose,
+                ALXR_LOG_VERBOSE(
                     Fmt("  Name=%s SpecVersion=%s LayerVersion=%d Description=%s", layer.layerName,
                         GetXrVersionString(layer.specVersion).c_str(), layer.layerVersion, layer.description));
                 logExtensions(layer.layerName, 4);
@@ -678,13 +622,13 @@ struct OpenXrProgram final : IOpenXrProgram {
 
         Log::Write(Log::Level::Info, Fmt("Available View Configuration Types: (%d)", viewConfigTypeCount));
         for (XrViewConfigurationType viewConfigType : viewConfigTypes) {
-            Log::Write(Log::Level::Verbose, Fmt("  View Configuration Type: %s %s", to_string(viewConfigType),
+            ALXR_LOG_VERBOSE(Fmt("  View Configuration Type: %s %s", to_string(viewConfigType),
                 viewConfigType == m_viewConfigType ? "(Selected)" : ""));
 
             XrViewConfigurationProperties viewConfigProperties{ .type=XR_TYPE_VIEW_CONFIGURATION_PROPERTIES, .next=nullptr };
             CHECK_XRCMD(xrGetViewConfigurationProperties(m_instance, m_systemId, viewConfigType, &viewConfigProperties));
 
-            Log::Write(Log::Level::Verbose,
+            ALXR_LOG_VERBOSE(
                 Fmt("  View configuration FovMutable=%s", viewConfigProperties.fovMutable == XR_TRUE ? "True" : "False"));
 
             uint32_t viewCount = 0;
@@ -697,10 +641,10 @@ struct OpenXrProgram final : IOpenXrProgram {
                 for (uint32_t i = 0; i < views.size(); ++i) {
                     const XrViewConfigurationView& view = views[i];
 
-                    Log::Write(Log::Level::Verbose, Fmt("    View [%d]: Recommended Width=%d Height=%d SampleCount=%d", i,
+                    ALXR_LOG_VERBOSE(Fmt("    View [%d]: Recommended Width=%d Height=%d SampleCount=%d", i,
                         view.recommendedImageRectWidth, view.recommendedImageRectHeight,
                         view.recommendedSwapchainSampleCount));
-                    Log::Write(Log::Level::Verbose,
+                    ALXR_LOG_VERBOSE(
                         Fmt("    View [%d]:     Maximum Width=%d Height=%d SampleCount=%d", i, view.maxImageRectWidth,
                             view.maxImageRectHeight, view.maxSwapchainSampleCount));
                 }
@@ -757,7 +701,7 @@ struct OpenXrProgram final : IOpenXrProgram {
         };        
         CHECK_XRCMD(xrGetSystem(m_instance, &systemInfo, &m_systemId));
 
-        Log::Write(Log::Level::Verbose, Fmt("Using system %d for form factor %s", m_systemId, to_string(m_formFactor)));
+        ALXR_LOG_VERBOSE(Fmt("Using system %d for form factor %s", m_systemId, to_string(m_formFactor)));
         CHECK(m_instance != XR_NULL_HANDLE);
         CHECK(m_systemId != XR_NULL_SYSTEM_ID);
 
@@ -885,13 +829,18 @@ struct OpenXrProgram final : IOpenXrProgram {
 #endif
     }
 
+    virtual inline std::tuple<XrTime, XrDuration> GetPredictedDisplayTiming() const override
+    {
+        return { m_lastPredicatedDisplayTime.load(), m_PredicatedLatencyOffset.load() };
+    }
+
     void LogReferenceSpaces() {
         CHECK(m_session != XR_NULL_HANDLE);
 
         const auto spaces = GetAvailableReferenceSpaces();
         Log::Write(Log::Level::Info, Fmt("Available reference spaces: %d", spaces.size()));
         for (const XrReferenceSpaceType space : spaces) {
-            Log::Write(Log::Level::Verbose, Fmt("  Name: %s", to_string(space)));
+            ALXR_LOG_VERBOSE(Fmt("  Name: %s", to_string(space)));
         }
     }
 
@@ -1167,13 +1116,14 @@ struct OpenXrProgram final : IOpenXrProgram {
         createHandTracker(m_input.handerTrackers[0], XR_HAND_LEFT_EXT);
         createHandTracker(m_input.handerTrackers[1], XR_HAND_RIGHT_EXT);
 
-        auto& leftHandBaseOrientation = m_input.handerTrackers[0].baseOrientation;
-        auto& rightHandBaseOrientation = m_input.handerTrackers[1].baseOrientation;   
+        XrMatrix4x4f leftHandBaseOrientation, rightHandBaseOrientation;
         XrMatrix4x4f zRot;
         XrMatrix4x4f& yRot = rightHandBaseOrientation;
         XrMatrix4x4f_CreateRotation(&yRot, 0.0, -90.0f, 0.0f);
         XrMatrix4x4f_CreateRotation(&zRot, 0.0, 0.0f, 180.0f);
         XrMatrix4x4f_Multiply(&leftHandBaseOrientation, &yRot, &zRot);
+        XrMatrix4x4f_GetRotation(&m_input.handerTrackers[0].baseOrientation, &leftHandBaseOrientation);
+        XrMatrix4x4f_GetRotation(&m_input.handerTrackers[1].baseOrientation, &rightHandBaseOrientation);
         return true;
     }
 
@@ -1381,7 +1331,7 @@ struct OpenXrProgram final : IOpenXrProgram {
         CHECK(m_systemId != XR_NULL_SYSTEM_ID);
         CHECK(m_session == XR_NULL_HANDLE);
         {
-            Log::Write(Log::Level::Verbose, Fmt("Creating session..."));
+            ALXR_LOG_VERBOSE(Fmt("Creating session..."));
 
             const XrSessionCreateInfo createInfo{
                 .type = XR_TYPE_SESSION_CREATE_INFO,
@@ -1401,7 +1351,7 @@ struct OpenXrProgram final : IOpenXrProgram {
         {
             XrReferenceSpaceCreateInfo referenceSpaceCreateInfo = GetAppReferenceSpaceCreateInfo();
             CHECK_XRCMD(xrCreateReferenceSpace(m_session, &referenceSpaceCreateInfo, &m_appSpace));
-            Log::Write(Log::Level::Verbose, Fmt("Selected app reference space: %s", to_string(referenceSpaceCreateInfo.referenceSpaceType)));
+            ALXR_LOG_VERBOSE(Fmt("Selected app reference space: %s", to_string(referenceSpaceCreateInfo.referenceSpaceType)));
             m_streamConfig.trackingSpaceType = ToTrackingSpace(referenceSpaceCreateInfo.referenceSpaceType);
 
             referenceSpaceCreateInfo = GetXrReferenceSpaceCreateInfo("Stage");
@@ -1521,7 +1471,7 @@ struct OpenXrProgram final : IOpenXrProgram {
                     swapchainFormatsString += "]";
                 }
             }
-            Log::Write(Log::Level::Verbose, Fmt("Swapchain Formats: %s", swapchainFormatsString.c_str()));
+            ALXR_LOG_VERBOSE(Fmt("Swapchain Formats: %s", swapchainFormatsString.c_str()));
         }
 
         if (m_isMultiViewEnabled)
@@ -1682,13 +1632,13 @@ struct OpenXrProgram final : IOpenXrProgram {
                 } break;
                 case XR_TYPE_EVENT_DATA_REFERENCE_SPACE_CHANGE_PENDING: {
                     const auto& spaceChangedEvent = *reinterpret_cast<const XrEventDataReferenceSpaceChangePending*>(event);
-                    Log::Write(Log::Level::Verbose, Fmt("reference space: %d changing", spaceChangedEvent.referenceSpaceType));
+                    ALXR_LOG_VERBOSE(Fmt("reference space: %d changing", spaceChangedEvent.referenceSpaceType));
                     const auto appRefSpace = ToXrReferenceSpaceType(m_streamConfig.trackingSpaceType);
                     if (spaceChangedEvent.referenceSpaceType == appRefSpace)
                         enqueueGuardianChanged(spaceChangedEvent.changeTime);
                 }  break;
                 default: {
-                    Log::Write(Log::Level::Verbose, Fmt("Ignoring event type %d", event->type));
+                    ALXR_LOG_VERBOSE(Fmt("Ignoring event type %d", event->type));
                     break;
                 }
             }
@@ -1775,7 +1725,7 @@ struct OpenXrProgram final : IOpenXrProgram {
         const bool isHandOnControllerPose = IsRuntime(OxrRuntimeType::HTCWave) ||
                                             IsRuntime(OxrRuntimeType::SteamVR) ||
                                             IsRuntime(OxrRuntimeType::WMR);
-        std::array<XrMatrix4x4f, XR_HAND_JOINT_COUNT_EXT> oculusOrientedJointPoses;
+        ALXR::HandJoints oculusOrientedJoints;
         for (const auto hand : { Side::LEFT,Side::RIGHT })
         {
             auto& controller = controllerInfo[hand];//m_input.controllerInfo[hand];
@@ -1809,60 +1759,10 @@ struct OpenXrProgram final : IOpenXrProgram {
             if (locations.isActive == XR_FALSE)
                 continue;
 
-            const auto& jointLocations = handerTracker.jointLocations;
-            const auto& handBaseOrientation = handerTracker.baseOrientation;
-            for (size_t jointIdx = 0; jointIdx < XR_HAND_JOINT_COUNT_EXT; ++jointIdx)
-            {
-                const auto& jointLoc = jointLocations[jointIdx];
-                XrMatrix4x4f& jointMatFixed = oculusOrientedJointPoses[jointIdx];
-                if (!Math::Pose::IsPoseValid(jointLoc))
-                {
-                    XrMatrix4x4f_CreateIdentity(&jointMatFixed);
-                    continue;
-                }
-                const auto jointMat = Math::XrMatrix4x4f_CreateFromPose(jointLoc.pose);
-                XrMatrix4x4f_CreateIdentity(&jointMatFixed);
-                XrMatrix4x4f_Multiply(&jointMatFixed, &jointMat, &handBaseOrientation);
-            }
-            
-            for (size_t boneIndex = 0; boneIndex < ALVR_HAND::alvrHandBone_MaxSkinnable; ++boneIndex)
-            {
-                auto& boneRot = controller.boneRotations[boneIndex];
-                auto& bonePos = controller.bonePositionsBase[boneIndex];
-                boneRot = { 0,0,0,1 };
-                bonePos = { 0,0,0 };
-                
-                const auto xrJoint = ToXRHandJointType(static_cast<ALVR_HAND>(boneIndex));
-                if (xrJoint == XR_HAND_JOINT_MAX_ENUM_EXT)
-                    continue;
-
-                const auto xrJointParent = GetJointParent(xrJoint);
-                const XrMatrix4x4f& jointParentWorld = oculusOrientedJointPoses[xrJointParent];
-                const XrMatrix4x4f& JointWorld       = oculusOrientedJointPoses[xrJoint];
-
-                XrMatrix4x4f jointLocal, jointParentInv;
-                XrMatrix4x4f_InvertRigidBody(&jointParentInv, &jointParentWorld);
-                XrMatrix4x4f_Multiply(&jointLocal, &jointParentInv, &JointWorld);
-
-                XrQuaternionf localizedRot;
-                XrMatrix4x4f_GetRotation(&localizedRot, &jointLocal);
-                XrVector3f localizedPos;
-                XrMatrix4x4f_GetTranslation(&localizedPos, &jointLocal);
-
-                boneRot = ToTrackingQuat(localizedRot);
-                bonePos = ToTrackingVector3(localizedPos);
-            }
-
+            ALXR::LoadHandJoints(handerTracker.jointLocations, handerTracker.baseOrientation, oculusOrientedJoints);
+            ALXR::ToHandSkeleton(oculusOrientedJoints, controller);
             controller.enabled = true;
             controller.isHand = true;
-
-            const XrMatrix4x4f& palmMatP = oculusOrientedJointPoses[XR_HAND_JOINT_PALM_EXT];
-            XrQuaternionf palmRot;
-            XrVector3f palmPos;
-            XrMatrix4x4f_GetTranslation(&palmPos, &palmMatP);
-            XrMatrix4x4f_GetRotation(&palmRot, &palmMatP);
-            controller.boneRootPosition = ToTrackingVector3(palmPos);
-            controller.boneRootOrientation = ToTrackingQuat(palmRot);
         }
     }
 
@@ -1906,6 +1806,8 @@ struct OpenXrProgram final : IOpenXrProgram {
             .next = nullptr
         };
         CHECK_XRCMD(xrWaitFrame(m_session, &frameWaitInfo, &frameState));
+        auto& frameTracer = ALXR::FrameTracer::Instance();
+        const std::uint64_t waitFrameTimeUs = frameTracer.IsEnabled() ? GetSteadyTimestampUs() : 0;
         m_PredicatedLatencyOffset.store(frameState.predictedDisplayPeriod);
         m_lastPredicatedDisplayTime.store(frameState.predictedDisplayTime);
 
@@ -1928,6 +1830,9 @@ struct OpenXrProgram final : IOpenXrProgram {
             .next = nullptr
         };
         CHECK_XRCMD(xrBeginFrame(m_session, &frameBeginInfo));
+        // the video frame shown is only known after xrWaitFrame returns.
+        frameTracer.Record(ALXR::FrameTraceEvent::WaitFrame, videoFrameDisplayTime, waitFrameTimeUs);
+        frameTracer.Record(ALXR::FrameTraceEvent::BeginFrame, videoFrameDisplayTime);
 
         XrCompositionLayerPassthroughFB passthroughLayer;
         XrCompositionLayerProjection    layer;
@@ -1986,6 +1891,7 @@ struct OpenXrProgram final : IOpenXrProgram {
             .layers = layers.data()
         };
         CHECK_XRCMD(xrEndFrame(m_session, &frameEndInfo));
+        frameTracer.Record(ALXR::FrameTraceEvent::EndFrame, videoFrameDisplayTime);
 
         LatencyManager::Instance().SubmitAndSync(videoFrameDisplayTime, !timeRender);
         if (isVideoStream)
@@ -2053,7 +1959,7 @@ struct OpenXrProgram final : IOpenXrProgram {
                 }
             }
             else {
-                Log::Write(Log::Level::Verbose, Fmt("Unable to locate a visualized reference space in app space: %d", res));
+                ALXR_LOG_VERBOSE(Fmt("Unable to locate a visualized reference space in app space: %d", res));
             }
         }
 #else
@@ -2072,7 +1978,7 @@ struct OpenXrProgram final : IOpenXrProgram {
                 // Tracking loss is expected when the hand is not active so only log a message
                 // if the hand is active.                    
                 constexpr static const char* const handName[] = { "left", "right" };
-                Log::Write(Log::Level::Verbose,
+                ALXR_LOG_VERBOSE(
                     Fmt("Unable to locate %s hand action space in app space", handName[hand]));
             }
         }
@@ -2161,10 +2067,12 @@ struct OpenXrProgram final : IOpenXrProgram {
         }
 
         const XrSwapchainImageBaseHeader* const swapchainImage = m_swapchainImages[viewSwapchain.handle][swapchainImageIndex];
+        m_graphicsPlugin->BeginRenderViews();
         if (isVideoStream)
             m_graphicsPlugin->RenderVideoMultiView(projectionLayerViews, swapchainImage, m_colorSwapchainFormat, ptMode);
         else
             m_graphicsPlugin->RenderMultiView(projectionLayerViews, swapchainImage, m_colorSwapchainFormat, ptMode, vizCubes);
+        m_graphicsPlugin->EndRenderViews();
 
         constexpr const XrSwapchainImageReleaseInfo releaseInfo{
             .type = XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO,
@@ -2197,6 +2105,8 @@ struct OpenXrProgram final : IOpenXrProgram {
         const bool isVideoStream = m_renderMode == RenderMode::VideoStream;
         const auto vizCubes = isVideoStream ? VizCubeList{} : GetVisualizedCubes(predictedDisplayTime);
         const auto ptMode = static_cast<const ::PassthroughMode>(mode);
+        // Both views are recorded into one batch, swapchain images are only released once it has been submitted.
+        m_graphicsPlugin->BeginRenderViews();
         // Render view to the appropriate part of the swapchain image.
         for (std::uint32_t i = 0; i < views.size(); ++i) {
             // Each view has a separate swapchain which is acquired, rendered to, and released.
@@ -2223,12 +2133,15 @@ struct OpenXrProgram final : IOpenXrProgram {
                 m_graphicsPlugin->RenderVideoView(i, projectionLayerViews[i], swapchainImage, m_colorSwapchainFormat, ptMode);
             else
                 m_graphicsPlugin->RenderView(projectionLayerViews[i], swapchainImage, m_colorSwapchainFormat, ptMode, vizCubes);
-            
+        }
+        m_graphicsPlugin->EndRenderViews();
+
+        for (std::uint32_t i = 0; i < views.size(); ++i) {
             constexpr const XrSwapchainImageReleaseInfo releaseInfo{
                 .type = XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO,
                 .next = nullptr
             };
-            CHECK_XRCMD(xrReleaseSwapchainImage(viewSwapchain.handle, &releaseInfo));
+            CHECK_XRCMD(xrReleaseSwapchainImage(m_swapchains[i].handle, &releaseInfo));
         }
 
         layer = XrCompositionLayerProjection {
@@ -2413,20 +2326,14 @@ struct OpenXrProgram final : IOpenXrProgram {
         if (renderMode == RenderMode::Lobby)
             return GetDefaultViews();
 
-        std::shared_lock<std::shared_mutex> l(m_trackingFrameMapMutex);
-        if (videoTimeStampNs != std::uint64_t(-1))
-        {
-            const auto trackingFrameItr = m_trackingFrameMap.find(videoTimeStampNs);
-            if (trackingFrameItr != m_trackingFrameMap.cend()) {
-                predicateDisplayTime = trackingFrameItr->second.displayTime;
-                return trackingFrameItr->second.views;
-            }
-        }
-        const auto result = m_trackingFrameMap.rbegin();
-        if (result == m_trackingFrameMap.rend())
+        TrackingFrame trackingFrame;
+        const bool found = videoTimeStampNs != std::uint64_t(-1) ?
+            m_trackingFrames.FindNearest(videoTimeStampNs, trackingFrame) :
+            m_trackingFrames.Latest(trackingFrame);
+        if (!found)
             return GetDefaultViews();
-        predicateDisplayTime = result->second.displayTime;
-        return result->second.views;
+        predicateDisplayTime = trackingFrame.displayTime;
+        return trackingFrame.views;
     }
 
     static inline ALXREyeInfo GetEyeInfo(const XrView& left_view, const XrView& right_view)
@@ -2472,6 +2379,29 @@ struct OpenXrProgram final : IOpenXrProgram {
         return GetEyeInfo(eyeInfo, m_lastPredicatedDisplayTime);
     }
 
+    static constexpr inline ALXR::PoseTraceDevice ToPoseTraceDevice(const std::size_t hand)
+    {
+        return hand == Side::LEFT ? ALXR::PoseTraceDevice::LeftHand : ALXR::PoseTraceDevice::RightHand;
+    }
+
+    // Poses as located at the current time, the closest to a ground truth to evaluate predictions against.
+    void WritePoseTrace(const XrTime& xrTimeStamp, [[maybe_unused]] const XrTime& lastPredicatedDisplayTime) const
+    {
+        auto& poseTrace = ALXR::PoseTraceWriter::Instance();
+        if (!poseTrace.IsOpen())
+            return;
+        poseTrace.Write(ALXR::PoseTraceDevice::Head, xrTimeStamp, GetSpaceLocation(m_viewSpace, xrTimeStamp));
+#ifdef XR_USE_OXR_PICO
+        // controller spaces can only be located at the frame's predicted display time, see GetTrackingInfo.
+        const XrTime handTraceTime = lastPredicatedDisplayTime;
+#else
+        const XrTime handTraceTime = xrTimeStamp;
+#endif
+        for (const auto hand : { Side::LEFT, Side::RIGHT }) {
+            poseTrace.Write(ToPoseTraceDevice(hand), handTraceTime, GetHandSpaceLocation(hand, handTraceTime));
+        }
+    }
+
     virtual bool GetTrackingInfo(TrackingInfo& info, const bool clientPredict) /*const*/ override
     {
         const XrDuration predicatedLatencyOffsetNs = m_PredicatedLatencyOffset.load();
@@ -2489,29 +2419,40 @@ struct OpenXrProgram final : IOpenXrProgram {
         const auto predicatedDisplayTimeXR = xrTimeStamp + totalLatencyOffsetNs;
         const auto predicatedDisplayTimeNs = (timeStampUs * 1000) + static_cast<std::uint64_t>(totalLatencyOffsetNs);
         
+        const auto lastPredicatedDisplayTime = m_lastPredicatedDisplayTime.load();
+        const auto& inputPredicatedTime = clientPredict ? predicatedDisplayTimeXR : lastPredicatedDisplayTime;
+
+        //
+        // Runtimes only track/predict poses up to the frame they are about to display, beyond that
+        // (the network latency) their extrapolation is unspecified (& on some, no better than holding the
+        // pose). With client prediction, poses are located at the latest display time & extrapolated
+        // with the configured model instead.
+        //
+        const auto& clientPosePrediction = m_options->ClientPosePrediction;
+        const bool isClientPredicting = clientPosePrediction.has_value() && lastPredicatedDisplayTime > 0;
+        const XrTime headSampleTime = isClientPredicting ? lastPredicatedDisplayTime : predicatedDisplayTimeXR;
+
         std::array<XrView, 2> newViews { IdentityView, IdentityView };
-        LocateViews(predicatedDisplayTimeXR, (const std::uint32_t)newViews.size(), newViews.data());
-         {
-             std::unique_lock<std::shared_mutex> lock(m_trackingFrameMapMutex);
-             m_trackingFrameMap[predicatedDisplayTimeNs] = {
-                 .views       = newViews,
-                 //.timestamp   = predicatedDisplayTimeNs,
-                 .displayTime = predicatedDisplayTimeXR
-             };
-             if (m_trackingFrameMap.size() > MaxTrackingFrameCount)
-                 m_trackingFrameMap.erase(m_trackingFrameMap.begin());
-         }
+        LocateViews(headSampleTime, (const std::uint32_t)newViews.size(), newViews.data());
+        auto hmdSpaceLoc = GetSpaceLocation(m_viewSpace, headSampleTime);
+        if (isClientPredicting) {
+            auto& headHistory = m_poseHistories[static_cast<std::size_t>(ALXR::PoseTraceDevice::Head)];
+            headHistory.Push(headSampleTime, hmdSpaceLoc);
+            const auto predictedLoc = headHistory.Predict(predicatedDisplayTimeXR, *clientPosePrediction);
+            ALXR::ApplyHeadPoseDelta(hmdSpaceLoc.pose, predictedLoc.pose, newViews);
+            hmdSpaceLoc = predictedLoc;
+        }
+        m_trackingFrames.Push(predicatedDisplayTimeNs, {
+            .views       = newViews,
+            .displayTime = predicatedDisplayTimeXR
+        });
         info.targetTimestampNs = predicatedDisplayTimeNs;
-        
-        const auto hmdSpaceLoc = GetSpaceLocation(m_viewSpace, predicatedDisplayTimeXR);
+
         info.HeadPose_Pose_Orientation  = ToTrackingQuat(hmdSpaceLoc.pose.orientation);
         info.HeadPose_Pose_Position     = ToTrackingVector3(hmdSpaceLoc.pose.position);
         // info.HeadPose_LinearVelocity    = ToTrackingVector3(hmdSpaceLoc.linearVelocity);
         // info.HeadPose_AngularVelocity   = ToTrackingVector3(hmdSpaceLoc.angularVelocity);
 
-        const auto lastPredicatedDisplayTime = m_lastPredicatedDisplayTime.load();
-        const auto& inputPredicatedTime = clientPredict ? predicatedDisplayTimeXR : lastPredicatedDisplayTime;
-
         for (const auto hand : { Side::LEFT, Side::RIGHT }) {
             auto& newContInfo = info.controller[hand];
 #ifdef XR_USE_OXR_PICO
@@ -2521,12 +2462,18 @@ struct OpenXrProgram final : IOpenXrProgram {
             //      * xrConvertTimeToTimespecTimeKHR appears to return values in microseconds instead of nanoseconds and values seem to be completely of from what
             //        XrFrameState::predicateDisplayTime values are.   
             //
-            //  This workaround will induce some small amount of "lag" as the times don't account for network latency and the HMD poses being in future times.
+            //  This workaround will induce some small amount of "lag" as the times don't account for network latency and the HMD poses being in future times,
+            //  unless client pose prediction is enabled.
             //
-            const auto spaceLoc = GetHandSpaceLocation(hand, lastPredicatedDisplayTime);
+            auto spaceLoc = GetHandSpaceLocation(hand, lastPredicatedDisplayTime);
 #else
-            const auto spaceLoc = GetHandSpaceLocation(hand, inputPredicatedTime);
+            auto spaceLoc = GetHandSpaceLocation(hand, isClientPredicting ? lastPredicatedDisplayTime : inputPredicatedTime);
 #endif
+            if (isClientPredicting) {
+                auto& handHistory = m_poseHistories[static_cast<std::size_t>(ToPoseTraceDevice(hand))];
+                handHistory.Push(lastPredicatedDisplayTime, spaceLoc);
+                spaceLoc = handHistory.Predict(inputPredicatedTime, *clientPosePrediction);
+            }
             newContInfo.position        = ToTrackingVector3(spaceLoc.pose.position);
             newContInfo.orientation     = ToTrackingQuat(spaceLoc.pose.orientation);
             newContInfo.linearVelocity  = ToTrackingVector3(spaceLoc.linearVelocity);
@@ -2534,6 +2481,7 @@ struct OpenXrProgram final : IOpenXrProgram {
         }
 
         PollHandTrackers(inputPredicatedTime, info.controller);
+        WritePoseTrace(xrTimeStamp, lastPredicatedDisplayTime);
 
         LatencyCollector::Instance().tracking(predicatedDisplayTimeNs);
         return true;
@@ -2547,7 +2495,8 @@ struct OpenXrProgram final : IOpenXrProgram {
 
     virtual inline void SetStreamConfig(const ALXRStreamConfig& config) override
     {
-        m_streamConfigQueue.push(config);
+        if (!m_streamConfigQueue.push(config))
+            Log::Write(Log::Level::Warning, "Stream config queue is full, the new stream config is dropped.");
     }
 
     virtual inline bool GetStreamConfig(ALXRStreamConfig& config) const override
@@ -2654,14 +2603,17 @@ struct OpenXrProgram final : IOpenXrProgram {
 
     inline bool enqueueGuardianChanged(const XrTime& time)
     {
-        Log::Write(Log::Level::Verbose, "Enqueuing guardian changed");
+        ALXR_LOG_VERBOSE("Enqueuing guardian changed");
         ALXRGuardianData gd {
             .shouldSync = false
         };
         if (!GetBoundingStageSpace(time, gd))
             return false;
-        Log::Write(Log::Level::Verbose, "Guardian changed enqueud successfully.");
-        m_guardianChangedQueue.push(gd);
+        if (!m_guardianChangedQueue.push(gd)) {
+            Log::Write(Log::Level::Warning, "Guardian changed queue is full, the guardian change is dropped.");
+            return false;
+        }
+        ALXR_LOG_VERBOSE("Guardian changed enqueud successfully.");
         return true;
     }
 
@@ -2766,7 +2718,7 @@ struct OpenXrProgram final : IOpenXrProgram {
         {
             std::array<XrHandJointLocationEXT, XR_HAND_JOINT_COUNT_EXT> jointLocations;
             //std::array<XrHandJointVelocityEXT, XR_HAND_JOINT_COUNT_EXT> jointVelocities;
-            XrMatrix4x4f baseOrientation;
+            XrQuaternionf baseOrientation;
             XrHandTrackerEXT tracker{ XR_NULL_HANDLE };
         };
         std::array<HandTrackerData, Side::COUNT> handerTrackers;
@@ -2838,12 +2790,14 @@ struct OpenXrProgram final : IOpenXrProgram {
         std::array<XrView, 2> views;
         XrTime                displayTime;
     };
-    using TrackingFrameMap = std::map<std::uint64_t, TrackingFrame>;
-    mutable std::shared_mutex m_trackingFrameMapMutex;        
-    TrackingFrameMap          m_trackingFrameMap{};
+    static constexpr const std::size_t MaxTrackingFrameCount = 1024;
+    // Written by the tracking thread only, read lock-free by the render thread.
+    using TrackingFrameRing = ALXR::TrackingFrameRing<TrackingFrame, MaxTrackingFrameCount>;
+    TrackingFrameRing         m_trackingFrames{};
+    // only used by the tracking thread (GetTrackingInfo), indexed by ALXR::PoseTraceDevice.
+    std::array<ALXR::PoseHistory, std::size_t(ALXR::PoseTraceDevice::TypeCount)> m_poseHistories{};
     std::atomic<XrDuration>   m_PredicatedLatencyOffset{ 0 };
     std::uint64_t             m_lastVideoFrameIndex = std::uint64_t(-1);
-    static constexpr const std::size_t MaxTrackingFrameCount = 360 * 3;
 /// End Tracking Thread State ////////////////////////////////////////////////////
 
     std::vector<float> m_displayRefreshRates;
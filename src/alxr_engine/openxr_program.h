@@ -120,6 +120,9 @@ struct IOpenXrProgram {
 
     virtual std::tuple<XrTime, std::uint64_t> XrTimeNow() const = 0;
 
+    // The latest xrWaitFrame predicted display time & period, zeros before the first frame.
+    virtual std::tuple<XrTime, XrDuration> GetPredictedDisplayTiming() const = 0;
+
     virtual void Pause() = 0;
     virtual void Resume() = 0;
 
@@ -5,6 +5,8 @@
 #pragma once
 
 #include "pch.h"
+#include <optional>
+#include "pose_prediction.h"
 
 inline XrFormFactor GetXrFormFactor(const std::string& formFactorStr) {
     if (EqualsIgnoreCase(formFactorStr, "Hmd")) {
@@ -69,6 +71,8 @@ struct Options {
     bool NoServerFramerateLock = false;
     bool NoFrameSkip = false;
     bool DisableLocalDimming = false;
+    // empty for the runtime's own prediction.
+    std::optional<ALXR::PosePredictionModel> ClientPosePrediction{};
 
     struct {
         XrFormFactor FormFactor{XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY};
@@ -0,0 +1,137 @@
+#include "pch.h"
+#include "common.h"
+#include "packet_capture.h"
+#include "timing.h"
+
+#include <thread>
+#include <vector>
+
+namespace ALXR {
+namespace {
+
+struct PacketCaptureHeader {
+    std::uint32_t    magic;
+    std::uint32_t    version;
+    std::uint32_t    streamConfigSize;
+    std::uint32_t    reserved;
+    ALXRStreamConfig streamConfig;
+};
+constexpr const std::uint32_t PacketCaptureMagic = 0x4B505841; // "AXPK"
+constexpr const std::uint32_t PacketCaptureVersion = 3;
+
+struct PacketRecordHeader {
+    std::uint64_t timestampUs;
+    std::uint32_t size;
+    std::uint32_t reserved;
+};
+static_assert(sizeof(PacketRecordHeader) == 16);
+
+// Anything larger is a corrupt capture, video packets are bounded by the transport's MTU.
+constexpr const std::uint32_t MaxPacketSize = 1 << 20;
+
+}
+
+bool PacketCaptureWriter::Open(const std::filesystem::path& filePath, const ALXRStreamConfig& streamConfig) {
+    Close();
+    std::scoped_lock lock(m_fileMutex);
+    m_file.open(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    const PacketCaptureHeader header {
+        .magic = PacketCaptureMagic,
+        .version = PacketCaptureVersion,
+        .streamConfigSize = sizeof(ALXRStreamConfig),
+        .reserved = 0,
+        .streamConfig = streamConfig
+    };
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!m_file) {
+        Log::Write(Log::Level::Warning, Fmt("Failed to create packet capture \"%s\"", filePath.string().c_str()));
+        m_file.close();
+        return false;
+    }
+    m_firstPacketTimeUs = 0;
+    m_packetCount = 0;
+    m_isOpen.store(true, std::memory_order_release);
+    Log::Write(Log::Level::Info, Fmt("Packet capture started: \"%s\"", filePath.string().c_str()));
+    return true;
+}
+
+void PacketCaptureWriter::Close() {
+    std::scoped_lock lock(m_fileMutex);
+    if (!m_isOpen.exchange(false, std::memory_order_acq_rel))
+        return;
+    m_file.close();
+    Log::Write(Log::Level::Info, Fmt("Packet capture stopped, %zu packets written.", m_packetCount));
+}
+
+void PacketCaptureWriter::WritePacket(const std::uint8_t* packet, const std::size_t packetSize) {
+    if (packet == nullptr || packetSize == 0 || packetSize > MaxPacketSize)
+        return;
+    const std::uint64_t nowUs = GetSteadyTimestampUs();
+    std::scoped_lock lock(m_fileMutex);
+    if (!m_isOpen.load(std::memory_order_relaxed))
+        return;
+    if (m_packetCount == 0)
+        m_firstPacketTimeUs = nowUs;
+    const PacketRecordHeader record {
+        .timestampUs = nowUs - m_firstPacketTimeUs,
+        .size = static_cast<std::uint32_t>(packetSize),
+        .reserved = 0
+    };
+    m_file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    m_file.write(reinterpret_cast<const char*>(packet), packetSize);
+    if (!m_file) {
+        Log::Write(Log::Level::Warning, "Packet capture write failed, capture stopped.");
+        m_isOpen.store(false, std::memory_order_release);
+        m_file.close();
+        return;
+    }
+    ++m_packetCount;
+}
+
+bool ReplayPacketCapture
+(
+    const std::filesystem::path& filePath,
+    const bool realtime,
+    const std::atomic<bool>& isRunning,
+    const std::function<void(const ALXRStreamConfig&)>& onStreamConfig,
+    const std::function<void(const std::uint8_t*, const std::size_t)>& onPacket,
+    /*[out]*/ PacketReplayStats& stats
+) {
+    stats = {};
+    std::ifstream inFile(filePath, std::ios::in | std::ios::binary);
+    PacketCaptureHeader header{};
+    if (!inFile.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        header.magic != PacketCaptureMagic ||
+        header.version != PacketCaptureVersion ||
+        header.streamConfigSize != sizeof(ALXRStreamConfig)) {
+        Log::Write(Log::Level::Warning, Fmt("\"%s\" is not a compatible packet capture.", filePath.string().c_str()));
+        return false;
+    }
+    onStreamConfig(header.streamConfig);
+
+    using namespace std::chrono;
+    const auto replayStart = steady_clock::now();
+    std::vector<std::uint8_t> packet;
+    PacketRecordHeader record{};
+    while (isRunning.load(std::memory_order_relaxed) &&
+           inFile.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        if (record.size == 0 || record.size > MaxPacketSize) {
+            Log::Write(Log::Level::Warning, Fmt("Corrupt packet record after %zu packets, replay stopped.", stats.packetCount));
+            return false;
+        }
+        packet.resize(record.size);
+        if (!inFile.read(reinterpret_cast<char*>(packet.data()), record.size)) {
+            Log::Write(Log::Level::Warning, "Truncated packet capture, replay stopped.");
+            return false;
+        }
+        if (realtime)
+            std::this_thread::sleep_until(replayStart + microseconds(record.timestampUs));
+        onPacket(packet.data(), packet.size());
+        ++stats.packetCount;
+        stats.byteCount += record.size;
+    }
+    stats.durationUs = duration_cast<microseconds>(steady_clock::now() - replayStart).count();
+    return true;
+}
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+#ifndef ALXR_PACKET_CAPTURE_H
+#define ALXR_PACKET_CAPTURE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <fstream>
+#include <functional>
+#include <filesystem>
+
+#include "alxr_ctypes.h"
+
+namespace ALXR {
+
+// Records the video stream as received by alxr_on_receive, along with the stream config it was
+// decoded with, so field captures can be replayed through the decoder & upload path without a server.
+//
+// File layout: PacketCaptureHeader, then per packet { u64 receive time (us since first packet), u32 size, bytes }.
+class PacketCaptureWriter {
+public:
+    bool Open(const std::filesystem::path& filePath, const ALXRStreamConfig& streamConfig);
+    void Close();
+
+    inline bool IsOpen() const { return m_isOpen.load(std::memory_order_acquire); }
+
+    inline void Write(const std::uint8_t* packet, const std::size_t packetSize) {
+        if (IsOpen())
+            WritePacket(packet, packetSize);
+    }
+
+private:
+    void WritePacket(const std::uint8_t* packet, const std::size_t packetSize);
+
+    std::mutex        m_fileMutex;
+    std::ofstream     m_file;
+    std::uint64_t     m_firstPacketTimeUs{ 0 };
+    std::size_t       m_packetCount{ 0 };
+    std::atomic<bool> m_isOpen{ false };
+};
+
+struct PacketReplayStats {
+    std::size_t   packetCount;
+    std::uint64_t byteCount;
+    std::uint64_t durationUs;
+};
+
+// Feeds a capture's stream config to onStreamConfig then each packet to onPacket, paced to the
+// recorded receive times when realtime is set, otherwise as fast as onPacket returns.
+// Stops early when isRunning is cleared, returns false if the file is missing or malformed.
+bool ReplayPacketCapture
+(
+    const std::filesystem::path& filePath,
+    const bool realtime,
+    const std::atomic<bool>& isRunning,
+    const std::function<void(const ALXRStreamConfig&)>& onStreamConfig,
+    const std::function<void(const std::uint8_t*, const std::size_t)>& onPacket,
+    /*[out]*/ PacketReplayStats& stats
+);
+
+}
+#endif
@@ -0,0 +1,188 @@
+#pragma once
+#ifndef ALXR_PACKET_QUEUE_H
+#define ALXR_PACKET_QUEUE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <cassert>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <utility>
+
+#include <readerwritercircularbuffer.h>
+#include "timing.h"
+
+namespace ALXR {
+
+// Producer side view of a PacketQueue.
+struct PacketQueueState {
+    std::size_t   depth;           // packets queued & neither dequeued nor flushed yet.
+    std::uint64_t oldestAgeUs;     // time the oldest of them has been waiting, 0 when empty.
+    bool          hasDecodedFrame; // the decoder has output a frame since the queue was created.
+    std::uint64_t lostCount;       // packets the decoder failed to decode, the reference chain broke on each.
+};
+
+// Bounds how far the decoder may run behind the network, in queued packets & time. Not enforced until
+// the decoder has output its first frame, packets pile up while it is created & waits on a key frame.
+struct PacketQueueBudget {
+    std::size_t   maxDepth;
+    std::uint64_t maxLatencyUs;
+
+    constexpr inline bool IsExceeded(const PacketQueueState& state) const {
+        return state.hasDecodedFrame && (state.depth >= maxDepth || state.oldestAgeUs > maxLatencyUs);
+    }
+};
+
+// Encoded packets in-flight between the network thread (single producer) & a decoder plugin's
+// thread (single consumer). The producer never blocks, a full queue rejects the packet.
+//
+// Flushing drops every packet queued so far without the producer touching the consumer's end of
+// the queue: packets are numbered on enqueue and the consumer skips those below the flush point.
+template < typename PacketT >
+class PacketQueue {
+public:
+    struct Stats {
+        std::atomic<std::uint64_t> enqueued{ 0 };
+        std::atomic<std::uint64_t> rejected{ 0 };      // queue full, packet dropped by the producer.
+        std::atomic<std::uint64_t> flushes{ 0 };
+        std::atomic<std::uint64_t> flushed{ 0 };       // packets skipped by the consumer after a flush.
+        std::atomic<std::uint64_t> dequeued{ 0 };
+        std::atomic<std::uint64_t> lost{ 0 };          // dequeued packets the decoder failed to decode.
+        std::atomic<std::uint64_t> latencySumUs{ 0 };  // enqueue to dequeue, of dequeued packets.
+        std::atomic<std::uint64_t> maxLatencyUs{ 0 };
+        std::atomic<std::size_t>   highWatermark{ 0 };
+    };
+
+    explicit inline PacketQueue(const std::size_t capacity)
+    : m_queue(capacity),
+      m_enqueueTimesUs(std::make_unique<std::uint64_t[]>(capacity)),
+      m_capacity(capacity) {}
+
+    inline PacketQueue(const PacketQueue&) = delete;
+    inline PacketQueue(PacketQueue&&) = delete;
+    inline PacketQueue& operator=(const PacketQueue&) = delete;
+    inline PacketQueue& operator=(PacketQueue&&) = delete;
+
+    // Producer only.
+    inline bool TryEnqueue(PacketT&& packet) {
+        const std::uint64_t nowUs = GetSteadyTimestampUs();
+        const std::uint64_t sequence = m_nextSequence.load(std::memory_order_relaxed);
+        if (!m_queue.try_enqueue(Entry{ std::move(packet), sequence, nowUs })) {
+            m_stats.rejected.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        // at most m_capacity entries are queued, the slot of the oldest is never overwritten.
+        m_enqueueTimesUs[sequence % m_capacity] = nowUs;
+        m_nextSequence.store(sequence + 1, std::memory_order_relaxed);
+        m_stats.enqueued.fetch_add(1, std::memory_order_relaxed);
+        const std::size_t depth = GetState(nowUs).depth;
+        if (depth > m_stats.highWatermark.load(std::memory_order_relaxed))
+            m_stats.highWatermark.store(depth, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Producer only, enqueues both or neither (e.g. parameter sets & the frame they were sent with).
+    inline bool TryEnqueue(PacketT&& first, PacketT&& second) {
+        // the consumer only ever shrinks the queue, room seen here can not be taken away.
+        if (m_queue.max_capacity() - std::min(m_queue.size_approx(), m_queue.max_capacity()) < 2) {
+            m_stats.rejected.fetch_add(2, std::memory_order_relaxed);
+            return false;
+        }
+        const bool queued = TryEnqueue(std::move(first)) && TryEnqueue(std::move(second));
+        assert(queued);
+        return queued;
+    }
+
+    // Producer only.
+    inline void Flush() {
+        m_flushSequence.store(m_nextSequence.load(std::memory_order_relaxed), std::memory_order_release);
+        m_stats.flushes.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Producer only.
+    inline PacketQueueState GetState(const std::uint64_t nowUs = GetSteadyTimestampUs()) const {
+        const std::uint64_t oldest = std::max
+        (
+            m_dequeuedSequence.load(std::memory_order_acquire),
+            m_flushSequence.load(std::memory_order_relaxed)
+        );
+        const std::uint64_t next = m_nextSequence.load(std::memory_order_relaxed);
+        const bool hasDecodedFrame = m_hasDecodedFrame.load(std::memory_order_relaxed);
+        const std::uint64_t lostCount = m_stats.lost.load(std::memory_order_relaxed);
+        if (oldest >= next)
+            return { 0, 0, hasDecodedFrame, lostCount };
+        const std::uint64_t enqueueTimeUs = m_enqueueTimesUs[oldest % m_capacity];
+        return {
+            .depth           = static_cast<std::size_t>(next - oldest),
+            .oldestAgeUs     = nowUs > enqueueTimeUs ? nowUs - enqueueTimeUs : 0,
+            .hasDecodedFrame = hasDecodedFrame,
+            .lostCount       = lostCount
+        };
+    }
+
+    // Decoder side, from any of its threads: a frame was output.
+    inline void OnFrameDecoded() {
+        if (!m_hasDecodedFrame.load(std::memory_order_relaxed))
+            m_hasDecodedFrame.store(true, std::memory_order_relaxed);
+    }
+
+    // Decoder side: a dequeued packet failed to decode, the producer sees it through GetState.
+    inline void OnPacketLost() {
+        m_stats.lost.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Consumer only, false on timeout or when only flushed packets were queued.
+    template < typename Rep, typename Period >
+    inline bool WaitDequeue(PacketT& packet, const std::chrono::duration<Rep, Period>& timeout) {
+        Entry entry{};
+        if (!m_queue.wait_dequeue_timed(entry, timeout))
+            return false;
+        do {
+            m_dequeuedSequence.store(entry.sequence + 1, std::memory_order_release);
+            if (entry.sequence >= m_flushSequence.load(std::memory_order_acquire)) {
+                const std::uint64_t latencyUs = GetSteadyTimestampUs() - entry.enqueueTimeUs;
+                m_stats.dequeued.fetch_add(1, std::memory_order_relaxed);
+                m_stats.latencySumUs.fetch_add(latencyUs, std::memory_order_relaxed);
+                if (latencyUs > m_stats.maxLatencyUs.load(std::memory_order_relaxed))
+                    m_stats.maxLatencyUs.store(latencyUs, std::memory_order_relaxed);
+                packet = std::move(entry.packet);
+                return true;
+            }
+            m_stats.flushed.fetch_add(1, std::memory_order_relaxed);
+        } while (m_queue.try_dequeue(entry));
+        return false;
+    }
+
+    inline const Stats& GetStats() const { return m_stats; }
+
+    inline void LogStats(const char* const name) const {
+        const auto dequeued = m_stats.dequeued.load();
+        Log::Write(Log::Level::Info, Fmt("%s packet queue stats: enqueued=%llu, rejected=%llu, flushes=%llu, flushed=%llu, lost=%llu, high-watermark=%zu/%zu, latency mean=%.2fms max=%.2fms",
+            name, m_stats.enqueued.load(), m_stats.rejected.load(), m_stats.flushes.load(), m_stats.flushed.load(), m_stats.lost.load(),
+            m_stats.highWatermark.load(), m_capacity,
+            dequeued > 0 ? (m_stats.latencySumUs.load() / double(dequeued)) * 1e-3 : 0.0,
+            m_stats.maxLatencyUs.load() * 1e-3));
+    }
+
+private:
+    struct Entry {
+        PacketT       packet{};
+        std::uint64_t sequence{ 0 };
+        std::uint64_t enqueueTimeUs{ 0 };
+    };
+
+    moodycamel::BlockingReaderWriterCircularBuffer<Entry> m_queue;
+    // producer only, enqueue time by sequence % m_capacity.
+    std::unique_ptr<std::uint64_t[]> m_enqueueTimesUs;
+    const std::size_t                m_capacity;
+    std::atomic<std::uint64_t>       m_nextSequence{ 0 };
+    std::atomic<std::uint64_t>       m_flushSequence{ 0 };
+    std::atomic<std::uint64_t>       m_dequeuedSequence{ 0 };
+    std::atomic<bool>                m_hasDecodedFrame{ false };
+    Stats                            m_stats{};
+};
+
+}
+#endif
@@ -0,0 +1,283 @@
+#include "pch.h"
+#include "common.h"
+#include "plane_copy.h"
+
+#include <cstring>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define ALXR_PLANE_COPY_X86
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define ALXR_TARGET_AVX2
+    #else
+        #define ALXR_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+    // SSE2 rather than SSE4.1: the only SSE4.1 copy instruction, the MOVNTDQA streaming load, only helps
+    // reads from write-combined memory, the sources here are decoder frames in cacheable memory. The SSE2
+    // kernel's non-temporal stores are what matters for the upload heap & SSE2 is baseline on x86-64, so
+    // it needs no dispatch of its own below AVX2.
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define ALXR_PLANE_COPY_SSE2
+    #endif
+#elif defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+    #define ALXR_PLANE_COPY_NEON
+    #include <arm_neon.h>
+#endif
+
+namespace ALXR {
+namespace {
+
+using CopyRowFn = void (*)(std::uint8_t* dst, const std::uint8_t* src, std::size_t size);
+
+inline void CopyRowScalar(std::uint8_t* dst, const std::uint8_t* src, const std::size_t size) {
+    std::memcpy(dst, src, size);
+}
+
+#ifdef ALXR_PLANE_COPY_X86
+template < const std::size_t Alignment >
+inline std::size_t AlignHead(const std::uint8_t* dst, const std::size_t size) {
+    return std::min(size, (Alignment - (reinterpret_cast<std::uintptr_t>(dst) & (Alignment - 1))) & (Alignment - 1));
+}
+#endif
+
+#ifdef ALXR_PLANE_COPY_SSE2
+void CopyRowSSE2(std::uint8_t* dst, const std::uint8_t* src, std::size_t size) {
+    const std::size_t head = AlignHead<16>(dst, size);
+    std::memcpy(dst, src, head);
+    dst += head; src += head; size -= head;
+    for (; size >= 64; size -= 64, dst += 64, src += 64) {
+        const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+        const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+        const __m128i v3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48));
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst), v0);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 16), v1);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 32), v2);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 48), v3);
+    }
+    for (; size >= 16; size -= 16, dst += 16, src += 16)
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst), _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+    std::memcpy(dst, src, size);
+}
+#endif
+
+#ifdef ALXR_PLANE_COPY_X86
+ALXR_TARGET_AVX2 void CopyRowAVX2(std::uint8_t* dst, const std::uint8_t* src, std::size_t size) {
+    const std::size_t head = AlignHead<32>(dst, size);
+    std::memcpy(dst, src, head);
+    dst += head; src += head; size -= head;
+    for (; size >= 128; size -= 128, dst += 128, src += 128) {
+        const __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        const __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32));
+        const __m256i v2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 64));
+        const __m256i v3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 96));
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst), v0);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 32), v1);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 64), v2);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 96), v3);
+    }
+    for (; size >= 32; size -= 32, dst += 32, src += 32)
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)));
+    std::memcpy(dst, src, size);
+}
+
+bool HasAVX2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int regs[4]{};
+    __cpuid(regs, 0);
+    if (regs[0] < 7)
+        return false;
+    __cpuid(regs, 1);
+    constexpr const int OSXSAVE = 1 << 27, AVX = 1 << 28;
+    if ((regs[2] & (OSXSAVE | AVX)) != (OSXSAVE | AVX))
+        return false;
+    // OS must save/restore the ymm registers.
+    if ((_xgetbv(0) & 0x6) != 0x6)
+        return false;
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+#ifdef ALXR_PLANE_COPY_NEON
+// No non-temporal store intrinsics on arm, wide loads/stores with source prefetch still beat
+// memcpy's small-size handling on short (chroma) rows.
+void CopyRowNEON(std::uint8_t* dst, const std::uint8_t* src, std::size_t size) {
+    for (; size >= 64; size -= 64, dst += 64, src += 64) {
+        __builtin_prefetch(src + 256);
+        const uint8x16_t v0 = vld1q_u8(src);
+        const uint8x16_t v1 = vld1q_u8(src + 16);
+        const uint8x16_t v2 = vld1q_u8(src + 32);
+        const uint8x16_t v3 = vld1q_u8(src + 48);
+        vst1q_u8(dst, v0);
+        vst1q_u8(dst + 16, v1);
+        vst1q_u8(dst + 32, v2);
+        vst1q_u8(dst + 48, v3);
+    }
+    for (; size >= 16; size -= 16, dst += 16, src += 16)
+        vst1q_u8(dst, vld1q_u8(src));
+    std::memcpy(dst, src, size);
+}
+#endif
+
+PlaneCopyISA DetectPlaneCopyISA() {
+#ifdef ALXR_PLANE_COPY_X86
+    if (HasAVX2())
+        return PlaneCopyISA::AVX2;
+#endif
+#ifdef ALXR_PLANE_COPY_SSE2
+    return PlaneCopyISA::SSE2;
+#elif defined(ALXR_PLANE_COPY_NEON)
+    return PlaneCopyISA::NEON;
+#else
+    return PlaneCopyISA::Scalar;
+#endif
+}
+
+CopyRowFn GetCopyRowFn(const PlaneCopyISA isa) {
+    switch (isa) {
+#ifdef ALXR_PLANE_COPY_X86
+    case PlaneCopyISA::AVX2: return CopyRowAVX2;
+#endif
+#ifdef ALXR_PLANE_COPY_SSE2
+    case PlaneCopyISA::SSE2: return CopyRowSSE2;
+#endif
+#ifdef ALXR_PLANE_COPY_NEON
+    case PlaneCopyISA::NEON: return CopyRowNEON;
+#endif
+    default: return CopyRowScalar;
+    }
+}
+
+struct PlaneCopyDispatch {
+    PlaneCopyISA isa;
+    CopyRowFn    copyRow;
+
+    PlaneCopyDispatch()
+    : isa(DetectPlaneCopyISA()),
+      copyRow(GetCopyRowFn(isa)) {
+        Log::Write(Log::Level::Info, Fmt("Plane copy kernel: %s", ToString(isa)));
+    }
+};
+
+const PlaneCopyDispatch& GetDispatch() {
+    static const PlaneCopyDispatch dispatch{};
+    return dispatch;
+}
+
+} // namespace
+
+const char* ToString(const PlaneCopyISA isa) {
+    switch (isa) {
+    case PlaneCopyISA::SSE2: return "SSE2";
+    case PlaneCopyISA::AVX2: return "AVX2";
+    case PlaneCopyISA::NEON: return "NEON";
+    default: return "Scalar";
+    }
+}
+
+PlaneCopyISA GetPlaneCopyISA() {
+    return GetDispatch().isa;
+}
+
+void CopyPlane2D(const Plane2D& plane, const std::size_t rowBegin, const std::size_t rowEnd) {
+    if (rowBegin >= rowEnd || plane.rowBytes == 0)
+        return;
+    const CopyRowFn copyRow = GetDispatch().copyRow;
+    std::uint8_t* dst = plane.dst + plane.dstPitch * rowBegin;
+    const std::uint8_t* src = plane.src + plane.srcPitch * rowBegin;
+    if (plane.rowBytes == plane.dstPitch && plane.rowBytes == plane.srcPitch) {
+        copyRow(dst, src, plane.rowBytes * (rowEnd - rowBegin));
+    } else {
+        for (std::size_t row = rowBegin; row < rowEnd; ++row, dst += plane.dstPitch, src += plane.srcPitch)
+            copyRow(dst, src, plane.rowBytes);
+    }
+#ifdef ALXR_PLANE_COPY_X86
+    // streaming stores are weakly ordered, make them visible before the caller signals the GPU/other threads.
+    _mm_sfence();
+#endif
+}
+
+PlaneCopier::PlaneCopier(std::size_t workerCount) {
+    if (workerCount == std::size_t(-1)) {
+        // leave cores to the decoder's own threads & the render thread.
+        workerCount = std::min<std::size_t>(std::thread::hardware_concurrency() / 4, 3);
+    }
+    m_workers.reserve(workerCount);
+    for (std::size_t workerIndex = 0; workerIndex < workerCount; ++workerIndex)
+        m_workers.emplace_back(&PlaneCopier::WorkerMain, this, workerIndex);
+}
+
+PlaneCopier::~PlaneCopier() {
+    {
+        std::scoped_lock lock(m_mutex);
+        m_exit = true;
+    }
+    m_workReady.notify_all();
+    for (auto& worker : m_workers)
+        worker.join();
+}
+
+void PlaneCopier::CopyPartition(const std::size_t partition, const std::size_t partitionCount) const {
+    for (std::size_t planeIndex = 0; planeIndex < m_planeCount; ++planeIndex) {
+        const auto& plane = m_planes[planeIndex];
+        const std::size_t rowsPerPartition = (plane.rows + partitionCount - 1) / partitionCount;
+        const std::size_t rowBegin = std::min(plane.rows, partition * rowsPerPartition);
+        const std::size_t rowEnd = std::min(plane.rows, rowBegin + rowsPerPartition);
+        CopyPlane2D(plane, rowBegin, rowEnd);
+    }
+}
+
+void PlaneCopier::Copy(const Plane2D* planes, const std::size_t planeCount) {
+    CHECK(planes != nullptr && planeCount <= MaxPlanes);
+    std::size_t totalBytes = 0;
+    for (std::size_t planeIndex = 0; planeIndex < planeCount; ++planeIndex)
+        totalBytes += planes[planeIndex].rowBytes * planes[planeIndex].rows;
+
+    if (m_workers.empty() || totalBytes < MinParallelBytes) {
+        for (std::size_t planeIndex = 0; planeIndex < planeCount; ++planeIndex)
+            CopyPlane2D(planes[planeIndex]);
+        return;
+    }
+
+    {
+        std::scoped_lock lock(m_mutex);
+        std::copy_n(planes, planeCount, m_planes.begin());
+        m_planeCount = planeCount;
+        m_pending = m_workers.size();
+        ++m_generation;
+    }
+    m_workReady.notify_all();
+
+    CopyPartition(0, m_workers.size() + 1);
+
+    std::unique_lock lock(m_mutex);
+    m_workDone.wait(lock, [this]() { return m_pending == 0; });
+}
+
+void PlaneCopier::WorkerMain(const std::size_t workerIndex) {
+    std::uint64_t lastGeneration = 0;
+    std::unique_lock lock(m_mutex);
+    for (;;) {
+        m_workReady.wait(lock, [&]() { return m_exit || m_generation != lastGeneration; });
+        if (m_exit)
+            return;
+        lastGeneration = m_generation;
+        const std::size_t partitionCount = m_workers.size() + 1;
+
+        lock.unlock();
+        CopyPartition(workerIndex + 1, partitionCount);
+        lock.lock();
+
+        if (--m_pending == 0)
+            m_workDone.notify_one();
+    }
+}
+
+}
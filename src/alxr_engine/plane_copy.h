@@ -0,0 +1,82 @@
+#pragma once
+#ifndef ALXR_PLANE_COPY_H
+#define ALXR_PLANE_COPY_H
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace ALXR {
+
+// One image plane (luma, interleaved chroma or a single chroma plane of NV12/P010/3-plane 420 frames),
+// copied row by row from a pitched source (e.g. libavcodec output) into mapped upload memory.
+struct Plane2D {
+    std::uint8_t*       dst;
+    std::size_t         dstPitch;
+    const std::uint8_t* src;
+    std::size_t         srcPitch;
+    std::size_t         rowBytes; // width * bytes per texel
+    std::size_t         rows;
+};
+
+enum class PlaneCopyISA : std::uint32_t {
+    Scalar = 0,
+    SSE2,
+    AVX2,
+    NEON,
+};
+const char* ToString(const PlaneCopyISA isa);
+
+// Best kernel for the running CPU, detected once.
+PlaneCopyISA GetPlaneCopyISA();
+
+// Copies rows [rowBegin, rowEnd) of the plane with the dispatched kernel. On x86 the destination is written
+// with non-temporal stores, which avoids polluting the cache & read-for-ownership traffic on write-combined
+// (host-visible/upload heap) memory.
+void CopyPlane2D(const Plane2D& plane, const std::size_t rowBegin, const std::size_t rowEnd);
+inline void CopyPlane2D(const Plane2D& plane) { CopyPlane2D(plane, 0, plane.rows); }
+
+// Copies all planes of a frame, frames large enough to be worth it (4K-per-eye) have their rows partitioned
+// across a small set of persistent worker threads plus the calling thread. Copy must only be called from
+// one thread at a time (the decoder/upload thread).
+class PlaneCopier {
+public:
+    constexpr static const std::size_t MaxPlanes = 3;
+    // below this many bytes per frame waking workers costs more than it saves.
+    constexpr static const std::size_t MinParallelBytes = std::size_t(8) << 20;
+
+    // workerCount == size_t(-1) picks a count based on the hardware concurrency, 0 disables threading.
+    explicit PlaneCopier(const std::size_t workerCount = std::size_t(-1));
+    ~PlaneCopier();
+
+    PlaneCopier(const PlaneCopier&) = delete;
+    PlaneCopier(PlaneCopier&&) = delete;
+    PlaneCopier& operator=(const PlaneCopier&) = delete;
+    PlaneCopier& operator=(PlaneCopier&&) = delete;
+
+    void Copy(const Plane2D* planes, const std::size_t planeCount);
+
+    inline std::size_t WorkerCount() const { return m_workers.size(); }
+
+private:
+    void CopyPartition(const std::size_t partition, const std::size_t partitionCount) const;
+    void WorkerMain(const std::size_t workerIndex);
+
+    std::array<Plane2D, MaxPlanes> m_planes{};
+    std::size_t                    m_planeCount = 0;
+
+    std::mutex                     m_mutex{};
+    std::condition_variable        m_workReady{};
+    std::condition_variable        m_workDone{};
+    std::uint64_t                  m_generation = 0;
+    std::size_t                    m_pending = 0;
+    bool                           m_exit = false;
+    std::vector<std::thread>       m_workers{};
+};
+
+}
+#endif
@@ -0,0 +1,324 @@
+#include "pch.h"
+#include "common.h"
+#include "pose_prediction.h"
+
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include <common/xr_linear.h>
+
+namespace ALXR {
+namespace {
+
+constexpr const float NsToSeconds = 1e-9f;
+
+inline XrQuaternionf Conjugate(const XrQuaternionf& q) {
+    return { -q.x, -q.y, -q.z, q.w };
+}
+
+// a * b, XrQuaternionf_Multiply composes in application order (b * a).
+inline XrQuaternionf Multiply(const XrQuaternionf& a, const XrQuaternionf& b) {
+    XrQuaternionf result;
+    XrQuaternionf_Multiply(&result, &b, &a);
+    return result;
+}
+
+inline XrVector3f Rotate(const XrQuaternionf& q, const XrVector3f& v) {
+    // v + 2w(u x v) + 2u x (u x v)
+    const XrVector3f u{ q.x, q.y, q.z };
+    XrVector3f uv, uuv;
+    XrVector3f_Cross(&uv, &u, &v);
+    XrVector3f_Cross(&uuv, &u, &uv);
+    return {
+        v.x + 2.0f * (q.w * uv.x + uuv.x),
+        v.y + 2.0f * (q.w * uv.y + uuv.y),
+        v.z + 2.0f * (q.w * uv.z + uuv.z)
+    };
+}
+
+inline XrVector3f MultiplyAdd(const XrVector3f& a, const XrVector3f& b, const float s) {
+    return { a.x + b.x * s, a.y + b.y * s, a.z + b.z * s };
+}
+
+inline XrVector3f Difference(const XrVector3f& a, const XrVector3f& b, const float scale) {
+    return { (a.x - b.x) * scale, (a.y - b.y) * scale, (a.z - b.z) * scale };
+}
+
+inline bool IsZero(const XrVector3f& v) {
+    return v.x == 0.0f && v.y == 0.0f && v.z == 0.0f;
+}
+
+// Base-space angular velocity turning from into to over dt seconds.
+XrVector3f AngularVelocity(const XrQuaternionf& from, const XrQuaternionf& to, const float dt) {
+    XrQuaternionf delta = Multiply(to, Conjugate(from));
+    if (delta.w < 0.0f)
+        delta = { -delta.x, -delta.y, -delta.z, -delta.w };
+    const float sinHalfAngle = std::sqrt(delta.x * delta.x + delta.y * delta.y + delta.z * delta.z);
+    if (sinHalfAngle < 1e-7f)
+        return { 0, 0, 0 };
+    const float angle = 2.0f * std::atan2(sinHalfAngle, delta.w);
+    const float scale = angle / (sinHalfAngle * dt);
+    return { delta.x * scale, delta.y * scale, delta.z * scale };
+}
+
+float AngleBetween(const XrQuaternionf& a, const XrQuaternionf& b) {
+    const float dot = std::fabs(a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w);
+    return 2.0f * std::acos(std::min(dot, 1.0f));
+}
+
+struct PoseTraceRecord {
+    XrTime          time;
+    PoseTraceDevice device;
+    std::uint32_t   reserved;
+    XrPosef         pose;
+    XrVector3f      linearVelocity;
+    XrVector3f      angularVelocity;
+};
+static_assert(sizeof(PoseTraceRecord) == 72);
+constexpr const std::uint32_t PoseTraceMagic = 0x54505841; // "AXPT"
+constexpr const std::uint32_t PoseTraceVersion = 1;
+
+struct ErrorStats {
+    float mean;
+    float p90;
+    float p99;
+};
+ErrorStats MakeErrorStats(std::vector<float>& errors) {
+    if (errors.empty())
+        return { 0, 0, 0 };
+    double sum = 0;
+    for (const float e : errors)
+        sum += e;
+    const auto percentile = [&errors](const double p) {
+        const auto nth = errors.begin() + static_cast<std::ptrdiff_t>(p * (errors.size() - 1));
+        std::nth_element(errors.begin(), nth, errors.end());
+        return *nth;
+    };
+    return {
+        .mean = static_cast<float>(sum / errors.size()),
+        .p90 = percentile(0.90),
+        .p99 = percentile(0.99)
+    };
+}
+
+const char* ToString(const PoseTraceDevice device) {
+    switch (device) {
+    case PoseTraceDevice::Head: return "head";
+    case PoseTraceDevice::LeftHand: return "left";
+    case PoseTraceDevice::RightHand: return "right";
+    default: return "unknown";
+    }
+}
+
+}
+
+const char* ToString(const PosePredictionModel model) {
+    switch (model) {
+    case PosePredictionModel::Hold: return "Hold";
+    case PosePredictionModel::ConstantVelocity: return "ConstantVelocity";
+    case PosePredictionModel::ConstantAcceleration: return "ConstantAcceleration";
+    default: return "Unknown";
+    }
+}
+
+XrQuaternionf IntegrateAngularVelocity(const XrQuaternionf& orientation, const XrVector3f& angularVelocity, const float dt) {
+    // XrQuaternionf_ApplyVelocity pre-rotates orientation, i.e. takes a base-space velocity.
+    XrQuaternionf result;
+    XrQuaternionf_ApplyVelocity(&result, &orientation, &angularVelocity, dt);
+    XrQuaternionf_Normalize(&result);
+    return result;
+}
+
+void ApplyHeadPoseDelta(const XrPosef& sampledHead, const XrPosef& predictedHead, std::span<XrView> views) {
+    const XrQuaternionf deltaRotation = Multiply(predictedHead.orientation, Conjugate(sampledHead.orientation));
+    for (auto& view : views) {
+        XrVector3f offset;
+        XrVector3f_Sub(&offset, &view.pose.position, &sampledHead.position);
+        const XrVector3f rotatedOffset = Rotate(deltaRotation, offset);
+        XrVector3f_Add(&view.pose.position, &predictedHead.position, &rotatedOffset);
+        view.pose.orientation = Multiply(deltaRotation, view.pose.orientation);
+        XrQuaternionf_Normalize(&view.pose.orientation);
+    }
+}
+
+void PoseHistory::Push(const XrTime time, const SpaceLoc& loc) {
+    Sample sample{ time, loc };
+    if (m_count > 0) {
+        const Sample& previous = At(0);
+        if (time <= previous.time)
+            return;
+        // after a stall (paused session) there is nothing recent enough to difference against.
+        if (time - previous.time > MaxHorizon)
+            m_count = 0;
+    }
+    if (m_count > 0) {
+        const Sample& previous = At(0);
+        const float dt = (time - previous.time) * NsToSeconds;
+        if (IsZero(sample.loc.linearVelocity))
+            sample.loc.linearVelocity = Difference(loc.pose.position, previous.loc.pose.position, 1.0f / dt);
+        if (IsZero(sample.loc.angularVelocity))
+            sample.loc.angularVelocity = AngularVelocity(previous.loc.pose.orientation, loc.pose.orientation, dt);
+    }
+    m_latest = (m_latest + 1) % Capacity;
+    m_samples[m_latest] = sample;
+    m_count = std::min(m_count + 1, Capacity);
+}
+
+SpaceLoc PoseHistory::Predict(const XrTime targetTime, const PosePredictionModel model) const {
+    if (m_count == 0)
+        return IdentitySpaceLoc;
+    const Sample& latest = At(0);
+    if (model == PosePredictionModel::Hold || targetTime <= latest.time)
+        return latest.loc;
+    const float dt = std::min(targetTime - latest.time, MaxHorizon) * NsToSeconds;
+
+    XrVector3f linearAcceleration{ 0, 0, 0 }, angularAcceleration{ 0, 0, 0 };
+    if (model == PosePredictionModel::ConstantAcceleration) {
+        for (std::size_t age = 1; age < m_count; ++age) {
+            const Sample& older = At(age);
+            const XrDuration span = latest.time - older.time;
+            if (span < AccelerationWindow)
+                continue;
+            const float rcpSpan = 1.0f / (span * NsToSeconds);
+            linearAcceleration = Difference(latest.loc.linearVelocity, older.loc.linearVelocity, rcpSpan);
+            angularAcceleration = Difference(latest.loc.angularVelocity, older.loc.angularVelocity, rcpSpan);
+            break;
+        }
+    }
+
+    const SpaceLoc& loc = latest.loc;
+    SpaceLoc result = loc;
+    result.pose.position = MultiplyAdd(MultiplyAdd(loc.pose.position, loc.linearVelocity, dt), linearAcceleration, 0.5f * dt * dt);
+    result.linearVelocity = MultiplyAdd(loc.linearVelocity, linearAcceleration, dt);
+    // the mean angular velocity over dt, exact while the rotation axis stays fixed.
+    const XrVector3f meanAngularVelocity = MultiplyAdd(loc.angularVelocity, angularAcceleration, 0.5f * dt);
+    result.pose.orientation = IntegrateAngularVelocity(loc.pose.orientation, meanAngularVelocity, dt);
+    result.angularVelocity = MultiplyAdd(loc.angularVelocity, angularAcceleration, dt);
+    return result;
+}
+
+PoseTraceWriter& PoseTraceWriter::Instance() {
+    static PoseTraceWriter instance{};
+    return instance;
+}
+
+bool PoseTraceWriter::Open(const std::filesystem::path& filePath) {
+    Close();
+    std::scoped_lock lock(m_fileMutex);
+    m_file.open(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    const std::uint32_t header[] = { PoseTraceMagic, PoseTraceVersion };
+    m_file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    if (!m_file) {
+        Log::Write(Log::Level::Warning, Fmt("Failed to create pose trace \"%s\"", filePath.string().c_str()));
+        m_file.close();
+        return false;
+    }
+    m_recordCount = 0;
+    m_isOpen.store(true, std::memory_order_release);
+    Log::Write(Log::Level::Info, Fmt("Pose trace started: \"%s\"", filePath.string().c_str()));
+    return true;
+}
+
+void PoseTraceWriter::Close() {
+    std::scoped_lock lock(m_fileMutex);
+    if (!m_isOpen.exchange(false, std::memory_order_acq_rel))
+        return;
+    m_file.close();
+    Log::Write(Log::Level::Info, Fmt("Pose trace stopped, %zu poses written.", m_recordCount));
+}
+
+void PoseTraceWriter::WriteRecord(const PoseTraceDevice device, const XrTime time, const SpaceLoc& loc) {
+    const PoseTraceRecord record {
+        .time = time,
+        .device = device,
+        .reserved = 0,
+        .pose = loc.pose,
+        .linearVelocity = loc.linearVelocity,
+        .angularVelocity = loc.angularVelocity
+    };
+    std::scoped_lock lock(m_fileMutex);
+    if (!m_isOpen.load(std::memory_order_relaxed))
+        return;
+    m_file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    if (!m_file) {
+        Log::Write(Log::Level::Warning, "Pose trace write failed, trace stopped.");
+        m_isOpen.store(false, std::memory_order_release);
+        m_file.close();
+        return;
+    }
+    ++m_recordCount;
+}
+
+bool EvaluatePoseTrace(const std::filesystem::path& filePath, const std::uint32_t maxHorizonMs) {
+    std::ifstream inFile(filePath, std::ios::in | std::ios::binary);
+    std::uint32_t header[2] = {};
+    if (!inFile.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+        header[0] != PoseTraceMagic || header[1] != PoseTraceVersion) {
+        Log::Write(Log::Level::Warning, Fmt("\"%s\" is not a compatible pose trace.", filePath.string().c_str()));
+        return false;
+    }
+    constexpr const std::size_t DeviceCount = static_cast<std::size_t>(PoseTraceDevice::TypeCount);
+    std::array<std::vector<PoseTraceRecord>, DeviceCount> deviceRecords{};
+    PoseTraceRecord record;
+    while (inFile.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        const auto deviceIndex = static_cast<std::size_t>(record.device);
+        if (deviceIndex >= DeviceCount)
+            continue;
+        auto& records = deviceRecords[deviceIndex];
+        if (records.empty() || record.time > records.back().time)
+            records.push_back(record);
+    }
+
+    const std::uint32_t horizonCount = std::max(maxHorizonMs / 10, 1u);
+    std::vector<float> positionErrors, angleErrors;
+    for (std::size_t deviceIndex = 0; deviceIndex < DeviceCount; ++deviceIndex) {
+        const auto& records = deviceRecords[deviceIndex];
+        if (records.size() < 2)
+            continue;
+        const auto device = static_cast<PoseTraceDevice>(deviceIndex);
+        const double durationS = (records.back().time - records.front().time) * 1e-9;
+        Log::Write(Log::Level::Info, Fmt("Pose prediction %s: %zu poses over %.1fs", ToString(device), records.size(), durationS));
+
+        for (std::size_t modelIndex = 0; modelIndex < static_cast<std::size_t>(PosePredictionModel::TypeCount); ++modelIndex) {
+            const auto model = static_cast<PosePredictionModel>(modelIndex);
+            for (std::uint32_t horizonIndex = 1; horizonIndex <= horizonCount; ++horizonIndex) {
+                const XrDuration horizon = static_cast<XrDuration>(horizonIndex) * 10'000'000;
+                positionErrors.clear();
+                angleErrors.clear();
+                PoseHistory history{};
+                std::size_t next = 1;
+                for (const auto& sample : records) {
+                    history.Push(sample.time, { sample.pose, sample.linearVelocity, sample.angularVelocity });
+                    const XrTime targetTime = sample.time + horizon;
+                    while (next < records.size() && records[next].time < targetTime)
+                        ++next;
+                    if (next >= records.size())
+                        break;
+                    // the traced pose at targetTime, interpolated between the samples around it.
+                    const auto& before = records[next - 1];
+                    const auto& after = records[next];
+                    const float t = static_cast<float>(targetTime - before.time) / static_cast<float>(after.time - before.time);
+                    XrPosef truth;
+                    XrVector3f_Lerp(&truth.position, &before.pose.position, &after.pose.position, t);
+                    XrQuaternionf_Lerp(&truth.orientation, &before.pose.orientation, &after.pose.orientation, t);
+
+                    const SpaceLoc predicted = history.Predict(targetTime, model);
+                    XrVector3f positionError;
+                    XrVector3f_Sub(&positionError, &predicted.pose.position, &truth.position);
+                    positionErrors.push_back(XrVector3f_Length(&positionError) * 1000.0f);
+                    angleErrors.push_back(AngleBetween(predicted.pose.orientation, truth.orientation) * (180.0f / MATH_PI));
+                }
+                if (positionErrors.empty())
+                    break;
+                const auto pos = MakeErrorStats(positionErrors);
+                const auto ang = MakeErrorStats(angleErrors);
+                Log::Write(Log::Level::Info, Fmt("Pose prediction %-5s %-20s +%3ums: position mean %6.2fmm p90 %6.2fmm p99 %6.2fmm, orientation mean %5.2fdeg p90 %5.2fdeg p99 %5.2fdeg",
+                    ToString(device), ToString(model), horizonIndex * 10,
+                    pos.mean, pos.p90, pos.p99, ang.mean, ang.p90, ang.p99));
+            }
+        }
+    }
+    return true;
+}
+
+}
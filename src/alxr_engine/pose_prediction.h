@@ -0,0 +1,103 @@
+#pragma once
+#ifndef ALXR_POSE_PREDICTION_H
+#define ALXR_POSE_PREDICTION_H
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <fstream>
+#include <filesystem>
+#include <span>
+
+#include "xr_utils.h"
+
+namespace ALXR {
+
+enum class PosePredictionModel : std::uint32_t {
+    Hold,                 // the latest sample as-is, no extrapolation.
+    ConstantVelocity,
+    ConstantAcceleration, // velocity & its rate of change over the last PoseHistory::AccelerationWindow.
+    TypeCount
+};
+const char* ToString(const PosePredictionModel model);
+
+// Rotates orientation by a base-space angular velocity (as reported by xrLocateSpace) applied for dt seconds.
+XrQuaternionf IntegrateAngularVelocity(const XrQuaternionf& orientation, const XrVector3f& angularVelocity, const float dt);
+
+// Moves views rigidly with the head, from where they were located (at sampledHead) to predictedHead.
+void ApplyHeadPoseDelta(const XrPosef& sampledHead, const XrPosef& predictedHead, std::span<XrView> views);
+
+// Short history of located poses of one device, extrapolates to a later (display) time. Velocities
+// missing from a sample (zero) are estimated from the previous sample's pose.
+//
+// Not thread-safe, owned by the tracking thread.
+class PoseHistory {
+public:
+    constexpr static const std::size_t Capacity = 8;
+    // acceleration is taken over at least this long, shorter spans amplify the runtime's velocity noise.
+    constexpr static const XrDuration AccelerationWindow = 20'000'000;
+    // extrapolation further than this is clamped, errors grow (at best) quadratically with the horizon.
+    constexpr static const XrDuration MaxHorizon = 150'000'000;
+
+    void Push(const XrTime time, const SpaceLoc& loc);
+    inline void Clear() { m_count = 0; }
+    inline bool IsEmpty() const { return m_count == 0; }
+
+    SpaceLoc Predict(const XrTime targetTime, const PosePredictionModel model) const;
+
+private:
+    struct Sample {
+        XrTime   time;
+        SpaceLoc loc;
+    };
+    // 0 is the latest sample.
+    inline const Sample& At(const std::size_t age) const {
+        return m_samples[(m_latest + Capacity - age) % Capacity];
+    }
+
+    std::array<Sample, Capacity> m_samples{};
+    std::size_t                  m_latest = 0;
+    std::size_t                  m_count = 0;
+};
+
+enum class PoseTraceDevice : std::uint32_t {
+    Head,
+    LeftHand,
+    RightHand,
+    TypeCount
+};
+
+// Records located (not predicted) device poses for offline evaluation with EvaluatePoseTrace.
+//
+// File layout: u32 magic, u32 version, then PoseTraceRecords.
+class PoseTraceWriter {
+public:
+    bool Open(const std::filesystem::path& filePath);
+    void Close();
+
+    inline bool IsOpen() const { return m_isOpen.load(std::memory_order_acquire); }
+
+    inline void Write(const PoseTraceDevice device, const XrTime time, const SpaceLoc& loc) {
+        if (IsOpen())
+            WriteRecord(device, time, loc);
+    }
+
+    static PoseTraceWriter& Instance();
+
+private:
+    void WriteRecord(const PoseTraceDevice device, const XrTime time, const SpaceLoc& loc);
+
+    std::mutex        m_fileMutex;
+    std::ofstream     m_file;
+    std::size_t       m_recordCount{ 0 };
+    std::atomic<bool> m_isOpen{ false };
+};
+
+// Replays a pose trace through every prediction model & logs the position/orientation error vs. the
+// traced pose, per device & horizon (10ms steps up to maxHorizonMs).
+bool EvaluatePoseTrace(const std::filesystem::path& filePath, const std::uint32_t maxHorizonMs);
+
+}
+#endif
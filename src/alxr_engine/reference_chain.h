@@ -0,0 +1,79 @@
+#pragma once
+#ifndef ALXR_REFERENCE_CHAIN_H
+#define ALXR_REFERENCE_CHAIN_H
+
+#include <cstdint>
+#include "nal_parser.h"
+
+namespace ALXR {
+
+// Tracks whether received frames are decodable. A frame lost to the network (FEC failure or missing
+// packets) breaks the reference chain, every inter frame until the next key frame would only decode
+// into corrupted blocks so they are dropped before reaching the decoder. Only key frames (H.264 IDR,
+// HEVC IRAP) restore the chain: an I slice in a non-IRAP picture, or a picture whose first slice alone
+// is intra, does not stop later frames from referencing pictures from before the loss.
+//
+// trackingFrameIndex follows the tracking rate rather than the encoded frame rate, gaps in it are not
+// losses. It is only required to be monotonic, frames older than the last one fed are stale.
+//
+// Not thread-safe, only used from the network thread.
+class ReferenceChainTracker {
+public:
+    // Long enough for the server to encode & send the requested IDR, shorter than it takes a user to
+    // notice the stream stalling if the request itself was lost.
+    constexpr static const std::uint64_t IDRRequestIntervalUs = 250000;
+
+    enum class Verdict {
+        Decode,
+        DropStale,        // older than a frame already fed to the decoder.
+        DropUndecodable   // references a lost frame.
+    };
+
+    // The stream (re)starts waiting on a key frame, an IDR was just requested at nowUs.
+    inline void Reset(const std::uint64_t nowUs) {
+        m_isChainValid = false;
+        m_isIDRRequested = true;
+        m_lastIDRRequestUs = nowUs;
+        m_lastFrameIndex = NoFrame;
+    }
+
+    inline void OnFrameLost() { m_isChainValid = false; }
+
+    Verdict OnFrame(const std::uint64_t frameIndex, const NALFrameInfo& frameInfo) {
+        if (m_lastFrameIndex != NoFrame && frameIndex < m_lastFrameIndex)
+            return Verdict::DropStale;
+        // no slices, e.g. parameter sets only, left to the decoder.
+        if (frameInfo.isKeyFrame) {
+            m_isChainValid = true;
+            m_isIDRRequested = false;
+        } else if (frameInfo.hasSlices && !m_isChainValid)
+            return Verdict::DropUndecodable;
+        m_lastFrameIndex = frameIndex;
+        return Verdict::Decode;
+    }
+
+    // True at most once per IDRRequestIntervalUs while the chain is broken, repeated requests from a
+    // burst of losses are folded into one & a request that went unanswered is retried.
+    bool ShouldRequestIDR(const std::uint64_t nowUs) {
+        if (m_isChainValid)
+            return false;
+        if (m_isIDRRequested && nowUs - m_lastIDRRequestUs < IDRRequestIntervalUs)
+            return false;
+        m_isIDRRequested = true;
+        m_lastIDRRequestUs = nowUs;
+        return true;
+    }
+
+    inline bool IsChainValid() const { return m_isChainValid; }
+
+private:
+    constexpr static const std::uint64_t NoFrame = std::uint64_t(-1);
+
+    std::uint64_t m_lastFrameIndex = NoFrame;
+    std::uint64_t m_lastIDRRequestUs = 0;
+    bool          m_isChainValid = false;
+    bool          m_isIDRRequested = false;
+};
+
+}
+#endif
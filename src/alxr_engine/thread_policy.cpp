@@ -0,0 +1,79 @@
+#include "pch.h"
+#include "common.h"
+#include "thread_policy.h"
+
+#include <cerrno>
+
+#if defined(XR_USE_PLATFORM_ANDROID) || defined(__linux__)
+#include <sched.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#define ALXR_USE_PTHREAD_POLICY
+#endif
+
+namespace ALXR {
+
+bool SetCurrentThreadAffinity(const std::uint64_t cpuMask) {
+    if (cpuMask == 0)
+        return true;
+#if defined(XR_USE_PLATFORM_WIN32)
+    if (SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(cpuMask)) == 0) {
+        Log::Write(Log::Level::Warning, Fmt("Failed to set thread affinity mask 0x%llx, error: %lu", cpuMask, GetLastError()));
+        return false;
+    }
+#elif defined(ALXR_USE_PTHREAD_POLICY)
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (int cpuIndex = 0; cpuIndex < 64; ++cpuIndex) {
+        if ((cpuMask >> cpuIndex) & 1)
+            CPU_SET(cpuIndex, &cpuSet);
+    }
+    // pid 0 is the calling thread, unlike pthread_setaffinity_np this is also available on android.
+    if (sched_setaffinity(0, sizeof(cpuSet), &cpuSet) != 0) {
+        Log::Write(Log::Level::Warning, Fmt("Failed to set thread affinity mask 0x%llx, errno: %d", cpuMask, errno));
+        return false;
+    }
+#else
+    Log::Write(Log::Level::Warning, "Thread affinity is not supported on this platform.");
+    return false;
+#endif
+    Log::Write(Log::Level::Info, Fmt("Thread affinity mask set to 0x%llx", cpuMask));
+    return true;
+}
+
+bool SetCurrentThreadRealtimePriority() {
+#if defined(XR_USE_PLATFORM_WIN32)
+    if (!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST)) {
+        Log::Write(Log::Level::Warning, Fmt("Failed to raise thread priority, error: %lu", GetLastError()));
+        return false;
+    }
+    Log::Write(Log::Level::Info, "Thread priority set to THREAD_PRIORITY_HIGHEST");
+    return true;
+#elif defined(ALXR_USE_PTHREAD_POLICY)
+    // mid-range so the compositor/audio threads of the runtime can still preempt us.
+    const int minPriority = sched_get_priority_min(SCHED_FIFO);
+    const int maxPriority = sched_get_priority_max(SCHED_FIFO);
+    sched_param schedParam{};
+    schedParam.sched_priority = minPriority + (maxPriority - minPriority) / 2;
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &schedParam) == 0) {
+        Log::Write(Log::Level::Info, Fmt("Thread scheduling policy set to SCHED_FIFO, priority: %d", schedParam.sched_priority));
+        return true;
+    }
+    // on linux setpriority with a thread id only affects that thread.
+    constexpr const int NiceValue = -10;
+    const auto tid = static_cast<id_t>(syscall(SYS_gettid));
+    if (setpriority(PRIO_PROCESS, tid, NiceValue) == 0) {
+        Log::Write(Log::Level::Info, Fmt("SCHED_FIFO not permitted, thread nice value set to %d", NiceValue));
+        return true;
+    }
+    Log::Write(Log::Level::Warning, Fmt("Failed to raise thread priority, errno: %d", errno));
+    return false;
+#else
+    Log::Write(Log::Level::Warning, "Thread priority elevation is not supported on this platform.");
+    return false;
+#endif
+}
+
+}
@@ -0,0 +1,20 @@
+#pragma once
+#ifndef ALXR_THREAD_POLICY_H
+#define ALXR_THREAD_POLICY_H
+
+#include <cstdint>
+
+namespace ALXR {
+
+// Restricts the calling thread to the cores set in cpuMask (bit N = logical core N), a zero mask
+// leaves the affinity unchanged. On pthreads platforms threads created afterwards by the calling
+// thread (e.g. libavcodec's worker threads) inherit the mask.
+bool SetCurrentThreadAffinity(const std::uint64_t cpuMask);
+
+// Raises the calling thread's scheduling priority for latency critical work. On linux/android
+// SCHED_FIFO is tried first (needs CAP_SYS_NICE or an rtprio limit), falling back to the lowest
+// nice value permitted. Threads created afterwards inherit the scheduling policy on pthreads platforms.
+bool SetCurrentThreadRealtimePriority();
+
+}
+#endif
@@ -3,9 +3,14 @@
 #define ALXR_TIMING_H
 
 #include <cstdint>
+#include <cstddef>
 #include <ctime>
+#include <array>
+#include <algorithm>
+#include <bit>
 #include <chrono>
 #include <sstream>
+#include <string>
 #include "logger.h"
 
 #if 1 //def XR_USE_PLATFORM_WIN32
@@ -128,4 +133,46 @@ inline decltype(auto) time_call_ms(const char* name, Fun&& fn)
     }
 }
 
+// Power-of-two bucketed histogram of durations in microseconds, bucket N counts samples in
+// [2^(N-1), 2^N) us, bucket 0 sub-microsecond samples and the last bucket everything above.
+// Not thread-safe, meant to be owned by the thread being measured.
+template < const std::size_t BucketCount = 16 >
+struct LatencyHistogramUs
+{
+    static_assert(BucketCount >= 2);
+
+    std::array<std::uint64_t, BucketCount> buckets{};
+    std::uint64_t count   = 0;
+    std::uint64_t totalUs = 0;
+    std::uint64_t maxUs   = 0;
+
+    inline void Add(const std::uint64_t us)
+    {
+        const auto bucket = std::min<std::size_t>(std::bit_width(us), BucketCount - 1);
+        ++buckets[bucket];
+        ++count;
+        totalUs += us;
+        maxUs = std::max(maxUs, us);
+    }
+
+    inline void Reset() { *this = {}; }
+
+    std::string ToString() const
+    {
+        std::ostringstream oss;
+        oss << "samples: " << count
+            << ", avg: " << (count == 0 ? 0 : totalUs / count) << "us"
+            << ", max: " << maxUs << "us, buckets:";
+        for (std::size_t index = 0; index < BucketCount; ++index) {
+            if (buckets[index] == 0)
+                continue;
+            if (index == BucketCount - 1)
+                oss << " >=" << (std::uint64_t(1) << (index - 1)) << "us:" << buckets[index];
+            else
+                oss << " <" << (std::uint64_t(1) << index) << "us:" << buckets[index];
+        }
+        return oss.str();
+    }
+};
+
 #endif
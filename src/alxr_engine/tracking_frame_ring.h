@@ -0,0 +1,189 @@
+#pragma once
+#ifndef ALXR_TRACKING_FRAME_RING_H
+#define ALXR_TRACKING_FRAME_RING_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <array>
+#include <type_traits>
+
+namespace ALXR {
+
+// Fixed-size history of timestamped records written by a single (tracking) thread and read by any
+// number of (render) threads without locking. Each slot is guarded by a seqlock, readers retry only
+// if they race the writer on that exact slot, writers never wait on readers. Lookups by exact
+// timestamp go through a direct-mapped index and are O(1), misses fall back to the nearest timestamp.
+// Timestamps are expected to be pushed in increasing order (e.g. predicted display times).
+template < typename Record, const std::size_t Capacity >
+class TrackingFrameRing
+{
+    static_assert(std::is_trivially_copyable_v<Record>, "Records are copied optimistically and must be trivially copyable.");
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two.");
+
+    constexpr static const std::size_t Mask = Capacity - 1;
+    constexpr static const std::size_t IndexSize = Capacity * 2;
+    constexpr static const std::size_t IndexMask = IndexSize - 1;
+    constexpr static const std::uint64_t NullPos = 0;
+    // records either side of where a missed timestamp falls compared by FindNearest.
+    constexpr static const std::uint64_t NearestRadius = 2;
+
+    constexpr static const std::size_t RecordWords = (sizeof(Record) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+    using RecordWordList = std::array<std::uint64_t, RecordWords>;
+
+    // The payload is copied as relaxed atomic words, a reader racing the writer reads a torn (and
+    // discarded) copy rather than being a data race.
+    struct alignas(64) Slot
+    {
+        std::atomic<std::uint64_t> sequence{ 0 }; // odd while being written.
+        std::atomic<std::uint64_t> position{ NullPos };
+        std::atomic<std::uint64_t> timestamp{ 0 };
+        std::array<std::atomic<std::uint64_t>, RecordWords> record{}; // the record's bytes.
+    };
+
+    struct Snapshot
+    {
+        std::uint64_t position;
+        std::uint64_t timestamp;
+        Record        record;
+    };
+
+    std::array<Slot, Capacity>                        m_slots{};
+    // timestamp hash -> 1-based write position of the slot holding it, NullPos if empty.
+    std::array<std::atomic<std::uint64_t>, IndexSize> m_index{};
+    alignas(64) std::atomic<std::uint64_t>            m_writePos{ NullPos };
+
+    constexpr static inline std::size_t Hash(std::uint64_t ts)
+    {
+        // splitmix64 finalizer, timestamps are ns values with poorly distributed low bits.
+        ts ^= ts >> 30; ts *= 0xbf58476d1ce4e5b9ULL;
+        ts ^= ts >> 27; ts *= 0x94d049bb133111ebULL;
+        ts ^= ts >> 31;
+        return static_cast<std::size_t>(ts) & IndexMask;
+    }
+
+    inline bool TryRead(const Slot& slot, Snapshot& out) const
+    {
+        RecordWordList words;
+        for (;;)
+        {
+            const std::uint64_t seq0 = slot.sequence.load(std::memory_order_acquire);
+            if (seq0 & 1)
+                continue;
+            out.position  = slot.position.load(std::memory_order_relaxed);
+            out.timestamp = slot.timestamp.load(std::memory_order_relaxed);
+            for (std::size_t i = 0; i < RecordWords; ++i)
+                words[i] = slot.record[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == seq0) {
+                std::memcpy(&out.record, words.data(), sizeof(Record));
+                return out.position != NullPos;
+            }
+        }
+    }
+
+    // The record written at pos, false if it was overwritten (or not written yet).
+    inline bool TryReadPosition(const std::uint64_t pos, Snapshot& out) const
+    {
+        return TryRead(m_slots[(pos - 1) & Mask], out) && out.position == pos;
+    }
+
+public:
+    inline TrackingFrameRing() noexcept = default;
+    inline TrackingFrameRing(const TrackingFrameRing&) = delete;
+    inline TrackingFrameRing(TrackingFrameRing&&) = delete;
+    inline TrackingFrameRing& operator=(const TrackingFrameRing&) = delete;
+    inline TrackingFrameRing& operator=(TrackingFrameRing&&) = delete;
+
+    // Must only be called from a single writer thread.
+    void Push(const std::uint64_t timestamp, const Record& record)
+    {
+        const std::uint64_t pos = m_writePos.load(std::memory_order_relaxed) + 1;
+        Slot& slot = m_slots[(pos - 1) & Mask];
+        RecordWordList words{};
+        std::memcpy(words.data(), &record, sizeof(Record));
+
+        const std::uint64_t seq = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.position.store(pos, std::memory_order_relaxed);
+        slot.timestamp.store(timestamp, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < RecordWords; ++i)
+            slot.record[i].store(words[i], std::memory_order_relaxed);
+        slot.sequence.store(seq + 2, std::memory_order_release);
+
+        m_index[Hash(timestamp)].store(pos, std::memory_order_release);
+        m_writePos.store(pos, std::memory_order_release);
+    }
+
+    // Exact timestamp lookup, O(1).
+    bool Find(const std::uint64_t timestamp, Record& out) const
+    {
+        const std::uint64_t pos = m_index[Hash(timestamp)].load(std::memory_order_acquire);
+        if (pos == NullPos)
+            return false;
+        Snapshot snapshot;
+        if (!TryReadPosition(pos, snapshot) || snapshot.timestamp != timestamp)
+            return false;
+        out = snapshot.record;
+        return true;
+    }
+
+    // Most recently pushed record.
+    bool Latest(Record& out) const
+    {
+        const std::uint64_t pos = m_writePos.load(std::memory_order_acquire);
+        if (pos == NullPos)
+            return false;
+        Snapshot snapshot;
+        if (!TryRead(m_slots[(pos - 1) & Mask], snapshot))
+            return false;
+        out = snapshot.record;
+        return true;
+    }
+
+    // Exact lookup, falling back to the record with the closest timestamp. A miss binary searches the
+    // positions still held for where timestamp falls & compares the records around it, O(log Capacity).
+    bool FindNearest(const std::uint64_t timestamp, Record& out) const
+    {
+        if (Find(timestamp, out))
+            return true;
+        const std::uint64_t newest = m_writePos.load(std::memory_order_acquire);
+        if (newest == NullPos)
+            return false;
+        const std::uint64_t oldest = newest > Capacity ? newest - Capacity + 1 : 1;
+
+        // first position with a timestamp >= timestamp, overwritten positions are older than any held.
+        Snapshot snapshot;
+        std::uint64_t lo = oldest, hi = newest;
+        while (lo < hi) {
+            const std::uint64_t mid = lo + (hi - lo) / 2;
+            if (!TryReadPosition(mid, snapshot) || snapshot.timestamp < timestamp)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        bool found = false;
+        std::uint64_t bestDist = std::uint64_t(-1);
+        const std::uint64_t last = std::min(lo + NearestRadius, newest);
+        for (std::uint64_t pos = std::max(lo, oldest + NearestRadius) - NearestRadius; pos <= last; ++pos) {
+            if (!TryReadPosition(pos, snapshot))
+                continue;
+            const std::uint64_t dist = snapshot.timestamp > timestamp ?
+                snapshot.timestamp - timestamp : timestamp - snapshot.timestamp;
+            if (dist < bestDist) {
+                bestDist = dist;
+                out = snapshot.record;
+                found = true;
+            }
+        }
+        // everything searched was overwritten meanwhile (the reader was preempted for a whole ring).
+        return found || Latest(out);
+    }
+};
+
+}
+#endif
@@ -0,0 +1,123 @@
+#include "pch.h"
+#include "common.h"
+#include "tracking_thread.h"
+#include "logger.h"
+#include "openxr_program.h"
+#include "thread_policy.h"
+
+#include <chrono>
+#include <algorithm>
+#ifndef XR_USE_PLATFORM_WIN32
+#include <cerrno>
+#include <time.h>
+#endif
+
+namespace {
+
+inline void SleepUntil(const XrSteadyClock::time_point deadline)
+{
+	using namespace std::chrono;
+#ifdef XR_USE_PLATFORM_WIN32
+	// waitable timers are ~1ms granular at best, the remainder is spun.
+	constexpr const auto SpinThreshold = microseconds(1500);
+	if (deadline - XrSteadyClock::now() > SpinThreshold)
+		std::this_thread::sleep_until(deadline - SpinThreshold);
+	while (XrSteadyClock::now() < deadline)
+		std::this_thread::yield();
+#else
+	// steady_clock is CLOCK_MONOTONIC (libstdc++ & libc++), an absolute deadline does not drift
+	// with the time spent computing it.
+	const auto deadlineNs = duration_cast<nanoseconds>(deadline.time_since_epoch()).count();
+	const timespec ts{
+		.tv_sec  = static_cast<time_t>(deadlineNs / 1'000'000'000),
+		.tv_nsec = static_cast<long>(deadlineNs % 1'000'000'000)
+	};
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+#endif
+}
+
+inline std::uint64_t ToUs(const XrSteadyClock::duration d)
+{
+	using namespace std::chrono;
+	return d.count() > 0 ? static_cast<std::uint64_t>(duration_cast<microseconds>(d).count()) : 0;
+}
+
+}
+
+bool XrTrackingThread::Start(const XrTrackingThread::StartCtx& ctx)
+{
+	if (ctx.programPtr == nullptr || !ctx.sampleFn || ctx.samplesPerFrame == 0)
+		return false;
+	Stop();
+	Log::Write(Log::Level::Info, Fmt("Starting tracking thread, %u samples per display frame.", ctx.samplesPerFrame));
+	m_isRunningToken = true;
+	m_trackingThread = std::thread{ [this, ctx]() { Run(ctx); } };
+	return true;
+}
+
+void XrTrackingThread::Stop()
+{
+	if (!m_isRunningToken.exchange(false) && !m_trackingThread.joinable())
+		return;
+	Log::Write(Log::Level::Info, "Waiting for tracking thread to shutdown...");
+	if (m_trackingThread.joinable())
+		m_trackingThread.join();
+	Log::Write(Log::Level::Info, "Tracking thread finished shutdown");
+}
+
+void XrTrackingThread::Run(const StartCtx ctx)
+{
+	using namespace std::chrono;
+	using namespace std::literals::chrono_literals;
+	if (ctx.realtimePriority && !ALXR::SetCurrentThreadRealtimePriority())
+		Log::Write(Log::Level::Warning, "Failed to raise the tracking thread priority.");
+
+	IOpenXrProgram& program = *ctx.programPtr;
+	SamplingStats stats{};
+	XrSteadyClock::time_point lastDeadline{};
+	while (m_isRunningToken.load(std::memory_order_relaxed))
+	{
+		if (!program.IsSessionRunning()) {
+			std::this_thread::sleep_for(10ms);
+			continue;
+		}
+		const auto [displayTime, displayPeriod] = program.GetPredictedDisplayTiming();
+		const auto [xrTimeNow, timeStampUs] = program.XrTimeNow();
+		const auto steadyNow = XrSteadyClock::now();
+		if (xrTimeNow < 0 || timeStampUs == std::uint64_t(-1)) {
+			std::this_thread::sleep_for(10ms);
+			continue;
+		}
+
+		// the next sample time after now at a whole number of sample periods from a display time.
+		const std::int64_t framePeriodNs = displayPeriod > 0 ? displayPeriod : FallbackDisplayPeriodNs;
+		const std::int64_t samplePeriodNs = std::max<std::int64_t>(framePeriodNs / ctx.samplesPerFrame, 1);
+		const std::int64_t phaseNs = displayTime > 0 ? displayTime % samplePeriodNs : 0;
+		std::int64_t untilDeadlineNs = (phaseNs - xrTimeNow % samplePeriodNs) % samplePeriodNs;
+		if (untilDeadlineNs <= 0)
+			untilDeadlineNs += samplePeriodNs;
+		auto deadline = steadyNow + nanoseconds(untilDeadlineNs);
+		// xr & steady clocks are read microseconds apart, waking right on a deadline can map back to
+		// just before it, which is not a reason to sample twice.
+		if (deadline - lastDeadline < nanoseconds(samplePeriodNs / 2))
+			deadline += nanoseconds(samplePeriodNs);
+
+		SleepUntil(deadline);
+		if (!m_isRunningToken.load(std::memory_order_relaxed))
+			break;
+		const auto wakeTime = XrSteadyClock::now();
+		stats.wakeLateness.Add(ToUs(wakeTime - deadline));
+
+		ctx.sampleFn();
+
+		const auto sampleEnd = XrSteadyClock::now();
+		stats.sampleTime.Add(ToUs(sampleEnd - wakeTime));
+		if (sampleEnd - deadline >= nanoseconds(samplePeriodNs))
+			++stats.missedDeadlines;
+		lastDeadline = deadline;
+	}
+
+	Log::Write(Log::Level::Info, Fmt("Tracking thread wake-up lateness, %s", stats.wakeLateness.ToString().c_str()));
+	Log::Write(Log::Level::Info, Fmt("Tracking thread sample time, %s", stats.sampleTime.ToString().c_str()));
+	Log::Write(Log::Level::Info, Fmt("Tracking thread missed deadlines: %llu", stats.missedDeadlines));
+}
@@ -0,0 +1,58 @@
+#pragma once
+#ifndef ALXR_TRACKING_THREAD_H
+#define ALXR_TRACKING_THREAD_H
+
+#include <cstdint>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <functional>
+
+#include "timing.h"
+
+struct IOpenXrProgram;
+
+// Samples tracking on its own thread at a fixed multiple of the display refresh rate, with wake-ups
+// at absolute deadlines phase aligned to the runtime's predicted display times. Sampling jitter is
+// then set by the OS timer rather than by whichever thread/scheduler calls alxr_on_tracking_update.
+class XrTrackingThread {
+public:
+	using SampleFn = std::function<void()>;
+
+	inline XrTrackingThread() = default;
+
+	inline XrTrackingThread(const XrTrackingThread&) = delete;
+	inline XrTrackingThread& operator=(const XrTrackingThread&) = delete;
+
+	inline ~XrTrackingThread() {
+		Stop();
+	}
+
+	struct StartCtx {
+		using IOpenXrProgramPtr = std::shared_ptr<IOpenXrProgram>;
+
+		IOpenXrProgramPtr programPtr;
+		SampleFn		  sampleFn;
+		std::uint32_t	  samplesPerFrame;
+		bool			  realtimePriority;
+	};
+	bool Start(const StartCtx& ctx);
+	void Stop();
+
+	inline bool IsRunning() const { return m_isRunningToken.load(std::memory_order_relaxed); }
+
+private:
+	// until the runtime reports a display period, e.g. before the first xrWaitFrame.
+	constexpr static const std::int64_t FallbackDisplayPeriodNs = 11111111; // 90Hz
+
+	struct SamplingStats {
+		LatencyHistogramUs<> wakeLateness; // actual wake-up time past the deadline.
+		LatencyHistogramUs<> sampleTime;   // time spent in sampleFn.
+		std::uint64_t		 missedDeadlines = 0; // sampleFn overran one or more sample periods.
+	};
+	void Run(const StartCtx ctx);
+
+	std::atomic<bool> m_isRunningToken{ false };
+	std::thread		  m_trackingThread;
+};
+#endif
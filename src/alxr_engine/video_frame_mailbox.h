@@ -0,0 +1,96 @@
+#pragma once
+#ifndef ALXR_VIDEO_FRAME_MAILBOX_H
+#define ALXR_VIDEO_FRAME_MAILBOX_H
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <atomic>
+#include "latency_manager.h"
+
+namespace ALXR {
+
+// Hands decoded video frames from the decoder thread to the render thread with "latest frame wins"
+// semantics. Each of the SlotCount slots is in exactly one state, the decoder thread writes into a free
+// slot & publishes it as the newest ready frame, the render thread takes the newest ready frame in
+// BeginVideoView & keeps displaying it until a newer one arrives. With 3 slots (one displaying, one
+// ready, one being written) neither side ever waits on the other.
+//
+// A ready frame replaced before the render thread took it is counted as dropped, a render frame with no
+// new frame to take is counted as re-rendered, see LatencyManager::VideoFrameCounters.
+template < const std::size_t SlotCount >
+class VideoFrameMailbox {
+public:
+    static_assert(SlotCount >= 3, "needs a slot for each of writing, ready & displaying");
+    constexpr static const std::size_t NoSlot = std::size_t(-1);
+
+    enum class SlotState : std::uint32_t {
+        Free,      // owned by nobody, the decoder thread may take it.
+        Writing,   // decoder thread is filling it.
+        Ready,     // holds the newest decoded frame.
+        Displaying // sampled by the render thread.
+    };
+
+    // Decoder thread, returns NoSlot if every slot is in use (only possible if called again before Publish).
+    std::size_t AcquireWrite() {
+        for (std::size_t slotIndex = 0; slotIndex < SlotCount; ++slotIndex) {
+            auto expected = SlotState::Free;
+            if (m_states[slotIndex].compare_exchange_strong(expected, SlotState::Writing, std::memory_order_acq_rel))
+                return slotIndex;
+        }
+        return NoSlot;
+    }
+
+    // Decoder thread, gives back a slot acquired with AcquireWrite without publishing it.
+    void CancelWrite(const std::size_t slotIndex) {
+        m_states[slotIndex].store(SlotState::Free, std::memory_order_release);
+    }
+
+    // Decoder thread, makes slotIndex the newest ready frame, an older one not yet taken is recycled.
+    void Publish(const std::size_t slotIndex) {
+        m_states[slotIndex].store(SlotState::Ready, std::memory_order_release);
+        LatencyManager::Instance().OnVideoFrameDecoded();
+        // whoever exchanges a slot out of m_readySlot owns its next transition.
+        const std::size_t prevSlot = m_readySlot.exchange(slotIndex, std::memory_order_acq_rel);
+        if (prevSlot != NoSlot) {
+            m_states[prevSlot].store(SlotState::Free, std::memory_order_release);
+            LatencyManager::Instance().OnVideoFrameDropped();
+        }
+    }
+
+    // Render thread, swaps in the newest ready frame (if any), the previously displayed slot is freed.
+    // Returns false if there was no new frame, the displayed slot (if any) is shown again.
+    bool AcquireLatest() {
+        const std::size_t slotIndex = m_readySlot.exchange(NoSlot, std::memory_order_acq_rel);
+        if (slotIndex == NoSlot) {
+            if (m_displaySlot != NoSlot)
+                LatencyManager::Instance().OnVideoFrameReRendered();
+            return false;
+        }
+        m_states[slotIndex].store(SlotState::Displaying, std::memory_order_relaxed);
+        if (m_displaySlot != NoSlot)
+            m_states[m_displaySlot].store(SlotState::Free, std::memory_order_release);
+        m_displaySlot = slotIndex;
+        LatencyManager::Instance().OnVideoFrameDisplayed();
+        return true;
+    }
+
+    // Render thread, slot currently sampled or NoSlot if no frame has been displayed yet.
+    inline std::size_t DisplaySlot() const { return m_displaySlot; }
+
+    // Neither thread may hold a slot, e.g. the decoder is (re)creating video textures.
+    void Reset() {
+        for (auto& state : m_states)
+            state.store(SlotState::Free, std::memory_order_relaxed);
+        m_readySlot.store(NoSlot, std::memory_order_release);
+        m_displaySlot = NoSlot;
+    }
+
+private:
+    std::array<std::atomic<SlotState>, SlotCount> m_states{};
+    std::atomic<std::size_t>                      m_readySlot{ NoSlot };
+    std::size_t                                   m_displaySlot{ NoSlot }; // render thread owned.
+};
+
+}
+#endif
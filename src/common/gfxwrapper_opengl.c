@@ -425,7 +425,7 @@ GLint glGetInteger(GLenum pname) {
     return i;
 }
 
-static bool GlCheckExtension(const char *extension) {
+bool GlCheckExtension(const char *extension) {
 #if defined(OS_WINDOWS) || defined(OS_LINUX)
     PFNGLGETSTRINGIPROC glGetStringi = (PFNGLGETSTRINGIPROC)GetExtension("glGetStringi");
 #endif
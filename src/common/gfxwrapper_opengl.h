@@ -439,6 +439,7 @@ Common defines
 #endif
 
 void GlInitExtensions();
+bool GlCheckExtension(const char *extension);
 
 /*
 ================================================================================================================================
@@ -0,0 +1,55 @@
+#include "pch.h"
+#include "common.h"
+#include "benchmarks.h"
+#include "action_polling_reference.h"
+
+#include <chrono>
+#include <vector>
+
+namespace ALXR {
+
+void BenchmarkActionPolling(const std::size_t iterations)
+{
+    if (iterations == 0)
+        return;
+    using Dispatch = MockActionStateDispatch;
+    const ActionTable::SubactionPathList subactionPaths{ 1, 2 };
+
+    const ActionMapLookup mapLookup{ MakeMockAction };
+    std::vector<ActionTable> actionTables(InteractionProfileMap.size());
+    for (std::size_t i = 0; i < actionTables.size(); ++i)
+        actionTables[i].Compile(InteractionProfileMap[i], subactionPaths, MakeMockAction);
+
+    using namespace std::chrono;
+    // unbound: none, then every bool & scalar to bool action (e.g. hand tracking, which only binds values).
+    for (const std::uint64_t unboundMask : { std::uint64_t(0), ActionKindBit(ActionKind::Bool) | ActionKindBit(ActionKind::ScalarToBool) }) {
+        Dispatch::unboundMask = unboundMask;
+        const auto measure = [&](const char* name, auto&& poll) {
+            std::uint64_t buttons = 0;
+            std::size_t queryCount = 0;
+            const auto start = steady_clock::now();
+            for (std::size_t i = 0; i < iterations; ++i) {
+                Dispatch::syncCount = i;
+                for (std::size_t profileIndex = 0; profileIndex < InteractionProfileMap.size(); ++profileIndex) {
+                    ActionTable::ControllerInfoList controllerInfoList{};
+                    queryCount += poll(profileIndex, controllerInfoList);
+                    buttons += controllerInfoList[0].buttons + controllerInfoList[1].buttons;
+                }
+            }
+            const double polls = double(iterations * InteractionProfileMap.size());
+            const double ns = double(duration_cast<nanoseconds>(steady_clock::now() - start).count());
+            Log::Write(Log::Level::Info, Fmt("Action polling benchmark %-12s (%s): %7.1f ns/poll, %5.1f queries/poll (%llx)",
+                name, unboundMask == 0 ? "all bound" : "buttons unbound", ns / polls, queryCount / polls, buttons));
+        };
+        for (auto& actionTable : actionTables)
+            actionTable.ResetDormancy();
+        measure("map lookup", [&](const std::size_t profileIndex, ActionTable::ControllerInfoList& controllerInfoList) {
+            return mapLookup.Poll<Dispatch>(InteractionProfileMap[profileIndex], subactionPaths, controllerInfoList);
+        });
+        measure("action table", [&](const std::size_t profileIndex, ActionTable::ControllerInfoList& controllerInfoList) {
+            return actionTables[profileIndex].Poll<Dispatch>(XR_NULL_HANDLE, controllerInfoList);
+        });
+    }
+}
+
+}
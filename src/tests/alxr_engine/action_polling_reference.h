@@ -0,0 +1,147 @@
+#pragma once
+#ifndef ALXR_ACTION_POLLING_REFERENCE_H
+#define ALXR_ACTION_POLLING_REFERENCE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <array>
+#include <unordered_map>
+
+#include "action_table.h"
+
+namespace ALXR {
+
+// Action handles are made up for the mock runtime, the kind is a one-hot bit above the input so every
+// action of a set of kinds can be unbound with a mask.
+constexpr inline std::uint64_t ActionKindBit(const ActionKind kind) {
+    return std::uint64_t(1) << (8 + std::size_t(kind));
+}
+
+inline std::uint64_t ToHandleValue(const XrAction action) {
+    std::uint64_t value = 0;
+    std::memcpy(&value, &action, sizeof(action));
+    return value;
+}
+
+inline XrAction ToAction(const std::uint64_t value) {
+    XrAction action{ XR_NULL_HANDLE };
+    std::memcpy(&action, &value, sizeof(action));
+    return action;
+}
+
+inline XrAction MakeMockAction(const ActionKind kind, const ALVR_INPUT input) {
+    return ToAction(ActionKindBit(kind) | std::uint64_t(input));
+}
+
+// The state of an action is derived from its handle & the sync count, actions with any unboundMask bit set
+// are inactive.
+struct MockActionStateDispatch {
+    static inline std::uint64_t unboundMask = 0;
+    static inline std::uint64_t syncCount = 0;
+
+    static inline bool IsBound(const XrAction action) {
+        return (ToHandleValue(action) & unboundMask) == 0;
+    }
+    static XrResult GetBoolean(XrSession, const XrActionStateGetInfo* getInfo, XrActionStateBoolean* state) {
+        const bool isBound = IsBound(getInfo->action);
+        state->isActive = isBound;
+        state->currentState = isBound && ((ToHandleValue(getInfo->action) + syncCount) & 7) == 0;
+        state->changedSinceLastSync = XR_FALSE;
+        return XR_SUCCESS;
+    }
+    static XrResult GetFloat(XrSession, const XrActionStateGetInfo* getInfo, XrActionStateFloat* state) {
+        state->isActive = IsBound(getInfo->action);
+        state->currentState = state->isActive ? float((ToHandleValue(getInfo->action) + syncCount) & 0xFF) / 255.0f : 0.0f;
+        state->changedSinceLastSync = state->isActive;
+        return XR_SUCCESS;
+    }
+    static XrResult GetVector2f(XrSession, const XrActionStateGetInfo* getInfo, XrActionStateVector2f* state) {
+        state->isActive = IsBound(getInfo->action);
+        state->currentState = { float(syncCount & 0xFF) / 255.0f, 0.5f };
+        state->changedSinceLastSync = state->isActive;
+        return XR_SUCCESS;
+    }
+};
+
+// What InteractionManager::PollActions did before ActionTable, a map lookup per input of the active profile.
+class ActionMapLookup {
+public:
+    using ControllerInfo     = ActionTable::ControllerInfo;
+    using ControllerInfoList = ActionTable::ControllerInfoList;
+    using SubactionPathList  = ActionTable::SubactionPathList;
+
+    explicit ActionMapLookup(const ActionTable::LookupActionFn& lookupAction) {
+        for (const auto& profile : InteractionProfileMap) {
+            for (const auto kind : ActionKinds) {
+                for (const auto& inputMap : GetInputMap(profile, kind)) {
+                    for (const auto& buttonMap : inputMap) {
+                        if (buttonMap == MapEnd)
+                            break;
+                        const XrAction action = lookupAction(kind, buttonMap.button);
+                        if (action != XR_NULL_HANDLE)
+                            m_actionMaps[std::size_t(kind)].emplace(buttonMap.button, action);
+                    }
+                }
+            }
+        }
+    }
+
+    // Returns the number of state queries made.
+    template < typename Dispatch >
+    std::size_t Poll(const InteractionProfile& profile, const SubactionPathList& subactionPaths, ControllerInfoList& controllerInfoList) const {
+        std::size_t queryCount = 0;
+        for (std::size_t hand = 0; hand < HandSize; ++hand) {
+            auto& controllerInfo = controllerInfoList[hand];
+            XrActionStateGetInfo getInfo{ .type = XR_TYPE_ACTION_STATE_GET_INFO, .next = nullptr, .action = XR_NULL_HANDLE, .subactionPath = subactionPaths[hand] };
+            for (const auto kind : ActionKinds) {
+                const auto& actionMap = m_actionMaps[std::size_t(kind)];
+                for (const auto& buttonMap : GetInputMap(profile, kind)[hand]) {
+                    if (buttonMap == MapEnd)
+                        break;
+                    const auto actionItr = actionMap.find(buttonMap.button);
+                    if (actionItr == actionMap.end())
+                        continue;
+                    getInfo.action = actionItr->second;
+                    ++queryCount;
+                    if (kind == ActionKind::Scalar) {
+                        XrActionStateFloat floatValue{ .type = XR_TYPE_ACTION_STATE_FLOAT, .next = nullptr, .isActive = XR_FALSE };
+                        if (XR_FAILED(Dispatch::GetFloat(XR_NULL_HANDLE, &getInfo, &floatValue)) || floatValue.isActive == XR_FALSE)
+                            continue;
+                        *GetValuePtr(controllerInfo, GetValueOffset(kind, buttonMap.button)) = floatValue.currentState;
+                        controllerInfo.enabled = true;
+                    } else if (kind == ActionKind::Vector2f) {
+                        XrActionStateVector2f vec2Value{ .type = XR_TYPE_ACTION_STATE_VECTOR2F, .next = nullptr, .isActive = XR_FALSE };
+                        if (XR_FAILED(Dispatch::GetVector2f(XR_NULL_HANDLE, &getInfo, &vec2Value)) || vec2Value.isActive == XR_FALSE)
+                            continue;
+                        controllerInfo.trackpadPosition.x = vec2Value.currentState.x;
+                        controllerInfo.trackpadPosition.y = vec2Value.currentState.y;
+                        controllerInfo.enabled = true;
+                    } else {
+                        XrActionStateBoolean boolValue{ .type = XR_TYPE_ACTION_STATE_BOOLEAN, .next = nullptr, .isActive = XR_FALSE };
+                        if (XR_FAILED(Dispatch::GetBoolean(XR_NULL_HANDLE, &getInfo, &boolValue)) ||
+                            boolValue.isActive == XR_FALSE || boolValue.currentState == XR_FALSE)
+                            continue;
+                        if (kind == ActionKind::BoolToScalar) {
+                            *GetValuePtr(controllerInfo, GetValueOffset(kind, buttonMap.button)) = 1.0f;
+                            controllerInfo.enabled = true;
+                        } else
+                            controllerInfo.buttons |= ALVR_BUTTON_FLAG(buttonMap.button);
+                    }
+                }
+            }
+        }
+        return queryCount;
+    }
+
+private:
+    static inline float* GetValuePtr(ControllerInfo& controllerInfo, const std::uint16_t valueOffset) {
+        return reinterpret_cast<float*>(reinterpret_cast<std::uint8_t*>(&controllerInfo) + valueOffset);
+    }
+
+    using ActionMap = std::unordered_map<ALVR_INPUT, XrAction>;
+    std::array<ActionMap, ActionKinds.size()> m_actionMaps;
+};
+
+}
+#endif
@@ -0,0 +1,78 @@
+#include "pch.h"
+#include "common.h"
+#include "check.h"
+#include "tests.h"
+#include "action_polling_reference.h"
+
+#include <vector>
+
+namespace ALXR {
+namespace {
+
+using Dispatch = MockActionStateDispatch;
+const ActionTable::SubactionPathList SubactionPaths{ 1, 2 };
+
+inline bool IsSameControllerInfo(const ActionTable::ControllerInfo& a, const ActionTable::ControllerInfo& b) {
+    return a.enabled == b.enabled && a.buttons == b.buttons &&
+        a.trackpadPosition.x == b.trackpadPosition.x && a.trackpadPosition.y == b.trackpadPosition.y &&
+        a.triggerValue == b.triggerValue && a.gripValue == b.gripValue;
+}
+
+// Polls every profile through both paths for pollCount syncs from firstSync, checkFromPoll skips the
+// comparison of the first polls (e.g. while dormant actions are being probed again).
+void ComparePolls
+(
+    const ActionMapLookup& mapLookup, std::vector<ActionTable>& actionTables, const char* what,
+    const std::uint64_t firstSync, const std::size_t pollCount, const std::size_t checkFromPoll = 0
+)
+{
+    for (std::size_t poll = 0; poll < pollCount; ++poll) {
+        Dispatch::syncCount = firstSync + poll;
+        for (std::size_t profileIndex = 0; profileIndex < InteractionProfileMap.size(); ++profileIndex) {
+            ActionTable::ControllerInfoList expected{}, actual{};
+            mapLookup.Poll<Dispatch>(InteractionProfileMap[profileIndex], SubactionPaths, expected);
+            actionTables[profileIndex].Poll<Dispatch>(XR_NULL_HANDLE, actual);
+            if (poll < checkFromPoll)
+                continue;
+            for (std::size_t hand = 0; hand < HandSize; ++hand) {
+                CHECK_MSG(IsSameControllerInfo(expected[hand], actual[hand]),
+                    Fmt("%s: profile %s hand %zu differs on poll %zu (buttons %llx vs %llx)", what,
+                        InteractionProfileMap[profileIndex].path, hand, poll,
+                        static_cast<unsigned long long>(expected[hand].buttons),
+                        static_cast<unsigned long long>(actual[hand].buttons)));
+            }
+        }
+    }
+}
+
+void CompareAllProfiles(const ActionTable::LookupActionFn& lookupAction, const char* what)
+{
+    const ActionMapLookup mapLookup{ lookupAction };
+    std::vector<ActionTable> actionTables(InteractionProfileMap.size());
+    for (std::size_t i = 0; i < actionTables.size(); ++i)
+        actionTables[i].Compile(InteractionProfileMap[i], SubactionPaths, lookupAction);
+
+    // long enough for the unbound actions to go dormant.
+    const std::size_t pollCount = ActionTable::DormantAfterPolls + 4 * ActionTable::DormantProbeInterval;
+    Dispatch::unboundMask = 0;
+    ComparePolls(mapLookup, actionTables, what, 0, pollCount);
+    Dispatch::unboundMask = ActionKindBit(ActionKind::Bool) | ActionKindBit(ActionKind::ScalarToBool);
+    ComparePolls(mapLookup, actionTables, what, pollCount, pollCount);
+    // rebound without a ResetDormancy, every dormant action is probed within DormantProbeInterval polls.
+    Dispatch::unboundMask = 0;
+    ComparePolls(mapLookup, actionTables, what, 2 * pollCount, 2 * ActionTable::DormantProbeInterval, ActionTable::DormantProbeInterval);
+    Dispatch::unboundMask = 0;
+}
+
+}
+
+void TestActionTable()
+{
+    CompareAllProfiles(MakeMockAction, "all actions");
+    // inputs the engine has no action for are skipped by both.
+    CompareAllProfiles([](const ActionKind kind, const ALVR_INPUT input) {
+        return (std::size_t(input) + std::size_t(kind)) % 3 == 0 ? XR_NULL_HANDLE : MakeMockAction(kind, input);
+    }, "missing actions");
+}
+
+}
@@ -0,0 +1,56 @@
+#include "pch.h"
+#include "common.h"
+#include "benchmarks.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+// run returns false if the benchmarked code produced wrong results.
+struct Benchmark {
+    const char* name;
+    bool (*run)(const std::size_t scale);
+};
+constexpr const Benchmark Benchmarks[] = {
+    { "concurrent_queue", [](const std::size_t scale) { ALXR::BenchmarkConcurrentQueue(1000000 * scale); return true; } },
+    { "plane_copy",       [](const std::size_t scale) { return ALXR::BenchmarkPlaneCopy(100 * scale); } },
+    { "nal_parser",       [](const std::size_t scale) { ALXR::BenchmarkNALParser(std::size_t(4) << 20, 50 * scale); return true; } },
+    { "action_polling",   [](const std::size_t scale) { ALXR::BenchmarkActionPolling(20000 * scale); return true; } },
+    { "hand_skeleton",    [](const std::size_t scale) { ALXR::BenchmarkHandSkeleton(2000 * scale); return true; } },
+};
+
+}
+
+// alxr_engine_benchmarks [--scale N] [name...], runs every benchmark when no names are given.
+int main(int argc, char* argv[])
+{
+    std::size_t scale = 1;
+    std::vector<const char*> names;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--scale") == 0 && i + 1 < argc)
+            scale = std::max<std::size_t>(std::strtoul(argv[++i], nullptr, 10), 1);
+        else
+            names.push_back(argv[i]);
+    }
+
+    int result = EXIT_SUCCESS;
+    for (const char* const name : names) {
+        const bool isKnown = std::any_of(std::begin(Benchmarks), std::end(Benchmarks),
+            [name](const Benchmark& benchmark) { return std::strcmp(benchmark.name, name) == 0; });
+        if (!isKnown) {
+            Log::Write(Log::Level::Error, Fmt("Unknown benchmark \"%s\"", name));
+            result = EXIT_FAILURE;
+        }
+    }
+    for (const auto& benchmark : Benchmarks) {
+        const bool isSelected = names.empty() || std::any_of(names.begin(), names.end(),
+            [&benchmark](const char* const name) { return std::strcmp(benchmark.name, name) == 0; });
+        if (isSelected && !benchmark.run(scale)) {
+            Log::Write(Log::Level::Error, Fmt("Benchmark %s produced wrong results", benchmark.name));
+            result = EXIT_FAILURE;
+        }
+    }
+    Log::Flush();
+    return result;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#ifndef ALXR_BENCHMARKS_H
+#define ALXR_BENCHMARKS_H
+
+#include <cstddef>
+
+namespace ALXR {
+
+// Logs the throughput & failed pops of 1, 2 & 4 producers pushing itemsPerProducer values each to a single
+// consumer, through the mutex queue concurrent_queue used to be vs mpsc_queue (& spsc_queue).
+void BenchmarkConcurrentQueue(const std::size_t itemsPerProducer);
+
+// Logs the throughput of copying pitched NV12 frames row by row with memcpy vs CopyPlane2D vs PlaneCopier,
+// for a frame below & above PlaneCopier::MinParallelBytes. False if any copy did not match its source.
+bool BenchmarkPlaneCopy(const std::size_t iterations);
+
+// Logs start code scan & ParseNALFrame throughput, SIMD vs scalar, over a synthetic HEVC frame of
+// frameSize bytes (parameter sets, SEI & slice NAL units filled with emulation-prevented noise).
+void BenchmarkNALParser(const std::size_t frameSize, const std::size_t iterations);
+
+// Logs the cost of polling every InteractionProfile's actions through per-button map lookups vs an
+// ActionTable, against a mock runtime.
+void BenchmarkActionPolling(const std::size_t iterations);
+
+// Logs the cost per hand of LoadHandJoints & ToHandSkeleton vs the 4x4 matrix xr_linear path over random hands.
+void BenchmarkHandSkeleton(const std::size_t iterations);
+
+}
+#endif
@@ -0,0 +1,119 @@
+#include "pch.h"
+#include "common.h"
+#include "benchmarks.h"
+#include "concurrent_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <queue>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+namespace ALXR {
+namespace {
+
+// What xrconcurrency::concurrent_queue was on non-msvc platforms before the lock-free rings, try_pop
+// fails when the lock is contended even if the queue is not empty.
+template < typename Tp >
+class LockedQueue {
+public:
+    bool push(const Tp& x) {
+        std::unique_lock lock(m_mutex);
+        m_queue.push(x);
+        return true;
+    }
+    bool try_pop(Tp& x) {
+        std::unique_lock lock(m_mutex, std::try_to_lock);
+        if (!lock.owns_lock() || m_queue.empty())
+            return false;
+        x = std::move(m_queue.front());
+        m_queue.pop();
+        return true;
+    }
+private:
+    std::shared_mutex m_mutex;
+    std::queue<Tp, std::deque<Tp>> m_queue;
+};
+
+struct QueueRunStats {
+    double        nsPerItem;
+    std::uint64_t failedPops; // try_pop calls that returned nothing.
+    bool          isValid;    // the values of each producer were popped in the order they were pushed.
+};
+
+// producerCount threads push itemsPerProducer values each (retrying while the queue is full) while the
+// calling thread pops them all, yielding whenever either side finds the queue full or empty.
+template < typename Queue >
+QueueRunStats RunQueue(Queue& queue, const std::size_t producerCount, const std::size_t itemsPerProducer) {
+    std::atomic<bool> start{ false };
+    std::vector<std::thread> producers;
+    producers.reserve(producerCount);
+    for (std::size_t producer = 0; producer < producerCount; ++producer) {
+        producers.emplace_back([&, producer]() {
+            while (!start.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            for (std::size_t i = 0; i < itemsPerProducer; ++i) {
+                const std::uint64_t value = (std::uint64_t(producer) << 32) | i;
+                while (!queue.push(value))
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    using namespace std::chrono;
+    const std::size_t itemCount = producerCount * itemsPerProducer;
+    std::vector<std::size_t> nextIndex(producerCount, 0);
+    QueueRunStats stats{ .nsPerItem = 0, .failedPops = 0, .isValid = true };
+    const auto startTime = steady_clock::now();
+    start.store(true, std::memory_order_release);
+    std::uint64_t value = 0;
+    for (std::size_t popped = 0; popped < itemCount;) {
+        if (!queue.try_pop(value)) {
+            ++stats.failedPops;
+            std::this_thread::yield();
+            continue;
+        }
+        // values of each producer arrive in the order they were pushed.
+        auto& expectedIndex = nextIndex[value >> 32];
+        stats.isValid &= (value & 0xFFFFFFFF) == expectedIndex;
+        ++expectedIndex;
+        ++popped;
+    }
+    stats.nsPerItem = double(duration_cast<nanoseconds>(steady_clock::now() - startTime).count()) / itemCount;
+    for (auto& producer : producers)
+        producer.join();
+    return stats;
+}
+
+}
+
+void BenchmarkConcurrentQueue(const std::size_t itemsPerProducer)
+{
+    if (itemsPerProducer == 0)
+        return;
+    const auto logRun = [](const char* name, const std::size_t producerCount, const QueueRunStats& stats) {
+        Log::Write(Log::Level::Info, Fmt("Queue benchmark %-12s %zu producer(s): %7.1f ns/item, %10llu failed pops%s",
+            name, producerCount, stats.nsPerItem, static_cast<unsigned long long>(stats.failedPops),
+            stats.isValid ? "" : " (OUT OF ORDER)"));
+    };
+    constexpr const std::size_t Capacity = 1024;
+    for (const std::size_t producerCount : { std::size_t(1), std::size_t(2), std::size_t(4) }) {
+        {
+            LockedQueue<std::uint64_t> queue;
+            logRun("mutex", producerCount, RunQueue(queue, producerCount, itemsPerProducer));
+        }
+        {
+            auto queue = std::make_unique<xrconcurrency::mpsc_queue<std::uint64_t, Capacity>>();
+            logRun("mpsc_queue", producerCount, RunQueue(*queue, producerCount, itemsPerProducer));
+        }
+        if (producerCount == 1) {
+            auto queue = std::make_unique<xrconcurrency::spsc_queue<std::uint64_t, Capacity>>();
+            logRun("spsc_queue", producerCount, RunQueue(*queue, producerCount, itemsPerProducer));
+        }
+    }
+}
+
+}
@@ -0,0 +1,46 @@
+#include "pch.h"
+#include "common.h"
+#include "benchmarks.h"
+#include "hand_skeleton_reference.h"
+
+#include <cmath>
+#include <chrono>
+#include <utility>
+
+namespace ALXR {
+
+void BenchmarkHandSkeleton(const std::size_t iterations)
+{
+    if (iterations == 0)
+        return;
+    constexpr const std::size_t BoneCount = ALVR_HAND::alvrHandBone_MaxSkinnable;
+    const auto hands = MakeRandomHands(64, 0x414C5852);
+    const auto baseOrientations = MakeHandBaseOrientations();
+
+    using namespace std::chrono;
+    HandJoints joints;
+    const auto measure = [&](auto&& convert) {
+        float checksum = 0.0f;
+        const auto start = steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i) {
+            for (std::size_t handIndex = 0; handIndex < hands.size(); ++handIndex) {
+                TrackingInfo::Controller controller;
+                convert(hands[handIndex], handIndex & 1, controller);
+                checksum += std::abs(controller.boneRotations[BoneCount - 1].w) + controller.bonePositionsBase[BoneCount - 1].x;
+            }
+        }
+        const double ns = double(duration_cast<nanoseconds>(steady_clock::now() - start).count());
+        return std::make_pair(ns / double(iterations * hands.size()), checksum);
+    };
+    const auto [matrixNs, matrixChecksum] = measure([&](const HandJointLocationList& hand, const std::size_t side, TrackingInfo::Controller& controller) {
+        ToHandSkeletonMatrix(hand, baseOrientations.matrices[side], controller);
+    });
+    const auto [soaNs, soaChecksum] = measure([&](const HandJointLocationList& hand, const std::size_t side, TrackingInfo::Controller& controller) {
+        LoadHandJoints(hand, baseOrientations.quaternions[side], joints);
+        ToHandSkeleton(joints, controller);
+    });
+    Log::Write(Log::Level::Info, Fmt("Hand skeleton benchmark: 4x4 matrix %.1f ns/hand, SoA quaternion %.1f ns/hand (%.3f, %.3f)",
+        matrixNs, soaNs, matrixChecksum, soaChecksum));
+}
+
+}
@@ -0,0 +1,96 @@
+#include "pch.h"
+#include "common.h"
+#include "hand_skeleton_reference.h"
+
+#include <cmath>
+#include <random>
+
+namespace ALXR {
+namespace {
+
+constexpr const std::size_t BoneCount = ALVR_HAND::alvrHandBone_MaxSkinnable;
+
+constexpr inline bool IsPoseValid(const XrHandJointLocationEXT& jointLocation) {
+    constexpr const XrSpaceLocationFlags PoseValidFlags = XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_VALID_BIT;
+    return (jointLocation.locationFlags & PoseValidFlags) == PoseValidFlags;
+}
+
+}
+
+void ToHandSkeletonMatrix(const HandJointLocations& jointLocations, const XrMatrix4x4f& baseOrientation, /*[out]*/ TrackingInfo::Controller& controller)
+{
+    constexpr const XrVector3f UnitScale{ 1.0f, 1.0f, 1.0f };
+    std::array<XrMatrix4x4f, XR_HAND_JOINT_COUNT_EXT> orientedJointPoses;
+    for (std::size_t jointIdx = 0; jointIdx < XR_HAND_JOINT_COUNT_EXT; ++jointIdx) {
+        const auto& jointLoc = jointLocations[jointIdx];
+        XrMatrix4x4f& jointMatFixed = orientedJointPoses[jointIdx];
+        XrMatrix4x4f_CreateIdentity(&jointMatFixed);
+        if (!IsPoseValid(jointLoc))
+            continue;
+        XrMatrix4x4f jointMat;
+        XrMatrix4x4f_CreateTranslationRotationScale(&jointMat, &jointLoc.pose.position, &jointLoc.pose.orientation, &UnitScale);
+        XrMatrix4x4f_Multiply(&jointMatFixed, &jointMat, &baseOrientation);
+    }
+    for (std::size_t boneIndex = 0; boneIndex < BoneCount; ++boneIndex) {
+        auto& boneRot = controller.boneRotations[boneIndex];
+        auto& bonePos = controller.bonePositionsBase[boneIndex];
+        boneRot = { 0,0,0,1 };
+        bonePos = { 0,0,0 };
+        const auto xrJoint = ToXRHandJointType(static_cast<ALVR_HAND>(boneIndex));
+        if (xrJoint == XR_HAND_JOINT_MAX_ENUM_EXT)
+            continue;
+        XrMatrix4x4f jointLocal, jointParentInv;
+        XrMatrix4x4f_InvertRigidBody(&jointParentInv, &orientedJointPoses[GetJointParent(xrJoint)]);
+        XrMatrix4x4f_Multiply(&jointLocal, &jointParentInv, &orientedJointPoses[xrJoint]);
+        XrQuaternionf localizedRot;
+        XrVector3f localizedPos;
+        XrMatrix4x4f_GetRotation(&localizedRot, &jointLocal);
+        XrMatrix4x4f_GetTranslation(&localizedPos, &jointLocal);
+        boneRot = { localizedRot.x, localizedRot.y, localizedRot.z, localizedRot.w };
+        bonePos = { localizedPos.x, localizedPos.y, localizedPos.z };
+    }
+    const XrMatrix4x4f& palmMat = orientedJointPoses[XR_HAND_JOINT_PALM_EXT];
+    XrQuaternionf palmRot;
+    XrVector3f palmPos;
+    XrMatrix4x4f_GetTranslation(&palmPos, &palmMat);
+    XrMatrix4x4f_GetRotation(&palmRot, &palmMat);
+    controller.boneRootPosition = { palmPos.x, palmPos.y, palmPos.z };
+    controller.boneRootOrientation = { palmRot.x, palmRot.y, palmRot.z, palmRot.w };
+}
+
+HandBaseOrientations MakeHandBaseOrientations()
+{
+    // as OpenXrProgram::InitializeHandTrackers.
+    HandBaseOrientations result;
+    XrMatrix4x4f zRot;
+    XrMatrix4x4f_CreateRotation(&result.matrices[1], 0.0, -90.0f, 0.0f);
+    XrMatrix4x4f_CreateRotation(&zRot, 0.0, 0.0f, 180.0f);
+    XrMatrix4x4f_Multiply(&result.matrices[0], &result.matrices[1], &zRot);
+    for (std::size_t i = 0; i < result.matrices.size(); ++i)
+        XrMatrix4x4f_GetRotation(&result.quaternions[i], &result.matrices[i]);
+    return result;
+}
+
+std::vector<HandJointLocationList> MakeRandomHands(const std::size_t handCount, const std::uint32_t seed)
+{
+    std::vector<HandJointLocationList> hands(handCount);
+    std::mt19937 rng{ seed };
+    std::normal_distribution<float> normal{ 0.0f, 1.0f };
+    std::uniform_real_distribution<float> position{ -0.5f, 0.5f };
+    for (std::size_t handIndex = 0; handIndex < hands.size(); ++handIndex) {
+        for (std::size_t joint = 0; joint < XR_HAND_JOINT_COUNT_EXT; ++joint) {
+            XrQuaternionf q{ normal(rng), normal(rng), normal(rng), normal(rng) };
+            const float rcpLength = 1.0f / std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+            q = { q.x * rcpLength, q.y * rcpLength, q.z * rcpLength, q.w * rcpLength };
+            const bool isTracked = handIndex % 8 != 0 || joint % 5 != 0;
+            hands[handIndex][joint] = {
+                .locationFlags = isTracked ? XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_VALID_BIT : XrSpaceLocationFlags(0),
+                .pose = { q, { position(rng), position(rng), position(rng) } },
+                .radius = 0.01f
+            };
+        }
+    }
+    return hands;
+}
+
+}
@@ -0,0 +1,33 @@
+#pragma once
+#ifndef ALXR_HAND_SKELETON_REFERENCE_H
+#define ALXR_HAND_SKELETON_REFERENCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <vector>
+
+#include <common/xr_linear.h>
+#include "hand_skeleton.h"
+
+namespace ALXR {
+
+using HandJointLocationList = std::array<XrHandJointLocationEXT, XR_HAND_JOINT_COUNT_EXT>;
+
+// What PollHandTrackers did with xr_linear before ToHandSkeleton, a joint to world 4x4 matrix per joint &
+// a parent inverse, product & rotation extraction per bone.
+void ToHandSkeletonMatrix(const HandJointLocations& jointLocations, const XrMatrix4x4f& baseOrientation, /*[out]*/ TrackingInfo::Controller& controller);
+
+// The hand trackers' base orientations (left, right), as matrices & as quaternions.
+struct HandBaseOrientations {
+    std::array<XrMatrix4x4f, 2>  matrices;
+    std::array<XrQuaternionf, 2> quaternions;
+};
+HandBaseOrientations MakeHandBaseOrientations();
+
+// Joint poses with random unit orientations & positions within half a meter, every 8th hand has every 5th
+// joint untracked.
+std::vector<HandJointLocationList> MakeRandomHands(const std::size_t handCount, const std::uint32_t seed);
+
+}
+#endif
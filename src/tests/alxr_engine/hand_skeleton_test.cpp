@@ -0,0 +1,60 @@
+#include "pch.h"
+#include "common.h"
+#include "check.h"
+#include "tests.h"
+#include "hand_skeleton_reference.h"
+
+#include <cmath>
+
+namespace ALXR {
+namespace {
+
+// metres & quaternion components, both paths round differently in single precision.
+constexpr const float PositionTolerance = 1e-5f;
+constexpr const float RotationTolerance = 1e-5f;
+
+inline float PositionError(const TrackingVector3& a, const TrackingVector3& b) {
+    return std::max({ std::abs(a.x - b.x), std::abs(a.y - b.y), std::abs(a.z - b.z) });
+}
+
+// q & -q are the same rotation, xr_linear's matrix to quaternion conversion picks either sign.
+inline float RotationError(const TrackingQuat& a, const TrackingQuat& b) {
+    const float difference = std::max({ std::abs(a.x - b.x), std::abs(a.y - b.y), std::abs(a.z - b.z), std::abs(a.w - b.w) });
+    const float sum = std::max({ std::abs(a.x + b.x), std::abs(a.y + b.y), std::abs(a.z + b.z), std::abs(a.w + b.w) });
+    return std::min(difference, sum);
+}
+
+}
+
+void TestHandSkeleton()
+{
+    constexpr const std::size_t BoneCount = ALVR_HAND::alvrHandBone_MaxSkinnable;
+    const auto hands = MakeRandomHands(256, 0x414C5852);
+    const auto baseOrientations = MakeHandBaseOrientations();
+
+    HandJoints joints;
+    for (std::size_t handIndex = 0; handIndex < hands.size(); ++handIndex) {
+        for (std::size_t side = 0; side < 2; ++side) {
+            TrackingInfo::Controller expected{}, actual{};
+            ToHandSkeletonMatrix(hands[handIndex], baseOrientations.matrices[side], expected);
+            LoadHandJoints(hands[handIndex], baseOrientations.quaternions[side], joints);
+            ToHandSkeleton(joints, actual);
+
+            const auto where = [&](const char* what, const std::size_t bone, const float error) {
+                return Fmt("hand %zu side %zu %s %zu off by %g", handIndex, side, what, bone, error);
+            };
+            for (std::size_t bone = 0; bone < BoneCount; ++bone) {
+                const float positionError = PositionError(expected.bonePositionsBase[bone], actual.bonePositionsBase[bone]);
+                CHECK_MSG(positionError <= PositionTolerance, where("bone position", bone, positionError));
+                const float rotationError = RotationError(expected.boneRotations[bone], actual.boneRotations[bone]);
+                CHECK_MSG(rotationError <= RotationTolerance, where("bone rotation", bone, rotationError));
+            }
+            const float rootPositionError = PositionError(expected.boneRootPosition, actual.boneRootPosition);
+            CHECK_MSG(rootPositionError <= PositionTolerance, where("root position", 0, rootPositionError));
+            const float rootRotationError = RotationError(expected.boneRootOrientation, actual.boneRootOrientation);
+            CHECK_MSG(rootRotationError <= RotationTolerance, where("root orientation", 0, rootRotationError));
+        }
+    }
+}
+
+}
@@ -0,0 +1,69 @@
+#include "pch.h"
+#include "common.h"
+#include "benchmarks.h"
+#include "nal_parser.h"
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+namespace ALXR {
+
+void BenchmarkNALParser(const std::size_t frameSize, const std::size_t iterations)
+{
+    if (frameSize < 1024 || iterations == 0)
+        return;
+    // VPS, SPS, PPS, prefix SEI then IDR slices of up to 256KB, payloads are random bytes with
+    // emulation prevention applied so the only start codes are the NAL unit boundaries.
+    constexpr const std::uint8_t StartCode[] = { 0x00, 0x00, 0x00, 0x01 };
+    std::vector<std::uint8_t> frame;
+    frame.reserve(frameSize + 64);
+    std::mt19937 rng{ 0x414C5852 };
+    const auto appendNAL = [&](const std::uint8_t type, const std::size_t payloadSize) {
+        frame.insert(frame.end(), std::begin(StartCode), std::end(StartCode));
+        frame.push_back(static_cast<std::uint8_t>(type << 1));
+        frame.push_back(0x01);
+        std::uint32_t zeroCount = 0;
+        for (std::size_t i = 0; i < payloadSize; ++i) {
+            const auto byte = static_cast<std::uint8_t>(rng());
+            if (zeroCount >= 2 && byte <= 0x03) {
+                frame.push_back(0x03);
+                zeroCount = 0;
+            }
+            frame.push_back(byte);
+            zeroCount = byte == 0 ? zeroCount + 1 : 0;
+        }
+        frame.push_back(0x80); // rbsp_stop_one_bit
+    };
+    appendNAL(HEVCNalType::VPS, 20);
+    appendNAL(HEVCNalType::SPS, 40);
+    appendNAL(HEVCNalType::PPS, 8);
+    appendNAL(HEVCNalType::PrefixSEI, 16);
+    while (frame.size() < frameSize)
+        appendNAL(19 /*IDR_W_RADL*/, std::min<std::size_t>(frameSize - frame.size(), 256 * 1024));
+
+    using namespace std::chrono;
+    const auto measure = [&](const char* name, auto&& fn) {
+        std::size_t result = 0;
+        const auto start = steady_clock::now();
+        for (std::size_t i = 0; i < iterations; ++i)
+            result += fn();
+        const double seconds = duration<double>(steady_clock::now() - start).count();
+        Log::Write(Log::Level::Info, Fmt("NAL parser benchmark %-14s: %8.2f MB/s, %6.3fms per %zuKB frame (%zu)",
+            name, seconds > 0 ? (frame.size() * iterations) / (seconds * 1024.0 * 1024.0) : 0.0,
+            seconds * 1e3 / iterations, frame.size() / 1024, result));
+    };
+    const auto scanAll = [&frame](auto&& findStartCode) {
+        std::size_t count = 0;
+        for (std::size_t offset = 0; offset < frame.size(); offset += 3, ++count) {
+            offset += findStartCode(frame.data() + offset, frame.size() - offset);
+        }
+        return count;
+    };
+    measure("scan (scalar)", [&]() { return scanAll([](const std::uint8_t* data, const std::size_t size) { return FindStartCodeScalar(data, 0, size); }); });
+    measure("scan", [&]() { return scanAll(FindStartCode); });
+    ParameterSetCache paramSets{ ALVR_CODEC_H265 };
+    measure("ParseNALFrame", [&]() { return ParseNALFrame(frame, ALVR_CODEC_H265, &paramSets).nalCount; });
+}
+
+}
@@ -0,0 +1,122 @@
+#include "pch.h"
+#include "common.h"
+#include "check.h"
+#include "tests.h"
+#include "nal_parser.h"
+
+#include <random>
+#include <vector>
+
+namespace ALXR {
+namespace {
+
+inline std::size_t FindStartCodeReference(const std::uint8_t* data, const std::size_t size) {
+    for (std::size_t i = 0; i + 2 < size; ++i) {
+        if (data[i] == 0 && data[i + 1] == 0 && data[i + 2] == 1)
+            return i;
+    }
+    return size;
+}
+
+inline void CheckFindStartCode(const std::uint8_t* data, const std::size_t size, const char* const what) {
+    const std::size_t expected = FindStartCodeReference(data, size);
+    const std::size_t found = FindStartCode(data, size);
+    const std::size_t foundScalar = FindStartCodeScalar(data, 0, size);
+    CHECK_MSG(found == expected && foundScalar == expected,
+        Fmt("%s: start code at %zu, FindStartCode %zu, scalar %zu (size %zu)", what, expected, found, foundScalar, size));
+}
+
+// 3 & 4 byte start codes at every offset of buffers around the 16 byte SIMD stride, including codes
+// ending on the last byte & truncated by the end of the buffer.
+void TestStartCodeEdges()
+{
+    CheckFindStartCode(nullptr, 0, "null");
+    std::vector<std::uint8_t> buffer;
+    for (std::size_t size = 0; size <= 70; ++size) {
+        // unaligned as well, the SIMD scan uses unaligned loads.
+        for (std::size_t misalign = 0; misalign < 2; ++misalign) {
+            buffer.assign(size + misalign, 0xFF);
+            std::uint8_t* const data = buffer.data() + misalign;
+            CheckFindStartCode(data, size, "no start code");
+            for (std::size_t pos = 0; pos < size; ++pos) {
+                for (std::size_t zeroCount = 2; zeroCount <= 3; ++zeroCount) {
+                    std::fill(data, data + size, std::uint8_t(0xFF));
+                    // as much of the code as fits, a code cut short by the end must not be reported.
+                    for (std::size_t i = 0; i < zeroCount + 1 && pos + i < size; ++i)
+                        data[pos + i] = i < zeroCount ? 0 : 1;
+                    CheckFindStartCode(data, size, zeroCount == 2 ? "3 byte code" : "4 byte code");
+                }
+                // leading zeros that are not a start code, 00 00 02.
+                std::fill(data, data + size, std::uint8_t(0xFF));
+                for (std::size_t i = 0; i < 3 && pos + i < size; ++i)
+                    data[pos + i] = i < 2 ? 0 : 2;
+                CheckFindStartCode(data, size, "00 00 02");
+            }
+        }
+    }
+}
+
+// noise dense in 00 & 01 bytes (many partial codes), SIMD scan vs the byte-wise reference.
+void TestStartCodeRandom()
+{
+    std::mt19937 rng{ 0x414C5852 };
+    std::vector<std::uint8_t> buffer;
+    for (std::size_t iteration = 0; iteration < 2000; ++iteration) {
+        const std::size_t size = rng() % 600;
+        buffer.resize(size);
+        for (auto& byte : buffer) {
+            const auto r = rng() % 8;
+            byte = r < 5 ? 0 : r == 5 ? 1 : static_cast<std::uint8_t>(rng());
+        }
+        // all start codes in turn, as NextNALUnit walks them.
+        std::size_t offset = 0;
+        while (offset < size) {
+            const std::size_t expected = offset + FindStartCodeReference(buffer.data() + offset, size - offset);
+            const std::size_t found = offset + FindStartCode(buffer.data() + offset, size - offset);
+            const std::size_t foundScalar = FindStartCodeScalar(buffer.data(), offset, size);
+            CHECK_MSG(found == expected && foundScalar == expected,
+                Fmt("random: start code at %zu, FindStartCode %zu, scalar %zu (from %zu, size %zu)",
+                    expected, found, foundScalar, offset, size));
+            offset = expected + 1;
+        }
+    }
+}
+
+// unit offsets include a 4 byte start code's zero_byte, unit data excludes trailing zeros.
+void TestNextNALUnit()
+{
+    const std::vector<std::uint8_t> frame = {
+        0x00, 0x00, 0x00, 0x01, 0x40, 0x01, 0xAA, 0xBB, // VPS, 4 byte start code.
+        0x00, 0x00, 0x01, 0x42, 0x01, 0xCC,             // SPS, 3 byte start code.
+        0x00, 0x00, 0x00, 0x01, 0x02, 0x01, 0xDD, 0x00, // TRAIL_R slice, trailing_zero_8bits.
+    };
+    const NALSpan span{ frame };
+    std::size_t offset = 0;
+    NALUnit unit{};
+
+    CHECK(NextNALUnit(span, offset, ALVR_CODEC_H265, unit));
+    CHECK(unit.offset == 0 && unit.type == HEVCNalType::VPS && unit.data.size() == 4 && unit.data[3] == 0xBB);
+    CHECK(NextNALUnit(span, offset, ALVR_CODEC_H265, unit));
+    CHECK(unit.offset == 8 && unit.type == HEVCNalType::SPS && unit.data.size() == 3 && unit.data[2] == 0xCC);
+    CHECK(NextNALUnit(span, offset, ALVR_CODEC_H265, unit));
+    CHECK(unit.offset == 14 && unit.type == 1 && unit.data.size() == 3 && unit.data[2] == 0xDD);
+    CHECK(!NextNALUnit(span, offset, ALVR_CODEC_H265, unit));
+
+    // a start code without room for a NAL header after it ends the frame.
+    const std::vector<std::uint8_t> truncated = { 0x00, 0x00, 0x01, 0x65, 0x88, 0x00, 0x00, 0x01 };
+    offset = 0;
+    CHECK(NextNALUnit(NALSpan{ truncated }, offset, ALVR_CODEC_H264, unit));
+    CHECK(unit.type == H264NalType::IDR && unit.data.size() == 2);
+    CHECK(!NextNALUnit(NALSpan{ truncated }, offset, ALVR_CODEC_H264, unit));
+}
+
+}
+
+void TestNALParser()
+{
+    TestStartCodeEdges();
+    TestStartCodeRandom();
+    TestNextNALUnit();
+}
+
+}
@@ -0,0 +1,148 @@
+#include "pch.h"
+#include "common.h"
+#include "check.h"
+#include "tests.h"
+#include "packet_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace ALXR {
+namespace {
+
+using namespace std::chrono_literals;
+
+struct TestPacket {
+    std::uint64_t index = 0;
+};
+using TestQueue = PacketQueue<TestPacket>;
+
+// the budget is not enforced before the decoder has output a frame, depth & age count queued packets only.
+void TestBudget()
+{
+    TestQueue queue{ 16 };
+    const PacketQueueBudget budget{ 4, 20000 };
+    for (std::uint64_t index = 0; index < 6; ++index)
+        CHECK(queue.TryEnqueue({ index }));
+    auto state = queue.GetState();
+    CHECK(state.depth == 6 && !state.hasDecodedFrame && state.lostCount == 0);
+    CHECK(!budget.IsExceeded(state));
+
+    queue.OnFrameDecoded();
+    CHECK(budget.IsExceeded(queue.GetState()));
+
+    TestPacket packet{};
+    for (std::uint64_t index = 0; index < 3; ++index)
+        CHECK(queue.WaitDequeue(packet, 1ms) && packet.index == index);
+    state = queue.GetState();
+    CHECK(state.depth == 3 && !budget.IsExceeded(state));
+    // the oldest of the remaining packets, not the first ever queued, ages past the budget.
+    CHECK(!budget.IsExceeded(queue.GetState(GetSteadyTimestampUs())));
+    CHECK(budget.IsExceeded(queue.GetState(GetSteadyTimestampUs() + budget.maxLatencyUs + 1)));
+
+    queue.OnPacketLost();
+    CHECK(queue.GetState().lostCount == 1 && queue.GetStats().lost == 1);
+}
+
+// flushed packets are skipped by the consumer, packets queued after the flush are not.
+void TestFlush()
+{
+    TestQueue queue{ 8 };
+    for (std::uint64_t index = 0; index < 5; ++index)
+        CHECK(queue.TryEnqueue({ index }));
+    queue.Flush();
+    CHECK(queue.GetState().depth == 0);
+
+    TestPacket packet{};
+    CHECK(!queue.WaitDequeue(packet, 1ms));
+    CHECK(queue.GetStats().flushed == 5);
+
+    CHECK(queue.TryEnqueue({ 5 }) && queue.TryEnqueue({ 6 }));
+    queue.Flush();
+    CHECK(queue.TryEnqueue({ 7 }));
+    CHECK(queue.GetState().depth == 1);
+    CHECK(queue.WaitDequeue(packet, 1ms) && packet.index == 7);
+    CHECK(queue.GetState().depth == 0);
+
+    const auto& stats = queue.GetStats();
+    CHECK(stats.enqueued == 8 && stats.flushes == 2 && stats.flushed == 7 && stats.dequeued == 1);
+    CHECK(stats.highWatermark == 5);
+}
+
+// a full queue rejects packets, a pair is queued whole or not at all.
+void TestFull()
+{
+    TestQueue queue{ 4 };
+    for (std::uint64_t index = 0; index < 3; ++index)
+        CHECK(queue.TryEnqueue({ index }));
+    CHECK(!queue.TryEnqueue({ 3 }, { 4 }));
+    CHECK(queue.GetState().depth == 3);
+    CHECK(queue.TryEnqueue({ 3 }));
+    CHECK(!queue.TryEnqueue({ 4 }));
+    CHECK(queue.GetStats().rejected == 3);
+
+    TestPacket packet{};
+    CHECK(queue.WaitDequeue(packet, 1ms) && queue.WaitDequeue(packet, 1ms));
+    CHECK(queue.TryEnqueue({ 4 }, { 5 }));
+    for (std::uint64_t index = 2; index < 6; ++index)
+        CHECK(queue.WaitDequeue(packet, 1ms) && packet.index == index);
+}
+
+// a producer flushing every so often & a consumer: packets come out in order, each either dequeued or
+// flushed, & nothing queued before a flush is dequeued after it.
+void TestConcurrent()
+{
+    TestQueue queue{ 64 };
+    constexpr const std::uint64_t PacketCount = 200000;
+    std::atomic<std::uint64_t> flushedBelow{ 0 };
+    std::atomic<bool> isProducing{ true };
+    std::size_t outOfOrder = 0, afterFlush = 0, dequeued = 0;
+    std::thread consumer([&]() {
+        TestPacket packet{};
+        std::uint64_t lastIndex = 0;
+        while (true) {
+            // every packet below a flush point seen before dequeuing was flushed.
+            const std::uint64_t flushPoint = flushedBelow.load();
+            if (queue.WaitDequeue(packet, 1ms)) {
+                outOfOrder += dequeued > 0 && packet.index <= lastIndex;
+                afterFlush += packet.index < flushPoint;
+                lastIndex = packet.index;
+                ++dequeued;
+            } else if (!isProducing.load() && queue.GetState().depth == 0)
+                break;
+        }
+    });
+    std::uint64_t rejected = 0;
+    for (std::uint64_t index = 0; index < PacketCount; ++index) {
+        if (index % 1000 == 999) {
+            queue.Flush();
+            flushedBelow.store(index);
+        }
+        if (!queue.TryEnqueue({ index })) {
+            ++rejected;
+            std::this_thread::yield();
+        }
+    }
+    isProducing.store(false);
+    consumer.join();
+
+    const auto& stats = queue.GetStats();
+    CHECK_MSG(outOfOrder == 0 && afterFlush == 0, Fmt("%zu out of order, %zu flushed packets dequeued", outOfOrder, afterFlush));
+    CHECK(stats.rejected == rejected && stats.enqueued == PacketCount - rejected);
+    CHECK_MSG(stats.dequeued == dequeued && stats.enqueued == stats.dequeued + stats.flushed,
+        Fmt("enqueued=%llu, dequeued=%llu, flushed=%llu", static_cast<unsigned long long>(stats.enqueued.load()),
+            static_cast<unsigned long long>(stats.dequeued.load()), static_cast<unsigned long long>(stats.flushed.load())));
+}
+
+}
+
+void TestPacketQueue()
+{
+    TestBudget();
+    TestFlush();
+    TestFull();
+    TestConcurrent();
+}
+
+}
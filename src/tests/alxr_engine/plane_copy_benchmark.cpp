@@ -0,0 +1,78 @@
+#include "pch.h"
+#include "common.h"
+#include "benchmarks.h"
+#include "plane_copy.h"
+
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace ALXR {
+
+bool BenchmarkPlaneCopy(const std::size_t iterations)
+{
+    if (iterations == 0)
+        return true;
+    bool isMatching = true;
+    struct FrameSize {
+        std::size_t width;
+        std::size_t height;
+    };
+    // NV12 frames below & above PlaneCopier::MinParallelBytes.
+    for (const auto frameSize : { FrameSize{ 2048, 1024 }, FrameSize{ 3840, 2160 } }) {
+        // libavcodec style pitched source, the destination pitched as a texture upload row.
+        const std::size_t srcPitch = ((frameSize.width + 63) & ~std::size_t(63)) + 64;
+        const std::size_t dstPitch = (frameSize.width + 255) & ~std::size_t(255);
+        const std::size_t lumaRows = frameSize.height;
+        const std::size_t chromaRows = frameSize.height / 2;
+        std::vector<std::uint8_t> src(srcPitch * (lumaRows + chromaRows));
+        std::vector<std::uint8_t> dst(dstPitch * (lumaRows + chromaRows));
+        std::mt19937 rng{ 0x414C5852 };
+        for (auto& byte : src)
+            byte = static_cast<std::uint8_t>(rng());
+
+        const std::array<Plane2D, 2> planes{
+            Plane2D{ dst.data(), dstPitch, src.data(), srcPitch, frameSize.width, lumaRows },
+            Plane2D{ dst.data() + dstPitch * lumaRows, dstPitch, src.data() + srcPitch * lumaRows, srcPitch, frameSize.width, chromaRows }
+        };
+        const std::size_t frameBytes = frameSize.width * (lumaRows + chromaRows);
+
+        using namespace std::chrono;
+        const auto measure = [&](const char* name, auto&& copyFrame) {
+            std::fill(dst.begin(), dst.end(), std::uint8_t(0));
+            const auto start = steady_clock::now();
+            for (std::size_t i = 0; i < iterations; ++i)
+                copyFrame();
+            const double seconds = duration<double>(steady_clock::now() - start).count();
+            std::size_t mismatchedRows = 0;
+            for (const auto& plane : planes) {
+                for (std::size_t row = 0; row < plane.rows; ++row)
+                    mismatchedRows += std::memcmp(plane.dst + row * plane.dstPitch, plane.src + row * plane.srcPitch, plane.rowBytes) != 0;
+            }
+            isMatching = isMatching && mismatchedRows == 0;
+            Log::Write(mismatchedRows == 0 ? Log::Level::Info : Log::Level::Error, Fmt("Plane copy benchmark %4zux%-4zu %-22s: %7.2f GB/s, %6.3fms per frame%s",
+                frameSize.width, frameSize.height, name,
+                seconds > 0 ? (frameBytes * iterations) / (seconds * 1024.0 * 1024.0 * 1024.0) : 0.0,
+                seconds * 1e3 / iterations, mismatchedRows == 0 ? "" : Fmt(" (%zu rows MISMATCHED)", mismatchedRows).c_str()));
+        };
+        // what the Vulkan & D3D11 uploads did before plane_copy.
+        measure("memcpy rows", [&]() {
+            for (const auto& plane : planes) {
+                for (std::size_t row = 0; row < plane.rows; ++row)
+                    std::memcpy(plane.dst + row * plane.dstPitch, plane.src + row * plane.srcPitch, plane.rowBytes);
+            }
+        });
+        measure(Fmt("CopyPlane2D (%s)", ToString(GetPlaneCopyISA())).c_str(), [&]() {
+            for (const auto& plane : planes)
+                CopyPlane2D(plane);
+        });
+        PlaneCopier copier;
+        measure(Fmt("PlaneCopier (%zu workers)", copier.WorkerCount()).c_str(), [&]() {
+            copier.Copy(planes.data(), planes.size());
+        });
+    }
+    return isMatching;
+}
+
+}
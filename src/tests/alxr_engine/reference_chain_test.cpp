@@ -0,0 +1,114 @@
+#include "pch.h"
+#include "common.h"
+#include "check.h"
+#include "tests.h"
+#include "reference_chain.h"
+
+namespace ALXR {
+namespace {
+
+using Verdict = ReferenceChainTracker::Verdict;
+constexpr const std::uint64_t IntervalUs = ReferenceChainTracker::IDRRequestIntervalUs;
+
+constexpr inline NALFrameInfo MakeFrame(const bool isKeyFrame, const bool hasSlices = true) {
+    return {
+        .nalCount = 1,
+        .configSize = 0,
+        .hasParameterSets = !hasSlices,
+        .isKeyFrame = isKeyFrame,
+        .hasSEI = false,
+        .hasSlices = hasSlices,
+        .sliceType = hasSlices ? (isKeyFrame ? SliceType::I : SliceType::P) : SliceType::Unknown
+    };
+}
+constexpr const NALFrameInfo KeyFrame = MakeFrame(true);
+constexpr const NALFrameInfo InterFrame = MakeFrame(false);
+constexpr const NALFrameInfo ParameterSets = MakeFrame(false, false);
+
+// waiting on the first key frame after a (re)start, the IDR requested with Reset is retried once unanswered.
+void TestStart()
+{
+    ReferenceChainTracker tracker{};
+    std::uint64_t nowUs = 1000000;
+    tracker.Reset(nowUs);
+    CHECK(!tracker.IsChainValid());
+    CHECK(tracker.OnFrame(1, InterFrame) == Verdict::DropUndecodable);
+    CHECK(!tracker.ShouldRequestIDR(nowUs + IntervalUs - 1));
+    nowUs += IntervalUs;
+    CHECK(tracker.ShouldRequestIDR(nowUs));
+    CHECK(!tracker.ShouldRequestIDR(nowUs + 1));
+
+    // parameter sets alone are left to the decoder, they do not restore the chain.
+    CHECK(tracker.OnFrame(2, ParameterSets) == Verdict::Decode);
+    CHECK(!tracker.IsChainValid());
+    CHECK(tracker.OnFrame(3, InterFrame) == Verdict::DropUndecodable);
+
+    CHECK(tracker.OnFrame(4, KeyFrame) == Verdict::Decode);
+    CHECK(tracker.IsChainValid());
+    CHECK(!tracker.ShouldRequestIDR(nowUs + IntervalUs * 10));
+    // tracking frame index gaps are not losses.
+    CHECK(tracker.OnFrame(9, InterFrame) == Verdict::Decode);
+    CHECK(tracker.OnFrame(17, InterFrame) == Verdict::Decode);
+}
+
+// a loss drops every inter frame up to the next key frame, a burst of losses requests a single IDR.
+void TestLossRecovery()
+{
+    ReferenceChainTracker tracker{};
+    std::uint64_t nowUs = 5000000;
+    tracker.Reset(nowUs);
+    CHECK(tracker.OnFrame(10, KeyFrame) == Verdict::Decode);
+    CHECK(tracker.OnFrame(11, InterFrame) == Verdict::Decode);
+
+    nowUs += 1000;
+    tracker.OnFrameLost();
+    CHECK(!tracker.IsChainValid());
+    // the last IDR request was answered, the first loss requests one immediately.
+    CHECK(tracker.ShouldRequestIDR(nowUs));
+    for (std::uint64_t frameIndex = 13; frameIndex < 20; ++frameIndex) {
+        nowUs += 11000;
+        tracker.OnFrameLost();
+        CHECK(!tracker.ShouldRequestIDR(nowUs));
+        CHECK(tracker.OnFrame(frameIndex, InterFrame) == Verdict::DropUndecodable);
+    }
+    // dropped frames do not count as fed, a key frame with the index of a dropped one still decodes.
+    CHECK(tracker.OnFrame(19, KeyFrame) == Verdict::Decode);
+    CHECK(tracker.IsChainValid());
+    CHECK(tracker.OnFrame(20, InterFrame) == Verdict::Decode);
+
+    // lost again right after recovering, the previous request was answered so this one is not throttled.
+    tracker.OnFrameLost();
+    CHECK(tracker.ShouldRequestIDR(nowUs + 1));
+    CHECK(tracker.OnFrame(21, InterFrame) == Verdict::DropUndecodable);
+    CHECK(!tracker.ShouldRequestIDR(nowUs + IntervalUs));
+    CHECK(tracker.ShouldRequestIDR(nowUs + 1 + IntervalUs));
+    CHECK(tracker.OnFrame(22, KeyFrame) == Verdict::Decode);
+}
+
+// frames older than the last one fed are stale whatever their type, the chain is left as is.
+void TestStaleFrames()
+{
+    ReferenceChainTracker tracker{};
+    tracker.Reset(0);
+    CHECK(tracker.OnFrame(100, KeyFrame) == Verdict::Decode);
+    CHECK(tracker.OnFrame(99, KeyFrame) == Verdict::DropStale);
+    CHECK(tracker.OnFrame(98, InterFrame) == Verdict::DropStale);
+    CHECK(tracker.IsChainValid());
+    // the same index again, e.g. a frame split over several packets, is not stale.
+    CHECK(tracker.OnFrame(100, InterFrame) == Verdict::Decode);
+
+    // a restart forgets the last index.
+    tracker.Reset(IntervalUs);
+    CHECK(tracker.OnFrame(1, KeyFrame) == Verdict::Decode);
+}
+
+}
+
+void TestReferenceChain()
+{
+    TestStart();
+    TestLossRecovery();
+    TestStaleFrames();
+}
+
+}
@@ -0,0 +1,54 @@
+#include "pch.h"
+#include "common.h"
+#include "tests.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+struct Test {
+    const char* name;
+    void (*run)();
+};
+constexpr const Test Tests[] = {
+    { "hand_skeleton", ALXR::TestHandSkeleton },
+    { "action_table",  ALXR::TestActionTable },
+    { "tracking_frame_ring", ALXR::TestTrackingFrameRing },
+    { "nal_parser",    ALXR::TestNALParser },
+    { "reference_chain", ALXR::TestReferenceChain },
+    { "packet_queue",  ALXR::TestPacketQueue },
+    { "video_frame_mailbox", ALXR::TestVideoFrameMailbox },
+};
+
+}
+
+// alxr_engine_tests [name...], runs every test when no names are given.
+int main(int argc, char* argv[])
+{
+    const std::vector<const char*> names(argv + 1, argv + argc);
+    int result = EXIT_SUCCESS;
+    for (const char* const name : names) {
+        const bool isKnown = std::any_of(std::begin(Tests), std::end(Tests),
+            [name](const Test& test) { return std::strcmp(test.name, name) == 0; });
+        if (!isKnown) {
+            Log::Write(Log::Level::Error, Fmt("Unknown test \"%s\"", name));
+            result = EXIT_FAILURE;
+        }
+    }
+    for (const auto& test : Tests) {
+        const bool isSelected = names.empty() || std::any_of(names.begin(), names.end(),
+            [&test](const char* const name) { return std::strcmp(test.name, name) == 0; });
+        if (!isSelected)
+            continue;
+        try {
+            test.run();
+            Log::Write(Log::Level::Info, Fmt("Test %s passed", test.name));
+        } catch (const std::exception& ex) {
+            Log::Write(Log::Level::Error, Fmt("Test %s failed: %s", test.name, ex.what()));
+            result = EXIT_FAILURE;
+        }
+    }
+    Log::Flush();
+    return result;
+}
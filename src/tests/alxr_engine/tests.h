@@ -0,0 +1,37 @@
+#pragma once
+#ifndef ALXR_TESTS_H
+#define ALXR_TESTS_H
+
+namespace ALXR {
+
+// Each test throws (CHECK/CHECK_MSG) on the first failed expectation.
+
+// ToHandSkeleton over LoadHandJoints matches the 4x4 matrix xr_linear path for random hands, both sides.
+void TestHandSkeleton();
+
+// ActionTable::Poll fills the same ControllerInfo as the per-input map lookups it replaced, for every profile
+// against a mock runtime, with actions missing, unbound (dormant) & bound again.
+void TestActionTable();
+
+// TrackingFrameRing's nearest timestamp lookups match a brute force search across wrap-arounds, & records
+// read while being written are never torn.
+void TestTrackingFrameRing();
+
+// FindStartCode (SIMD) & FindStartCodeScalar match a byte-wise search for 3 & 4 byte start codes at every
+// offset & buffer edge, NextNALUnit's unit offsets & sizes around them.
+void TestNALParser();
+
+// ReferenceChainTracker drops inter frames from a loss until the next key frame (not on parameter sets
+// alone), folds a burst of losses into one IDR request, retries it once unanswered & drops stale frames.
+void TestReferenceChain();
+
+// PacketQueue's budget is only enforced once a frame was decoded, flushed packets are skipped by the consumer
+// (also while a producer enqueues concurrently), packet pairs are queued whole & the stats add up.
+void TestPacketQueue();
+
+// VideoFrameMailbox slot transitions & frame counters, & with a concurrent decoder & render thread that a
+// displayed frame is never written to, the writer always finds a free slot & frames are displayed in order.
+void TestVideoFrameMailbox();
+
+}
+#endif
@@ -0,0 +1,111 @@
+#include "pch.h"
+#include "common.h"
+#include "check.h"
+#include "tests.h"
+#include "tracking_frame_ring.h"
+
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace ALXR {
+namespace {
+
+// every field is the timestamp it was pushed with, a torn read shows up as a mismatch.
+struct TestRecord {
+    std::uint64_t timestamp;
+    std::uint32_t words[13];
+    std::uint16_t tail;
+};
+
+inline TestRecord MakeRecord(const std::uint64_t timestamp) {
+    TestRecord record{ .timestamp = timestamp, .words = {}, .tail = static_cast<std::uint16_t>(timestamp) };
+    for (auto& word : record.words)
+        word = static_cast<std::uint32_t>(timestamp);
+    return record;
+}
+
+inline bool IsConsistent(const TestRecord& record) {
+    for (const auto word : record.words) {
+        if (word != static_cast<std::uint32_t>(record.timestamp))
+            return false;
+    }
+    return record.tail == static_cast<std::uint16_t>(record.timestamp);
+}
+
+inline std::uint64_t Distance(const std::uint64_t a, const std::uint64_t b) {
+    return a > b ? a - b : b - a;
+}
+
+constexpr const std::size_t Capacity = 64;
+using TestRing = TrackingFrameRing<TestRecord, Capacity>;
+
+void TestNearest()
+{
+    auto ring = std::make_unique<TestRing>();
+    TestRecord record{};
+    CHECK(!ring->FindNearest(0, record) && !ring->Latest(record));
+
+    // increasing timestamps with jittered gaps, pushed past a few wrap-arounds.
+    std::mt19937 rng{ 0x414C5852 };
+    std::vector<std::uint64_t> pushed;
+    std::uint64_t timestamp = 1000;
+    for (std::size_t i = 0; i < Capacity * 3 + 7; ++i) {
+        timestamp += 1000 + rng() % 9000;
+        ring->Push(timestamp, MakeRecord(timestamp));
+        pushed.push_back(timestamp);
+
+        const std::size_t heldCount = std::min(pushed.size(), Capacity);
+        const std::uint64_t oldestHeld = pushed[pushed.size() - heldCount];
+        for (std::uint64_t query = oldestHeld - 20000; query < timestamp + 20000; query += 997) {
+            std::uint64_t bestDist = std::uint64_t(-1);
+            for (std::size_t j = pushed.size() - heldCount; j < pushed.size(); ++j)
+                bestDist = std::min(bestDist, Distance(pushed[j], query));
+            CHECK_MSG(ring->FindNearest(query, record), Fmt("nothing found for %llu", static_cast<unsigned long long>(query)));
+            CHECK_MSG(Distance(record.timestamp, query) == bestDist && IsConsistent(record),
+                Fmt("nearest to %llu is %llu after %zu pushes", static_cast<unsigned long long>(query),
+                    static_cast<unsigned long long>(record.timestamp), pushed.size()));
+        }
+        CHECK(ring->Find(timestamp, record) && record.timestamp == timestamp);
+        CHECK(ring->Latest(record) && record.timestamp == timestamp);
+        if (pushed.size() > Capacity)
+            CHECK(!ring->Find(pushed[pushed.size() - Capacity - 1], record));
+    }
+}
+
+void TestConcurrentReads()
+{
+    auto ring = std::make_unique<TestRing>();
+    constexpr const std::uint64_t PushCount = 200000;
+    std::atomic<bool> isWriting{ true };
+    std::thread writer([&]() {
+        for (std::uint64_t timestamp = 1; timestamp <= PushCount; ++timestamp)
+            ring->Push(timestamp * 10, MakeRecord(timestamp * 10));
+        isWriting.store(false);
+    });
+    std::size_t tornCount = 0, readCount = 0;
+    std::mt19937 rng{ 0x414C5852 };
+    TestRecord record{};
+    while (isWriting.load()) {
+        const std::uint64_t query = (rng() % PushCount) * 10 + rng() % 10;
+        if (ring->FindNearest(query, record)) {
+            ++readCount;
+            tornCount += !IsConsistent(record);
+        }
+        if (ring->Latest(record))
+            tornCount += !IsConsistent(record);
+    }
+    writer.join();
+    CHECK_MSG(tornCount == 0, Fmt("%zu torn records out of %zu reads", tornCount, readCount));
+}
+
+}
+
+void TestTrackingFrameRing()
+{
+    TestNearest();
+    TestConcurrentReads();
+}
+
+}
@@ -0,0 +1,148 @@
+#include "pch.h"
+#include "common.h"
+#include "check.h"
+#include "tests.h"
+#include "video_frame_mailbox.h"
+
+#include <array>
+#include <atomic>
+#include <thread>
+
+namespace ALXR {
+namespace {
+
+constexpr const std::size_t SlotCount = 3;
+using TestMailbox = VideoFrameMailbox<SlotCount>;
+constexpr const std::size_t NoSlot = TestMailbox::NoSlot;
+
+using Counters = LatencyManager::VideoFrameCounters;
+inline Counters CountersSince(const Counters& start) {
+    const auto now = LatencyManager::Instance().GetVideoFrameCounters();
+    return {
+        .decoded    = now.decoded - start.decoded,
+        .displayed  = now.displayed - start.displayed,
+        .dropped    = now.dropped - start.dropped,
+        .reRendered = now.reRendered - start.reRendered,
+    };
+}
+
+// Free -> Writing -> Ready -> Displaying -> Free from a single thread, with the frame counters of each step.
+void TestTransitions()
+{
+    const auto start = LatencyManager::Instance().GetVideoFrameCounters();
+    TestMailbox mailbox{};
+    CHECK(mailbox.DisplaySlot() == NoSlot);
+    // nothing displayed yet is not a re-render.
+    CHECK(!mailbox.AcquireLatest() && CountersSince(start).reRendered == 0);
+
+    // every slot can be written, none twice.
+    std::array<std::size_t, SlotCount> slots{};
+    for (auto& slot : slots) {
+        slot = mailbox.AcquireWrite();
+        CHECK(slot != NoSlot);
+    }
+    CHECK(slots[0] != slots[1] && slots[1] != slots[2] && slots[0] != slots[2]);
+    CHECK(mailbox.AcquireWrite() == NoSlot);
+    mailbox.CancelWrite(slots[1]);
+    mailbox.CancelWrite(slots[2]);
+
+    mailbox.Publish(slots[0]);
+    CHECK(mailbox.AcquireLatest() && mailbox.DisplaySlot() == slots[0]);
+    CHECK(!mailbox.AcquireLatest() && mailbox.DisplaySlot() == slots[0]);
+    auto counters = CountersSince(start);
+    CHECK(counters.decoded == 1 && counters.displayed == 1 && counters.dropped == 0 && counters.reRendered == 1);
+
+    // the displayed slot is never handed to the writer, a ready frame replaced before being taken is freed.
+    const std::size_t first = mailbox.AcquireWrite();
+    CHECK(first != NoSlot && first != slots[0]);
+    mailbox.Publish(first);
+    const std::size_t second = mailbox.AcquireWrite();
+    CHECK(second != NoSlot && second != slots[0] && second != first);
+    mailbox.Publish(second);
+    CHECK(mailbox.AcquireWrite() == first);
+    mailbox.CancelWrite(first);
+    counters = CountersSince(start);
+    CHECK(counters.decoded == 3 && counters.dropped == 1);
+
+    // taking the newest frame frees the previously displayed slot.
+    CHECK(mailbox.AcquireLatest() && mailbox.DisplaySlot() == second);
+    const std::size_t next = mailbox.AcquireWrite();
+    CHECK(next != NoSlot && next != second);
+    mailbox.CancelWrite(next);
+
+    mailbox.Reset();
+    CHECK(mailbox.DisplaySlot() == NoSlot && !mailbox.AcquireLatest());
+    counters = CountersSince(start);
+    CHECK(counters.decoded == 3 && counters.displayed == 2 && counters.dropped == 1 && counters.reRendered == 1);
+}
+
+// a decoder & a render thread: the writer always finds a slot, a displayed frame is never written to
+// while the render thread samples it & frames are displayed in order.
+void TestConcurrent()
+{
+    const auto start = LatencyManager::Instance().GetVideoFrameCounters();
+    TestMailbox mailbox{};
+    // each slot's frame number is written twice, a frame overwritten while displayed reads back mismatched.
+    struct Payload {
+        std::atomic<std::uint64_t> begin{ 0 };
+        std::atomic<std::uint64_t> end{ 0 };
+    };
+    std::array<Payload, SlotCount> payloads{};
+    constexpr const std::uint64_t FrameCount = 100000;
+    std::atomic<bool> isDecoding{ true };
+    std::size_t noSlotCount = 0;
+    std::thread decoder([&]() {
+        for (std::uint64_t frame = 1; frame <= FrameCount; ++frame) {
+            const std::size_t slot = mailbox.AcquireWrite();
+            if (slot == NoSlot) {
+                ++noSlotCount;
+                continue;
+            }
+            payloads[slot].begin.store(frame, std::memory_order_relaxed);
+            payloads[slot].end.store(frame, std::memory_order_relaxed);
+            mailbox.Publish(slot);
+        }
+        isDecoding.store(false);
+    });
+
+    std::size_t tornCount = 0, outOfOrder = 0, rendered = 0;
+    std::uint64_t lastFrame = 0;
+    const auto render = [&]() {
+        const bool isNew = mailbox.AcquireLatest();
+        const std::size_t slot = mailbox.DisplaySlot();
+        if (slot == NoSlot)
+            return;
+        const std::uint64_t frame = payloads[slot].end.load(std::memory_order_relaxed);
+        // sampled for a while, the decoder keeps publishing meanwhile.
+        for (int spin = 0; spin < 64; ++spin)
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+        tornCount += payloads[slot].begin.load(std::memory_order_relaxed) != frame ||
+                     payloads[slot].end.load(std::memory_order_relaxed) != frame;
+        outOfOrder += isNew ? frame <= lastFrame : frame != lastFrame;
+        lastFrame = frame;
+        ++rendered;
+    };
+    while (isDecoding.load())
+        render();
+    decoder.join();
+    render();
+
+    CHECK_MSG(noSlotCount == 0 && tornCount == 0 && outOfOrder == 0,
+        Fmt("%zu writes without a free slot, %zu frames overwritten while displayed, %zu out of order in %zu renders",
+            noSlotCount, tornCount, outOfOrder, rendered));
+    CHECK(lastFrame == FrameCount);
+    const auto counters = CountersSince(start);
+    CHECK_MSG(counters.decoded == FrameCount && counters.decoded == counters.displayed + counters.dropped,
+        Fmt("decoded=%llu, displayed=%llu, dropped=%llu", static_cast<unsigned long long>(counters.decoded),
+            static_cast<unsigned long long>(counters.displayed), static_cast<unsigned long long>(counters.dropped)));
+}
+
+}
+
+void TestVideoFrameMailbox()
+{
+    TestTransitions();
+    TestConcurrent();
+}
+
+}